@@ -196,6 +196,17 @@ int benchmark_instances::run_all_benchmarks() {
     property_tree.add_child(prefix_str(fixture, name), results);
   }
 
+  if (!m_reports.empty()) {
+    boost::property_tree::ptree reports;
+    for (auto &r : m_reports) {
+      boost::property_tree::ptree report;
+      report.put("name", r.first);
+      report.put("report", r.second);
+      reports.push_back(std::make_pair("", report));
+    }
+    property_tree.add_child("reports", reports);
+  }
+
   boost::property_tree::write_json(m_output_fp, property_tree);
   return 0;
 }
@@ -205,4 +216,16 @@ benchmark_instances::register_benchmark(const benchmark_instance_base_ptr &b) {
   m_all_instances.push_back(b);
   return m_all_instances.size();
 }
+
+void benchmark_instances::add_report(const std::string &name,
+                                     const std::string &report) {
+  // keep the last one if a benchmark reports in each eval
+  for (auto &r : m_reports) {
+    if (r.first == name) {
+      r.second = report;
+      return;
+    }
+  }
+  m_reports.push_back(std::make_pair(name, report));
+}
 } // end namespace neb
@@ -43,6 +43,10 @@ public:
 
   size_t register_benchmark(const benchmark_instance_base_ptr &b);
 
+  //! extra counters of a benchmark, e.g., RocksDB statistics, written to
+  //! "reports" of the output, a later report replaces one with the same name
+  void add_report(const std::string &name, const std::string &report);
+
 protected:
   void show_all_benchmarks();
   void parse_all_enabled_fixtures(const std::string &fixture_name);
@@ -52,6 +56,7 @@ protected:
   size_t m_eval_count;
   std::string m_output_fp;
   std::unordered_set<std::string> m_enabled_fixtures;
+  std::vector<std::pair<std::string, std::string>> m_reports;
 }; // end class benchmark_instances
 }
 
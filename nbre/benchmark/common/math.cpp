@@ -181,3 +181,80 @@ BENCHMARK(math_benchamrk_pow, std_pow) {
     std::cout << "std::pow(e, " << 10 << "): " << p << std::endl;
   }
 }
+
+// series in math_extension.h vs. fixed cost kernels in math_kernel.h, with
+// inputs of NR, i.e., floatxx_t
+BENCHMARK(math_benchamrk_kernel_exp, series_exp) {
+  neb::floatxx_t s(0);
+  for (int i = -9000; i < 9000; ++i) {
+    s += neb::math::exp(neb::floatxx_t(i * 0.001));
+  }
+  std::cout << "neb::exp sum: " << s << std::endl;
+}
+BENCHMARK(math_benchamrk_kernel_exp, kernel_exp) {
+  neb::floatxx_t s(0);
+  for (int i = -9000; i < 9000; ++i) {
+    s += neb::math::kernel::exp(neb::floatxx_t(i * 0.001));
+  }
+  std::cout << "neb::kernel::exp sum: " << s << std::endl;
+}
+
+BENCHMARK(math_benchamrk_kernel_arctan, series_arctan) {
+  neb::floatxx_t s(0);
+  for (int i = -9000; i < 9000; ++i) {
+    s += neb::math::arctan(neb::floatxx_t(i * 0.01));
+  }
+  std::cout << "neb::arctan sum: " << s << std::endl;
+}
+BENCHMARK(math_benchamrk_kernel_arctan, kernel_arctan) {
+  neb::floatxx_t s(0);
+  for (int i = -9000; i < 9000; ++i) {
+    s += neb::math::kernel::arctan(neb::floatxx_t(i * 0.01));
+  }
+  std::cout << "neb::kernel::arctan sum: " << s << std::endl;
+}
+
+BENCHMARK(math_benchamrk_kernel_sin, series_sin) {
+  neb::floatxx_t s(0);
+  for (int i = -9000; i < 9000; ++i) {
+    s += neb::math::sin(neb::floatxx_t(i * 0.01));
+  }
+  std::cout << "neb::sin sum: " << s << std::endl;
+}
+BENCHMARK(math_benchamrk_kernel_sin, kernel_sin) {
+  neb::floatxx_t s(0);
+  for (int i = -9000; i < 9000; ++i) {
+    s += neb::math::kernel::sin(neb::floatxx_t(i * 0.01));
+  }
+  std::cout << "neb::kernel::sin sum: " << s << std::endl;
+}
+
+BENCHMARK(math_benchamrk_kernel_ln, series_ln) {
+  neb::floatxx_t s(0);
+  for (int i = 1; i < 10000; ++i) {
+    s += neb::math::ln(neb::floatxx_t(i * 0.01));
+  }
+  std::cout << "neb::ln sum: " << s << std::endl;
+}
+BENCHMARK(math_benchamrk_kernel_ln, kernel_ln) {
+  neb::floatxx_t s(0);
+  for (int i = 1; i < 10000; ++i) {
+    s += neb::math::kernel::ln(neb::floatxx_t(i * 0.01));
+  }
+  std::cout << "neb::kernel::ln sum: " << s << std::endl;
+}
+
+BENCHMARK(math_benchamrk_kernel_pow, series_pow) {
+  neb::floatxx_t s(0);
+  for (int i = 1; i < 1000; ++i) {
+    s += neb::math::pow(neb::floatxx_t(i * 0.1), neb::floatxx_t(0.75));
+  }
+  std::cout << "neb::pow sum: " << s << std::endl;
+}
+BENCHMARK(math_benchamrk_kernel_pow, kernel_pow) {
+  neb::floatxx_t s(0);
+  for (int i = 1; i < 1000; ++i) {
+    s += neb::math::kernel::pow(neb::floatxx_t(i * 0.1), neb::floatxx_t(0.75));
+  }
+  std::cout << "neb::kernel::pow sum: " << s << std::endl;
+}
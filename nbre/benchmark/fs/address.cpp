@@ -0,0 +1,110 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "benchmark/benchmark_instances.h"
+#include "common/address.h"
+#include "fs/blockchain/blockchain_api.h"
+#include <atomic>
+#include <iostream>
+#include <random>
+
+// count allocations of the whole benchmark, so that each instance can print
+// how many it costs
+static std::atomic<uint64_t> alloc_count(0);
+
+void *operator new(size_t size) {
+  alloc_count++;
+  void *p = malloc(size);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// the NR pipeline sees every account address many times
+static std::vector<neb::bytes> gen_addrs(size_t n) {
+  std::vector<neb::bytes> ret;
+  std::mt19937 mt(1024);
+  std::uniform_int_distribution<> dis(0, 255);
+  for (size_t i = 0; i < n; i++) {
+    neb::bytes b(NAS_ADDRESS_LEN);
+    b[0] = NAS_ADDRESS_MAGIC_NUM;
+    b[1] = NAS_ADDRESS_ACCOUNT_MAGIC_NUM;
+    for (size_t k = 2; k < NAS_ADDRESS_LEN; k++) {
+      b[k] = dis(mt);
+    }
+    ret.push_back(b);
+  }
+  return ret;
+}
+
+static const size_t addr_num = 10000;
+static const size_t tx_num = 100000;
+static auto raw_addrs = gen_addrs(addr_num);
+
+template <typename T> std::vector<T> to_keys() {
+  std::vector<T> ret;
+  for (size_t i = 0; i < tx_num; i++) {
+    ret.push_back(T(raw_addrs[i % addr_num]));
+  }
+  return ret;
+}
+static auto bytes_keys = to_keys<neb::bytes>();
+static auto address_keys = to_keys<neb::address_t>();
+
+template <typename T> void map_insert_lookup(const std::vector<T> &keys) {
+  uint64_t c = alloc_count;
+  std::unordered_map<T, neb::wei_t> m;
+  for (auto &k : keys) {
+    m[k] += 1;
+  }
+  size_t found = 0;
+  for (auto &k : keys) {
+    found += m.find(k) != m.end();
+  }
+  std::cout << "allocations: " << alloc_count - c << ", found: " << found
+            << std::endl;
+}
+
+BENCHMARK(address_map, bytes_map) { map_insert_lookup(bytes_keys); }
+BENCHMARK(address_map, address_map) { map_insert_lookup(address_keys); }
+
+BENCHMARK(address_copy, transaction_info_copy) {
+  std::vector<neb::fs::transaction_info_t> txs(tx_num);
+  for (size_t i = 0; i < tx_num; i++) {
+    txs[i].m_from = address_keys[i];
+    txs[i].m_to = address_keys[tx_num - 1 - i];
+  }
+  uint64_t c = alloc_count;
+  std::vector<neb::fs::transaction_info_t> copy(txs);
+  std::cout << "allocations: " << alloc_count - c << std::endl;
+}
+
+BENCHMARK(address_copy, bytes_copy) {
+  uint64_t c = alloc_count;
+  std::vector<neb::bytes> copy(bytes_keys);
+  std::cout << "allocations: " << alloc_count - c << std::endl;
+}
+BENCHMARK(address_copy, address_copy) {
+  uint64_t c = alloc_count;
+  std::vector<neb::address_t> copy(address_keys);
+  std::cout << "allocations: " << alloc_count - c << std::endl;
+}
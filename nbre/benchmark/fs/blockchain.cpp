@@ -19,20 +19,19 @@
 //
 #include "benchmark/benchmark_instances.h"
 #include "benchmark/fs/common.h"
-
-std::unique_ptr<neb::fs::blockchain> blockchain_ptr;
+#include "fs/bc_storage_session.h"
 
 BENCHMARK(blockchain, blockchain_init) {
-  blockchain_ptr = std::make_unique<neb::fs::blockchain>(
+  neb::fs::bc_storage_session::instance().init(
       db_read_path, neb::fs::storage_open_for_readonly);
 }
 
-BENCHMARK(blockchain, load_tail_block) { blockchain_ptr->load_tail_block(); }
-
-BENCHMARK(blockchain, load_LIB_block) { blockchain_ptr->load_LIB_block(); }
+BENCHMARK(blockchain, load_LIB_block) { neb::fs::blockchain::load_LIB_block(); }
 
 BENCHMARK(blockchain, load_block_with_height) {
-  blockchain_ptr->load_block_with_height(100);
+  neb::fs::blockchain::load_block_with_height(100);
 }
 
-BENCHMARK(blockchain, blockchain_destroy) { blockchain_ptr.reset(nullptr); }
+BENCHMARK(blockchain, blockchain_destroy) {
+  neb::fs::bc_storage_session::instance().close();
+}
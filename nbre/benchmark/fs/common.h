@@ -31,6 +31,3 @@ extern std::string db_write_path;
 
 extern std::unique_ptr<neb::fs::rocksdb_storage> db_read_ptr;
 extern std::unique_ptr<neb::fs::rocksdb_storage> db_write_ptr;
-
-extern std::unique_ptr<neb::fs::blockchain> blockchain_ptr;
-extern std::unique_ptr<neb::fs::nbre_storage> nbre_ptr;
@@ -0,0 +1,98 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "benchmark/benchmark_instances.h"
+#include "crypto/hash.h"
+#include "fs/rocksdb_profile.h"
+#include "fs/rocksdb_storage.h"
+#include "fs/util.h"
+#include <boost/filesystem.hpp>
+#include <random>
+
+// trie node like records, keyed by the hash of their content
+static const size_t record_num = 100000;
+static const size_t read_num = 100000;
+static const char *profiles[] = {"trie-random-read", "ir-store", "bulk-write"};
+
+static std::string profile_db_path(const std::string &profile) {
+  return neb::fs::join_path(neb::fs::tmp_dir(), "rocksdb_profile_" + profile);
+}
+
+static neb::bytes record_key(size_t i) {
+  return neb::from_fix_bytes(
+      neb::crypto::sha3_256_hash(neb::number_to_byte<neb::bytes>(i)));
+}
+
+static void random_read(const std::string &profile) {
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(profile_db_path(profile), neb::fs::storage_open_for_readonly,
+                   profile + "-stats");
+  neb::fs::rocksdb_storage::enable_perf_context(true);
+
+  std::mt19937 mt(1024);
+  std::uniform_int_distribution<size_t> dis(0, record_num - 1);
+  for (size_t i = 0; i < read_num; i++) {
+    rs.get_bytes(record_key(dis(mt)));
+  }
+
+  neb::benchmark_instances::instance().add_report(profile + ".statistics",
+                                                  rs.statistics());
+  neb::benchmark_instances::instance().add_report(
+      profile + ".perf_context", neb::fs::rocksdb_storage::perf_context());
+  neb::fs::rocksdb_storage::enable_perf_context(false);
+  rs.close_database();
+}
+
+BENCHMARK(rocksdb_profile, rocksdb_profile_init) {
+  for (auto profile : profiles) {
+    auto p = neb::fs::rocksdb_profiles::instance().get(profile);
+    p.statistics = true;
+    neb::fs::rocksdb_profiles::instance().set(std::string(profile) + "-stats",
+                                              p);
+
+    std::string path = profile_db_path(profile);
+    if (neb::fs::exists(path)) {
+      continue;
+    }
+    neb::fs::rocksdb_storage rs;
+    rs.open_database(path, neb::fs::storage_open_for_readwrite, "bulk-write");
+    rs.batch_write([&]() {
+      for (size_t i = 0; i < record_num; i++) {
+        rs.put_bytes(record_key(i), neb::bytes(128));
+      }
+    });
+    rs.close_database();
+  }
+}
+
+BENCHMARK(rocksdb_profile, trie_random_read) {
+  random_read("trie-random-read");
+}
+
+BENCHMARK(rocksdb_profile, ir_store_random_read) { random_read("ir-store"); }
+
+BENCHMARK(rocksdb_profile, bulk_write_random_read) {
+  random_read("bulk-write");
+}
+
+BENCHMARK(rocksdb_profile, rocksdb_profile_destroy) {
+  for (auto profile : profiles) {
+    boost::filesystem::remove_all(profile_db_path(profile));
+  }
+}
@@ -31,7 +31,7 @@ std::unique_ptr<neb::fs::rocksdb_storage> db_read_ptr;
 std::unique_ptr<neb::fs::rocksdb_storage> db_write_ptr;
 
 BENCHMARK(rocksdb_storage, rocksdb_storage_init) {
-  cur_path = neb::configuration::instance().root_dir();
+  cur_path = neb::configuration::instance().nbre_root_dir();
   db_read_path = neb::fs::join_path(cur_path, "test/data/read-data.db");
   db_write_path = neb::fs::join_path(cur_path, "test/data/write-data.db");
 
@@ -52,9 +52,9 @@ BENCHMARK(rocksdb_storage, put_bytes) {
   size_t eval_count = 10;
   for (size_t i = 0; i < eval_count; i++) {
     std::string k = key + '_' + std::to_string(i);
-    std::string v = neb::util::string_to_byte(k).to_hex();
-    db_write_ptr->put_bytes(neb::util::string_to_byte(k),
-                            neb::util::string_to_byte(v));
+    std::string v = neb::string_to_byte(k).to_hex();
+    db_write_ptr->put_bytes(neb::string_to_byte(k),
+                            neb::string_to_byte(v));
   }
   db_write_ptr->close_database();
 }
@@ -67,7 +67,7 @@ BENCHMARK(rocksdb_storage, get_bytes) {
   size_t eval_count = 10;
   for (size_t i = 0; i < eval_count; i++) {
     std::string k = key + '_' + std::to_string(i);
-    db_write_ptr->get_bytes(neb::util::string_to_byte(k));
+    db_write_ptr->get_bytes(neb::string_to_byte(k));
   }
   db_write_ptr->close_database();
 }
@@ -80,7 +80,7 @@ BENCHMARK(rocksdb_storage, del_bytes) {
   size_t eval_count = 10;
   for (size_t i = 0; i < eval_count; i++) {
     std::string k = key + '_' + std::to_string(i);
-    db_write_ptr->del_by_bytes(neb::util::string_to_byte(k));
+    db_write_ptr->del_by_bytes(neb::string_to_byte(k));
   }
   db_write_ptr->close_database();
 }
@@ -93,8 +93,8 @@ BENCHMARK(rocksdb_storage, put) {
   size_t eval_count = 10;
   for (size_t i = 0; i < eval_count; i++) {
     std::string k = key + '_' + std::to_string(i);
-    std::string v = neb::util::string_to_byte(k).to_hex();
-    db_write_ptr->put(k, neb::util::string_to_byte(v));
+    std::string v = neb::string_to_byte(k).to_hex();
+    db_write_ptr->put(k, neb::string_to_byte(v));
   }
   db_write_ptr->close_database();
 }
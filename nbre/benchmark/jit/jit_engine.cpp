@@ -0,0 +1,103 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "benchmark/benchmark_instances.h"
+#include "jit/jit_engine.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/TargetSelect.h"
+#include <chrono>
+#include <thread>
+
+// calls of each thread into one compiled module, fib(20) for each call
+static const size_t call_num = 10000;
+static const int64_t fib_n = 20;
+
+static std::unique_ptr<llvm::Module> fib_module(llvm::LLVMContext &context) {
+  auto m = std::make_unique<llvm::Module>("fib", context);
+  auto *i64 = llvm::Type::getInt64Ty(context);
+  auto *f = llvm::Function::Create(llvm::FunctionType::get(i64, {i64}, false),
+                                   llvm::Function::ExternalLinkage, "fib",
+                                   m.get());
+  auto *entry = llvm::BasicBlock::Create(context, "entry", f);
+  auto *recurse = llvm::BasicBlock::Create(context, "recurse", f);
+  auto *done = llvm::BasicBlock::Create(context, "done", f);
+
+  llvm::IRBuilder<> builder(entry);
+  llvm::Value *n = &*f->arg_begin();
+  builder.CreateCondBr(builder.CreateICmpSLT(n, builder.getInt64(2)), done,
+                       recurse);
+  builder.SetInsertPoint(done);
+  builder.CreateRet(n);
+  builder.SetInsertPoint(recurse);
+  auto *a = builder.CreateCall(f, {builder.CreateSub(n, builder.getInt64(1))});
+  auto *b = builder.CreateCall(f, {builder.CreateSub(n, builder.getInt64(2))});
+  builder.CreateRet(builder.CreateAdd(a, b));
+  return m;
+}
+
+struct fib_engine {
+  fib_engine() {
+    std::vector<std::unique_ptr<llvm::Module>> ms;
+    ms.push_back(fib_module(m_context));
+    m_engine.init(std::move(ms), "fib");
+  }
+  llvm::LLVMContext m_context;
+  neb::jit::jit_engine m_engine;
+};
+static std::unique_ptr<fib_engine> engine;
+
+static void run_with_threads(size_t thread_num) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_num; t++) {
+    threads.push_back(std::thread([]() {
+      for (size_t i = 0; i < call_num; i++) {
+        engine->m_engine.run<int64_t>(fib_n);
+      }
+    }));
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  uint64_t calls = thread_num * call_num * 1000000 / std::max<int64_t>(us, 1);
+  neb::benchmark_instances::instance().add_report(
+      "jit_engine.calls_per_second." + std::to_string(thread_num),
+      std::to_string(calls));
+}
+
+BENCHMARK(jit_engine, jit_engine_init) {
+  if (engine) {
+    return;
+  }
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  engine = std::make_unique<fib_engine>();
+}
+
+BENCHMARK(jit_engine, run_1_thread) { run_with_threads(1); }
+
+BENCHMARK(jit_engine, run_2_threads) { run_with_threads(2); }
+
+BENCHMARK(jit_engine, run_4_threads) { run_with_threads(4); }
+
+BENCHMARK(jit_engine, run_8_threads) { run_with_threads(8); }
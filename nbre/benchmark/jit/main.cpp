@@ -18,28 +18,9 @@
 // <http://www.gnu.org/licenses/>.
 //
 #include "benchmark/benchmark_instances.h"
-#include "benchmark/fs/common.h"
 
-std::unique_ptr<neb::fs::nbre_storage> nbre_ptr;
+int main(int argc, char *argv[]) {
+  neb::benchmark_instances::instance().init_benchmark_instances(argc, argv);
 
-BENCHMARK(nbre_storage, nbre_storage_init) {
-  nbre_ptr.reset(nullptr);
-  nbre_ptr =
-      std::make_unique<neb::fs::nbre_storage>(db_write_path, db_read_path);
+  return neb::benchmark_instances::instance().run_all_benchmarks();
 }
-
-BENCHMARK(nbre_storage, read_nbre_by_height) {
-  nbre_ptr->read_nbre_by_height("nr", 1000);
-}
-
-BENCHMARK(nbre_storage, read_nbre_by_name_version) {
-  nbre_ptr->read_nbre_by_name_version("nr", 2LL << 48);
-}
-
-BENCHMARK(nbre_storage, write_nbre) { nbre_ptr->write_nbre(); }
-
-BENCHMARK(nbre_storage, is_latest_irreversible_block) {
-  nbre_ptr->is_latest_irreversible_block();
-}
-
-BENCHMARK(nbre_storage, nbre_storage_destroy) { nbre_ptr.reset(nullptr); }
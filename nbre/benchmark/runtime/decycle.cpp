@@ -0,0 +1,120 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "benchmark/benchmark_instances.h"
+#include "runtime/nr/graph/algo.h"
+#include <random>
+
+// graphs of test/runtime/nr/test_algo.cpp and gtest_decycle.cpp
+std::unique_ptr<neb::rt::transaction_graph> ring_graph() {
+  auto tg = std::make_unique<neb::rt::transaction_graph>();
+  char cc = 'z';
+  int32_t n = 100;
+  for (char ch = 'a'; ch < cc; ch++) {
+    for (int32_t i = 0; i < n; i++) {
+      tg->add_edge(neb::to_address(std::string(1, ch)),
+                   neb::to_address(std::string(1, ch + 1)), ch - 'a' + 1,
+                   ch - 'a' + 1);
+    }
+  }
+  for (int32_t i = 0; i < n; i++) {
+    tg->add_edge(neb::to_address(std::string(1, cc)),
+                 neb::to_address(std::string(1, 'a')), cc - 'a' + 1, 0);
+  }
+  return tg;
+}
+
+std::unique_ptr<neb::rt::transaction_graph> complete_graph() {
+  auto tg = std::make_unique<neb::rt::transaction_graph>();
+  char cc = 'z';
+  int32_t n = 5;
+  int32_t tmp = cc - 'a' + 1;
+  for (char s = 'a'; s <= cc; s++) {
+    for (char t = 'a'; t <= cc; t++) {
+      int32_t s_ch = s - 'a' + 1;
+      int32_t t_ch = t - 'a' + 1;
+      for (int32_t i = 0; i < n; i++) {
+        tg->add_edge(neb::to_address(std::string(1, s)),
+                     neb::to_address(std::string(1, t)), s_ch + tmp * t_ch + 1,
+                     s_ch + tmp * t_ch + 1);
+      }
+    }
+  }
+  return tg;
+}
+
+// a dense wash trading cluster with an acyclic tail
+std::unique_ptr<neb::rt::transaction_graph> cluster_graph() {
+  auto tg = std::make_unique<neb::rt::transaction_graph>();
+  std::mt19937 mt(1024);
+  int32_t vn = 100;
+  std::uniform_int_distribution<> vdis(0, vn - 1);
+  std::uniform_int_distribution<> wdis(1, 1000);
+  std::uniform_int_distribution<> tdis(0, 100000);
+  for (int32_t i = 0; i < vn * 20; i++) {
+    tg->add_edge(neb::to_address(std::to_string(vdis(mt))),
+                 neb::to_address(std::to_string(vdis(mt))), wdis(mt),
+                 tdis(mt));
+  }
+  for (int32_t i = 0; i < vn * 20; i++) {
+    int32_t s = vdis(mt);
+    int32_t t = vdis(mt);
+    if (s == t) {
+      continue;
+    }
+    tg->add_edge(neb::to_address("tail" + std::to_string(std::min(s, t))),
+                 neb::to_address("tail" + std::to_string(std::max(s, t))),
+                 wdis(mt), tdis(mt));
+  }
+  return tg;
+}
+
+static auto ring_tg = ring_graph();
+static auto complete_tg = complete_graph();
+static auto cluster_tg = cluster_graph();
+
+BENCHMARK(decycle_ring, non_recursive_ring) {
+  auto graph = ring_tg->internal_graph();
+  neb::rt::graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+      graph);
+}
+BENCHMARK(decycle_ring, fast_ring) {
+  auto graph = ring_tg->internal_graph();
+  neb::rt::graph_algo::fast_remove_cycles_based_on_time_sequence(graph);
+}
+
+BENCHMARK(decycle_complete, non_recursive_complete) {
+  auto graph = complete_tg->internal_graph();
+  neb::rt::graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+      graph);
+}
+BENCHMARK(decycle_complete, fast_complete) {
+  auto graph = complete_tg->internal_graph();
+  neb::rt::graph_algo::fast_remove_cycles_based_on_time_sequence(graph);
+}
+
+BENCHMARK(decycle_cluster, non_recursive_cluster) {
+  auto graph = cluster_tg->internal_graph();
+  neb::rt::graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+      graph);
+}
+BENCHMARK(decycle_cluster, fast_cluster) {
+  auto graph = cluster_tg->internal_graph();
+  neb::rt::graph_algo::fast_remove_cycles_based_on_time_sequence(graph);
+}
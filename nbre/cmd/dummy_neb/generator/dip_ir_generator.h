@@ -21,6 +21,13 @@
 #include "cmd/dummy_neb/dummy_common.h"
 #include "cmd/dummy_neb/generator/generator_base.h"
 
+std::string gen_dip_with_params(uint64_t block_nums_of_a_day, uint64_t days,
+                                uint64_t dip_start_block,
+                                const std::string &reward_addr,
+                                const std::string &coinbase_addr, float alpha,
+                                float beta, int32_t major_version,
+                                int32_t minor_version, int32_t patch_version);
+
 class dip_ir_generator : public generator_base {
 public:
   dip_ir_generator(generate_block *block, const address_t &dip_admin_addr);
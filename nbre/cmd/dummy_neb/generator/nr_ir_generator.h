@@ -21,6 +21,11 @@
 #include "cmd/dummy_neb/dummy_common.h"
 #include "cmd/dummy_neb/generator/generator_base.h"
 
+std::string gen_ir_with_params(int64_t a, int64_t b, int64_t c, int64_t d,
+                               float theta, float mu, float lambda,
+                               int32_t major_version, int32_t minor_version,
+                               int32_t patch_version);
+
 class nr_ir_generator : public generator_base {
 public:
   nr_ir_generator(generate_block *block, const address_t &nr_admin_addr);
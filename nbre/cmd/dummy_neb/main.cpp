@@ -22,6 +22,7 @@
 #include "cmd/dummy_neb/dummy_driver.h"
 #include "common/configuration.h"
 #include "fs/util.h"
+#include "jit/cpp_ir.h"
 #include <boost/process.hpp>
 #include <boost/program_options.hpp>
 
@@ -42,7 +43,8 @@ po::variables_map get_variables_map(int argc, char *argv[]) {
     ("nipc-port", po::value<uint16_t>()->default_value(6987), "nipc port")
     ("rpc-listen", po::value<std::string>()->default_value("127.0.0.1"), "nipc listen")
     ("rpc-port", po::value<uint16_t>()->default_value(0x1958), "nipc port")
-    ("enable-nbre-killer", po::value<uint64_t>()->default_value(24*60), "kill nbre periodically in miniutes");
+    ("enable-nbre-killer", po::value<uint64_t>()->default_value(24*60), "kill nbre periodically in miniutes")
+    ("bench-ir-compile", po::value<uint32_t>(), "compile generated nr, dip and auth IRs n times with clang and in process, report the time of each");
   // clang-format on
 
   po::variables_map vm;
@@ -72,6 +74,43 @@ void init_dummy_driver(dummy_driver &dd, const std::string &rpc_listen,
   // dd.add_dummy(stress);
 }
 
+void bench_ir_compile(uint32_t n) {
+  address_t admin(NAS_ADDRESS_LEN);
+  std::vector<std::pair<std::string, std::string>> irs;
+  irs.push_back(std::make_pair(
+      "nr", gen_ir_with_params(100, 2, 6, -9, 1, 1, 2, 0, 0, 1)));
+  irs.push_back(std::make_pair(
+      "dip", gen_dip_with_params(5, 1, 15, admin.to_base58(),
+                                 admin.to_base58(), 8e-3, 1, 0, 0, 1)));
+  irs.push_back(std::make_pair("auth", gen_auth_table_ir(admin, admin)));
+
+  auto time_of = [n](const std::string &name, const std::string &cpp_content,
+                     bool in_process) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < n; i++) {
+      neb::cpp::cpp_ir ci(
+          std::make_pair(name + std::to_string(i), cpp_content), in_process);
+      if (ci.llvm_ir_content().empty()) {
+        std::cout << "failed to compile " << name << std::endl;
+      }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
+                                                                 start_time)
+               .count() /
+           static_cast<double>(n);
+  };
+
+  for (auto &ir : irs) {
+    double clang_time = time_of(ir.first, ir.second, false);
+    double in_process_time = time_of(ir.first, ir.second, true);
+    std::cout << ir.first << "\tclang: " << clang_time
+              << "ms\tin-process: " << in_process_time << "ms\tspeedup: "
+              << clang_time / std::max(in_process_time, 1e-3) << "x"
+              << std::endl;
+  }
+}
+
 void init_and_start_nbre(const address_t &auth_admin_addr,
                          const std::string &neb_db_dir,
                          const std::string &nipc_listen, uint16_t nipc_port) {
@@ -151,6 +190,11 @@ int main(int argc, char *argv[]) {
   std::string rpc_listen = vm["rpc-listen"].as<std::string>();
   uint16_t rpc_port = vm["rpc-port"].as<uint16_t>();
 
+  if (vm.count("bench-ir-compile")) {
+    bench_ir_compile(vm["bench-ir-compile"].as<uint32_t>());
+    return 0;
+  }
+
   init_dummy_driver(dd, rpc_listen, rpc_port);
   if (vm.count("list-dummies")) {
     auto dummies = dd.get_all_dummy_names();
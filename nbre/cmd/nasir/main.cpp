@@ -22,11 +22,13 @@
 #include "common/ir_conf_reader.h"
 #include "fs/proto/ir.pb.h"
 #include "fs/util.h"
+#include "jit/cpp_compiler.h"
 #include "util/command.h"
 #include <algorithm>
 #include <boost/format.hpp>
 #include <boost/process.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 
@@ -116,6 +118,90 @@ void make_ir_bitcode(neb::ir_conf_reader &reader, std::string &ir_bc_file, bool
   }
 }
 
+void make_ir_bitcode_in_process(neb::ir_conf_reader &reader,
+                                std::string &ir_bc_file, bool isPayload) {
+  if (reader.cpp_files().size() != 1) {
+    LOG(INFO) << "compile with clang, for more than 1 cpp file";
+    make_ir_bitcode(reader, ir_bc_file, isPayload);
+    return;
+  }
+
+  std::vector<std::string> args(reader.flags());
+  for (auto &include : reader.include_header_files()) {
+    args.push_back("-I" + (neb::fs::is_absolute_path(include)
+                               ? include
+                               : neb::fs::join_path(root_path, include)));
+  }
+  std::string cpp_fp = reader.cpp_files()[0];
+  if (!neb::fs::is_absolute_path(cpp_fp)) {
+    cpp_fp = neb::fs::join_path(root_path, cpp_fp);
+  }
+  std::ifstream ifs(cpp_fp);
+  if (!ifs.is_open()) {
+    throw std::invalid_argument(
+        boost::str(boost::format("can't open file %1%") % cpp_fp));
+  }
+  std::string cpp_content((std::istreambuf_iterator<char>(ifs)),
+                          std::istreambuf_iterator<char>());
+
+  auto &compiler = neb::cpp::cpp_compiler::instance();
+  compiler.set_llvm_root(neb::fs::join_path(neb::fs::cur_dir(), "lib_llvm"));
+  neb::bytes bitcode =
+      compiler.compile(reader.self_ref().name(), cpp_content, args);
+  if (bitcode.empty()) {
+    LOG(INFO) << "error: failed to compile " << cpp_fp;
+    exit(1);
+  }
+
+  if (isPayload) {
+    std::string temp_path = neb::fs::tmp_dir();
+    ir_bc_file =
+        neb::fs::join_path(temp_path, reader.self_ref().name() + "_ir.bc");
+  }
+  std::ofstream ofs(ir_bc_file,
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+  ofs.write(reinterpret_cast<const char *>(bitcode.value()), bitcode.size());
+}
+
+//! compile with compiler, in-process, clang or both, where both compiles
+//! with clang and twice in process, the latter with the precompiled header,
+//! and reports the time of each
+void make_ir_bitcode_with(const std::string &compiler,
+                          neb::ir_conf_reader &reader, std::string &ir_bc_file,
+                          bool isPayload) {
+  if (compiler == "clang") {
+    make_ir_bitcode(reader, ir_bc_file, isPayload);
+    return;
+  }
+  if (compiler == "in-process") {
+    make_ir_bitcode_in_process(reader, ir_bc_file, isPayload);
+    return;
+  }
+
+  auto time_of = [&](const std::function<void()> &f) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    f();
+    auto end_time = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
+                                                                 start_time)
+        .count();
+  };
+  auto clang_time =
+      time_of([&]() { make_ir_bitcode(reader, ir_bc_file, isPayload); });
+  auto first_time = time_of(
+      [&]() { make_ir_bitcode_in_process(reader, ir_bc_file, isPayload); });
+  auto repeated_time = time_of(
+      [&]() { make_ir_bitcode_in_process(reader, ir_bc_file, isPayload); });
+
+  std::cout << "clang: " << clang_time << "ms" << std::endl;
+  std::cout << "in-process: " << first_time << "ms, repeated: "
+            << repeated_time << "ms" << std::endl;
+  std::cout << "speedup: "
+            << static_cast<double>(clang_time) /
+                   std::max<int64_t>(1, repeated_time)
+            << "x" << std::endl;
+}
+
 po::variables_map get_variables_map(int argc, char *argv[]) {
   po::options_description desc("Generate IR Payload");
   desc.add_options()("help", "show help message")(
@@ -123,7 +209,11 @@ po::variables_map get_variables_map(int argc, char *argv[]) {
       "output", po::value<std::string>(),
       "output file")("mode", po::value<std::string>()->default_value("payload"),
                      "Generate ir bitcode or ir payload. - [bitcode | "
-                     "payload], default:payload");
+                     "payload], default:payload")(
+      "compiler", po::value<std::string>()->default_value("in-process"),
+      "Compile with clang libraries in process, the clang binary, or both "
+      "to report the time of each. - [in-process | clang | both], "
+      "default:in-process");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -149,6 +239,12 @@ po::variables_map get_variables_map(int argc, char *argv[]) {
     std::cout << "You must specify output!";
     exit(1);
   }
+  std::string c = vm["compiler"].as<std::string>();
+  if (c != "in-process" && c != "clang" && c != "both") {
+    std::cout << "Wrong compiler, should be in-process, clang or both."
+              << std::endl;
+    exit(1);
+  }
 
   return vm;
 }
@@ -228,11 +324,12 @@ int main(int argc, char *argv[]) {
     root_path = root_dir;
 
     std::string mode = vm["mode"].as<std::string>();
+    std::string compiler = vm["compiler"].as<std::string>();
     std::string ir_bc_file;
 
     if (mode == "payload") {
       LOG(INFO) << "mode paylaod";
-      make_ir_bitcode(reader, ir_bc_file, true);
+      make_ir_bitcode_with(compiler, reader, ir_bc_file, true);
       if (!neb::fs::exists(ir_bc_file)) {
         std::cout << "cann't compile the file " << std::endl;
         exit(-1);
@@ -249,7 +346,7 @@ int main(int argc, char *argv[]) {
       execute_command("rm -f " + ir_bc_file);
     } else if (mode == "bitcode") {
       ir_bc_file = vm["output"].as<std::string>();
-      make_ir_bitcode(reader, ir_bc_file, false);
+      make_ir_bitcode_with(compiler, reader, ir_bc_file, false);
     } else {
       throw std::logic_error("unexpected mode ");
       return 1;
@@ -37,7 +37,32 @@ po::variables_map get_variables_map(int argc, char *argv[]) {
     ("log-to-stderr", "glog to stderr")
     ("log-dir", po::value<std::string>(), "nbre log dir")
     ("ipc-ip", po::value<std::string>(), "ipc network ip")
-    ("ipc-port", po::value<std::uint16_t>(), "ipc network port");
+    ("ipc-port", po::value<std::uint16_t>(), "ipc network port")
+    ("neb-db-profile", po::value<std::string>(),
+     "rocksdb profile of nebulas db [default: trie-random-read]")
+    ("neb-db-secondary",
+     "follow nebulas db as a rocksdb secondary, keeps every SST open")
+    ("nbre-db-profile", po::value<std::string>(),
+     "rocksdb profile of nbre db [default: ir-store]")
+    ("rocksdb-block-cache-mb", po::value<size_t>(),
+     "rocksdb block cache shared by dbs [default: 512]")
+    ("rocksdb-direct-io", "rocksdb direct I/O")
+    ("rocksdb-batch-mb", po::value<size_t>(),
+     "rocksdb batch size written at once, 0 for no limit [default: 64]")
+    ("rocksdb-batch-count", po::value<size_t>(),
+     "rocksdb batch writes written at once, 0 for no limit [default: 0]")
+    ("rocksdb-max-open-files", po::value<int>(),
+     "files kept open by each rocksdb, -1 for all, needs ulimit -n above the "
+     "SST count [default: 500]")
+    ("nr-parallel-graph", "build and decycle NR interval graphs in parallel")
+    ("jit-cache-mb", po::value<uint64_t>(),
+     "code size of jit contexts kept in memory [default: 64]")
+    ("index-txs-on-parse",
+     "index transactions of each block as it is parsed, not on first read")
+    ("trie-node-cache-size", po::value<uint64_t>(),
+     "decoded trie nodes kept in memory [default: 131072]")
+    ("block-prefetch-window", po::value<uint64_t>(),
+     "blocks read ahead when catching up the chain [default: 64]");
 
   // clang-format on
 
@@ -80,6 +105,51 @@ po::variables_map get_variables_map(int argc, char *argv[]) {
   neb::configuration::instance().nipc_listen() = vm["ipc-ip"].as<std::string>();
   neb::configuration::instance().nipc_port() = vm["ipc-port"].as<uint16_t>();
 
+  if (vm.count("neb-db-profile")) {
+    neb::configuration::instance().neb_db_profile() =
+        vm["neb-db-profile"].as<std::string>();
+  }
+  neb::configuration::instance().neb_db_secondary() =
+      vm.count("neb-db-secondary") > 0;
+  if (vm.count("nbre-db-profile")) {
+    neb::configuration::instance().nbre_db_profile() =
+        vm["nbre-db-profile"].as<std::string>();
+  }
+  if (vm.count("rocksdb-block-cache-mb")) {
+    neb::configuration::instance().rocksdb_block_cache_size() =
+        vm["rocksdb-block-cache-mb"].as<size_t>() << 20;
+  }
+  neb::configuration::instance().rocksdb_direct_io() =
+      vm.count("rocksdb-direct-io") > 0;
+  if (vm.count("rocksdb-batch-mb")) {
+    neb::configuration::instance().rocksdb_batch_max_bytes() =
+        vm["rocksdb-batch-mb"].as<size_t>() << 20;
+  }
+  if (vm.count("rocksdb-batch-count")) {
+    neb::configuration::instance().rocksdb_batch_max_count() =
+        vm["rocksdb-batch-count"].as<size_t>();
+  }
+  if (vm.count("rocksdb-max-open-files")) {
+    neb::configuration::instance().rocksdb_max_open_files() =
+        vm["rocksdb-max-open-files"].as<int>();
+  }
+  neb::configuration::instance().nr_parallel_graph() =
+      vm.count("nr-parallel-graph") > 0;
+  if (vm.count("jit-cache-mb")) {
+    neb::configuration::instance().jit_cache_size() =
+        vm["jit-cache-mb"].as<uint64_t>() << 20;
+  }
+  neb::configuration::instance().index_txs_on_parse() =
+      vm.count("index-txs-on-parse") > 0;
+  if (vm.count("trie-node-cache-size")) {
+    neb::configuration::instance().trie_node_cache_size() =
+        std::max<uint64_t>(vm["trie-node-cache-size"].as<uint64_t>(), 1);
+  }
+  if (vm.count("block-prefetch-window")) {
+    neb::configuration::instance().block_prefetch_window() =
+        std::max<uint64_t>(vm["block-prefetch-window"].as<uint64_t>(), 1);
+  }
+
   return vm;
 }
 
@@ -21,6 +21,39 @@
 #include "common/address.h"
 #include "common/base58.h"
 namespace neb {
+address_t::address_t(size_t len) : m_size(0) {
+  if (len > NAS_ADDRESS_LEN) {
+    throw std::invalid_argument("address length exceeds NAS_ADDRESS_LEN");
+  }
+  m_size = len;
+}
+
+address_t::address_t(const byte_t *buf, size_t len) : address_t(len) {
+  if (len) {
+    memcpy(m_value.value(), buf, len);
+  }
+}
+
+address_t::address_t(const bytes &v) : address_t(v.value(), v.size()) {}
+
+bool address_t::operator<(const address_t &v) const {
+  int r = memcmp(value(), v.value(), std::min(size(), v.size()));
+  if (r != 0) {
+    return r < 0;
+  }
+  return size() < v.size();
+}
+
+std::string address_t::to_base58() const {
+  return internal::convert_byte_to_base58(value(), size());
+}
+std::string address_t::to_base64() const {
+  return internal::convert_byte_to_base64(value(), size());
+}
+std::string address_t::to_hex() const {
+  return internal::convert_byte_to_hex(value(), size());
+}
+
 address_t base58_to_address(const base58_address_t &addr) {
   return bytes::from_base58(addr);
 }
@@ -22,9 +22,50 @@
 #include "common/byte.h"
 #include "common/common.h"
 
+#define NAS_ADDRESS_LEN 26
+#define NAS_ADDRESS_MAGIC_NUM 0x19
+#define NAS_ADDRESS_ACCOUNT_MAGIC_NUM 0x57
+#define NAS_ADDRESS_CONTRACT_MAGIC_NUM 0x58
+
 namespace neb {
 typedef std::string base58_address_t;
-typedef neb::bytes address_t;
+
+//! Address held inline, so that copying, comparing and hashing it never
+//! allocates. Values shorter than NAS_ADDRESS_LEN are kept with their
+//! length, longer ones are rejected with std::invalid_argument.
+//!
+//! Compares and hashes as neb::bytes of the same value does.
+class address_t {
+public:
+  address_t() : m_size(0) {}
+  explicit address_t(size_t len);
+  address_t(const byte_t *buf, size_t len);
+  address_t(const bytes &v);
+
+  inline bool operator==(const address_t &v) const {
+    return m_size == v.m_size && m_value == v.m_value;
+  }
+  inline bool operator!=(const address_t &v) const { return !operator==(v); }
+  bool operator<(const address_t &v) const;
+
+  inline byte_t operator[](size_t index) const { return m_value[index]; }
+  inline byte_t &operator[](size_t index) { return m_value[index]; }
+
+  inline size_t size() const { return m_size; }
+  inline const byte_t *value() const { return m_value.value(); }
+  inline byte_t *value() { return m_value.value(); }
+  inline bool empty() const { return m_size == 0; }
+
+  inline bytes to_bytes() const { return bytes(value(), size()); }
+
+  std::string to_base58() const;
+  std::string to_base64() const;
+  std::string to_hex() const;
+
+private:
+  fix_bytes<NAS_ADDRESS_LEN> m_value;
+  uint8_t m_size;
+}; // end class address_t
 
 address_t base58_to_address(const base58_address_t &addr);
 base58_address_t address_to_base58(const address_t &addr);
@@ -35,18 +76,27 @@ typedef std::tuple<module_t, address_bytes_t, block_height_t, block_height_t>
 typedef std::vector<auth_row_t> auth_table_t;
 
 inline address_t to_address(const std::string &addr) {
-  return string_to_byte(addr);
+  return address_t((const byte_t *)addr.c_str(), addr.size());
 }
 inline std::string address_to_string(const address_t &addr) {
-  return byte_to_string(addr);
+  return std::string((const char *)addr.value(), addr.size());
 }
 
 bool is_valid_address(const address_t &addr);
 bool is_contract_address(const address_t &addr);
 bool is_normal_address(const address_t &addr);
-
-#define NAS_ADDRESS_LEN 26
-#define NAS_ADDRESS_MAGIC_NUM 0x19
-#define NAS_ADDRESS_ACCOUNT_MAGIC_NUM 0x57
-#define NAS_ADDRESS_CONTRACT_MAGIC_NUM 0x58
 } // namespace neb
+
+namespace std {
+template <> struct hash<::neb::address_t> {
+  typedef ::neb::address_t argument_type;
+  typedef std::size_t result_type;
+  result_type operator()(argument_type const &s) const noexcept {
+    return ::neb::internal::hash_bytes(s.value(), s.size());
+  }
+};
+
+inline std::string to_string(const ::neb::address_t &s) {
+  return ::neb::address_to_string(s);
+}
+} // namespace std
@@ -34,6 +34,20 @@ bool convert_hex_to_bytes(const std::string &s, byte_t *buf, size_t &len);
 bool convert_base58_to_bytes(const std::string &s, byte_t *buf, size_t &len);
 bool convert_base64_to_bytes(const std::string &s, byte_t *buf, size_t &len);
 
+//! Same value as std::hash<std::string> of the bytes, without building the
+//! string. Iteration order of unordered containers depends on it, keep them.
+inline size_t hash_bytes(const byte_t *buf, size_t len) {
+#if defined(_LIBCPP_VERSION)
+  const char *p = reinterpret_cast<const char *>(buf);
+  return std::__do_string_hash(p, p + len);
+#elif defined(__GLIBCXX__)
+  return std::_Hash_impl::hash(buf, len);
+#else
+  return std::hash<std::string>{}(
+      std::string(reinterpret_cast<const char *>(buf), len));
+#endif
+}
+
 template <typename T, std::size_t N, std::size_t... Ns>
 std::array<T, N> make_array_impl(std::initializer_list<T> t,
                                  std::index_sequence<Ns...>) {
@@ -83,7 +97,7 @@ public:
     return m_value != v.m_value;
   }
   bool operator<(const fix_bytes<ByteLength> &v) const {
-    return memcmp(m_value, v.m_value, ByteLength) < 0;
+    return memcmp(m_value.data(), v.m_value.data(), ByteLength) < 0;
   }
   byte_t operator[](size_t index) const { return m_value[index]; }
   byte_t &operator[](size_t index) { return m_value[index]; }
@@ -277,7 +291,7 @@ template <> struct hash<::neb::bytes> {
   typedef ::neb::bytes argument_type;
   typedef std::size_t result_type;
   result_type operator()(argument_type const &s) const noexcept {
-    return std::hash<std::string>{}(byte_to_string(s));
+    return ::neb::internal::hash_bytes(s.value(), s.size());
   }
 };
 
@@ -285,7 +299,7 @@ template <size_t ByteLength> struct hash<::neb::fix_bytes<ByteLength>> {
   typedef ::neb::fix_bytes<ByteLength> argument_type;
   typedef std::size_t result_type;
   result_type operator()(argument_type const &s) const noexcept {
-    return std::hash<std::string>{}(byte_to_string(s));
+    return ::neb::internal::hash_bytes(s.value(), s.size());
   }
 };
 
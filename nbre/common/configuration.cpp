@@ -34,7 +34,14 @@ namespace po = boost::program_options;
 
 #define KTS(v) #v
 #define STR(v) KTS(v)
-configuration::configuration() {
+configuration::configuration()
+    : m_neb_db_profile("trie-random-read"), m_neb_db_secondary(false),
+      m_nbre_db_profile("ir-store"), m_rocksdb_block_cache_size(512 << 20),
+      m_rocksdb_direct_io(false), m_rocksdb_batch_max_bytes(64 << 20),
+      m_rocksdb_batch_max_count(0), m_rocksdb_max_open_files(0),
+      m_nr_parallel_graph(false), m_jit_cache_size(64 << 20),
+      m_index_txs_on_parse(false), m_trie_node_cache_size(1 << 17),
+      m_block_prefetch_window(64) {
 #ifdef NDEBUG
   // supervisor start failed with getenv
 #else
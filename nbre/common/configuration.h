@@ -100,6 +100,52 @@ public:
   inline const std::string &nbre_db_dir() const { return m_nbre_db_dir; }
   inline std::string &nbre_db_dir() { return m_nbre_db_dir; }
 
+  // rocksdb tuning profile of nebulas blockchain database, see
+  // fs/rocksdb_profile.h
+  inline const std::string &neb_db_profile() const { return m_neb_db_profile; }
+  inline std::string &neb_db_profile() { return m_neb_db_profile; }
+
+  // open nebulas blockchain database as a rocksdb secondary instance, which
+  // catches up with neb instead of reopening
+  inline const bool &neb_db_secondary() const { return m_neb_db_secondary; }
+  inline bool &neb_db_secondary() { return m_neb_db_secondary; }
+
+  // rocksdb tuning profile of nbre database
+  inline const std::string &nbre_db_profile() const {
+    return m_nbre_db_profile;
+  }
+  inline std::string &nbre_db_profile() { return m_nbre_db_profile; }
+
+  // block cache shared by rocksdb instances, in bytes
+  inline const size_t &rocksdb_block_cache_size() const {
+    return m_rocksdb_block_cache_size;
+  }
+  inline size_t &rocksdb_block_cache_size() {
+    return m_rocksdb_block_cache_size;
+  }
+
+  // rocksdb direct I/O for reads, flush and compaction
+  inline const bool &rocksdb_direct_io() const { return m_rocksdb_direct_io; }
+  inline bool &rocksdb_direct_io() { return m_rocksdb_direct_io; }
+
+  // a rocksdb batch is written once it has that many bytes or writes, 0
+  // means no limit
+  inline const size_t &rocksdb_batch_max_bytes() const {
+    return m_rocksdb_batch_max_bytes;
+  }
+  inline size_t &rocksdb_batch_max_bytes() { return m_rocksdb_batch_max_bytes; }
+  inline const size_t &rocksdb_batch_max_count() const {
+    return m_rocksdb_batch_max_count;
+  }
+  inline size_t &rocksdb_batch_max_count() { return m_rocksdb_batch_max_count; }
+
+  // files kept open by each rocksdb instance, 0 for the profile's own and -1
+  // for all of them, which needs a ulimit -n above the SST count of the db
+  inline const int &rocksdb_max_open_files() const {
+    return m_rocksdb_max_open_files;
+  }
+  inline int &rocksdb_max_open_files() { return m_rocksdb_max_open_files; }
+
   // nbre log directory
   inline const std::string &nbre_log_dir() const { return m_nbre_log_dir; }
   inline std::string &nbre_log_dir() { return m_nbre_log_dir; }
@@ -114,6 +160,32 @@ public:
   }
   inline uint64_t &nbre_start_height() { return m_nbre_start_height; }
 
+  // nr subgraphs built and decycled on functionflow runtime, serially if off
+  inline const bool &nr_parallel_graph() const { return m_nr_parallel_graph; }
+  inline bool &nr_parallel_graph() { return m_nr_parallel_graph; }
+
+  // code size of jit contexts kept by jit_driver, in bytes, least recently
+  // used ones are evicted beyond it
+  inline const uint64_t &jit_cache_size() const { return m_jit_cache_size; }
+  inline uint64_t &jit_cache_size() { return m_jit_cache_size; }
+
+  // index transactions of each block as nbre parses it, otherwise blocks are
+  // indexed when NR or DIP reads them
+  inline const bool &index_txs_on_parse() const { return m_index_txs_on_parse; }
+  inline bool &index_txs_on_parse() { return m_index_txs_on_parse; }
+
+  // decoded trie nodes kept in memory, shared by all tries
+  inline const uint64_t &trie_node_cache_size() const {
+    return m_trie_node_cache_size;
+  }
+  inline uint64_t &trie_node_cache_size() { return m_trie_node_cache_size; }
+
+  // blocks read ahead by one batch when nbre catches up the chain
+  inline const uint64_t &block_prefetch_window() const {
+    return m_block_prefetch_window;
+  }
+  inline uint64_t &block_prefetch_window() { return m_block_prefetch_window; }
+
   // nbre net ipc listen
   inline const std::string &nipc_listen() const { return m_nipc_listen; }
   inline std::string &nipc_listen() { return m_nipc_listen; }
@@ -145,9 +217,22 @@ protected:
   std::string m_nbre_exe_name;
   std::string m_neb_db_dir;
   std::string m_nbre_db_dir;
+  std::string m_neb_db_profile;
+  bool m_neb_db_secondary;
+  std::string m_nbre_db_profile;
+  size_t m_rocksdb_block_cache_size;
+  bool m_rocksdb_direct_io;
+  size_t m_rocksdb_batch_max_bytes;
+  size_t m_rocksdb_batch_max_count;
+  int m_rocksdb_max_open_files;
   std::string m_nbre_log_dir;
   address_t m_admin_pub_addr;
   uint64_t m_nbre_start_height;
+  bool m_nr_parallel_graph;
+  uint64_t m_jit_cache_size;
+  bool m_index_txs_on_parse;
+  uint64_t m_trie_node_cache_size;
+  uint64_t m_block_prefetch_window;
   std::string m_nipc_listen;
   uint16_t m_nipc_port;
 
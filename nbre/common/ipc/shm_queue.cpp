@@ -18,6 +18,7 @@
 // <http://www.gnu.org/licenses/>.
 //
 #include "common/ipc/shm_queue.h"
+#include <thread>
 
 namespace neb {
 namespace ipc {
@@ -26,7 +27,8 @@ namespace internal {
 shm_queue::shm_queue(const std::string &name, shm_session_base *session,
                      boost::interprocess::managed_shared_memory *shmem,
                      size_t capacity)
-    : m_name(name), m_shmem(shmem), m_capacity(capacity), m_session(session) {
+    : m_name(name), m_shmem(shmem), m_ring(nullptr), m_slots(nullptr),
+      m_capacity(capacity), m_wake_up(false), m_session(session) {
   try {
     if (!m_shmem) {
       throw shm_queue_failure("shmem can't be nullptr");
@@ -34,7 +36,6 @@ shm_queue::shm_queue(const std::string &name, shm_session_base *session,
     if (!m_capacity) {
       throw shm_queue_failure("capacity can't be 0");
     }
-    m_allocator = new shmem_allocator_t(m_shmem->get_segment_manager());
 
     m_mutex = m_session->bookkeeper()->acquire_named_mutex(mutex_name());
     m_empty_cond =
@@ -42,8 +43,7 @@ shm_queue::shm_queue(const std::string &name, shm_session_base *session,
     m_full_cond =
         m_session->bookkeeper()->acquire_named_condition(full_cond_name());
 
-    m_buffer =
-        m_shmem->find_or_construct<shm_vector_t>(m_name.c_str())(*m_allocator);
+    m_ring = m_shmem->find_or_construct<ring_t>(m_name.c_str())(m_capacity);
     if (!m_mutex) {
       throw shm_queue_failure("alloc mutex fail");
     }
@@ -53,9 +53,18 @@ shm_queue::shm_queue(const std::string &name, shm_session_base *session,
     if (!m_full_cond) {
       throw shm_queue_failure("alloc full cond fail");
     }
-    if (!m_buffer) {
-      throw shm_queue_failure("alloc vector fail");
+    if (!m_ring) {
+      throw shm_queue_failure("alloc ring fail");
     }
+    //! the other side may have created the ring, with its own capacity
+    m_capacity = m_ring->m_capacity;
+    m_slots = m_shmem->find_or_construct<vector_elem_t>(slots_name().c_str())[
+        m_capacity]();
+    if (!m_slots) {
+      throw shm_queue_failure("alloc slots fail");
+    }
+    m_cached_head = m_ring->m_head.load(std::memory_order_acquire);
+    m_cached_tail = m_ring->m_tail.load(std::memory_order_acquire);
   } catch (const std::exception &e) {
     throw shm_init_failure(std::string("shm_queue, ") +
                            std::string(typeid(e).name()) + " : " + e.what());
@@ -69,96 +78,150 @@ void shm_queue::reset() {
   // boost::interprocess::named_condition::remove(full_cond_name().c_str());
   // m_session->reset();
 }
-void shm_queue::push_back(shm_type_id_t type_id, void *ptr) {
-  boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
-      *m_mutex);
-  if (m_buffer->size() == m_capacity) {
-    m_full_cond->wait(_l);
+
+bool shm_queue::try_push(const vector_elem_t &e) {
+  uint64_t tail = m_ring->m_tail.load(std::memory_order_relaxed);
+  if (tail - m_cached_head >= m_capacity) {
+    m_cached_head = m_ring->m_head.load(std::memory_order_acquire);
+    if (tail - m_cached_head >= m_capacity) {
+      return false;
+    }
   }
-  if (m_buffer->size() >= m_capacity)
-    return;
-  boost::interprocess::managed_shared_memory::handle_t h =
-      m_shmem->get_handle_from_address(ptr);
+  m_slots[tail % m_capacity] = e;
+  m_ring->m_tail.store(tail + 1, std::memory_order_release);
+
+  //! pairs with the fence in pop_front, either the consumer sees the new tail
+  //! or we see it parked
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_ring->m_consumer_parked.load(std::memory_order_relaxed)) {
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
+        *m_mutex);
+    m_empty_cond->notify_all();
+  }
+  return true;
+}
+
+bool shm_queue::try_pop(vector_elem_t &e) {
+  uint64_t head = m_ring->m_head.load(std::memory_order_relaxed);
+  if (head == m_cached_tail) {
+    m_cached_tail = m_ring->m_tail.load(std::memory_order_acquire);
+    if (head == m_cached_tail) {
+      return false;
+    }
+  }
+  e = m_slots[head % m_capacity];
+  m_ring->m_head.store(head + 1, std::memory_order_release);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_ring->m_producer_parked.load(std::memory_order_relaxed)) {
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
+        *m_mutex);
+    m_full_cond->notify_all();
+  }
+  return true;
+}
+
+std::tuple<void *, shm_type_id_t, shm_queue::element_op_tag>
+shm_queue::to_tuple(const vector_elem_t &e) {
+  return std::make_tuple(m_shmem->get_address_from_handle(e.m_handle), e.m_type,
+                         e.m_op_type);
+}
+
+void shm_queue::push_back(shm_type_id_t type_id, void *ptr) {
+  push_back(type_id, ptr, new_object);
+}
+
+void shm_queue::push_back(shm_type_id_t type_id, void *ptr,
+                          element_op_tag op_type) {
   vector_elem_t e;
-  e.m_handle = h;
+  e.m_handle = m_shmem->get_handle_from_address(ptr);
   e.m_type = type_id;
-  e.m_op_type = new_object;
-  try {
-    m_buffer->push_back(e);
-  } catch (const std::exception &e) {
-    LOG(ERROR) << "got exception " << e.what();
+  e.m_op_type = op_type;
+
+  for (size_t i = 0; i < spin_num; i++) {
+    if (try_push(e)) {
+      return;
+    }
+    std::this_thread::yield();
   }
-  if (m_buffer->size() == 1) {
-    m_empty_cond->notify_all();
+
+  {
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
+        *m_mutex);
+    m_ring->m_producer_parked.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_ring->m_tail.load(std::memory_order_relaxed) -
+            m_ring->m_head.load(std::memory_order_relaxed) >=
+        m_capacity) {
+      m_full_cond->wait(_l);
+    }
+    m_ring->m_producer_parked.store(0, std::memory_order_relaxed);
+  }
+  if (!try_push(e)) {
+    LOG(ERROR) << "shm_queue " << m_name << " is full, drop element";
   }
 }
 
 std::tuple<void *, shm_type_id_t, shm_queue::element_op_tag>
 shm_queue::pop_front() {
-  boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
-      *m_mutex);
-  if (m_buffer->empty()) {
-    m_empty_cond->wait(_l);
+  vector_elem_t e;
+  for (size_t i = 0; i < spin_num; i++) {
+    if (try_pop(e)) {
+      return to_tuple(e);
+    }
+    std::this_thread::yield();
   }
-  if (m_buffer->empty()) {
-    return std::make_tuple<void *, shm_type_id_t, element_op_tag>(nullptr, 0,
-                                                                  new_object);
+
+  {
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
+        *m_mutex);
+    m_ring->m_consumer_parked.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_wake_up.exchange(false) &&
+        m_ring->m_tail.load(std::memory_order_relaxed) ==
+            m_ring->m_head.load(std::memory_order_relaxed)) {
+      m_empty_cond->wait(_l);
+    }
+    m_ring->m_consumer_parked.store(0, std::memory_order_relaxed);
   }
-  vector_elem_t e;
-  e = m_buffer->front();
-  m_buffer->erase(m_buffer->begin());
-  if (m_buffer->size() == m_capacity - 1) {
-    m_full_cond->notify_all();
+  if (try_pop(e)) {
+    return to_tuple(e);
   }
-  return std::make_tuple(m_shmem->get_address_from_handle(e.m_handle), e.m_type,
-                         e.m_op_type);
+  return std::make_tuple<void *, shm_type_id_t, element_op_tag>(nullptr, 0,
+                                                                new_object);
 }
 
 std::tuple<void *, shm_type_id_t, shm_queue::element_op_tag>
 shm_queue::try_pop_front() {
-  boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
-      *m_mutex);
-  if (m_buffer->empty()) {
-    return std::make_tuple<void *, shm_type_id_t, element_op_tag>(nullptr, 0,
-                                                                  new_object);
-  }
   vector_elem_t e;
-  e = m_buffer->front();
-  m_buffer->erase(m_buffer->begin());
-  if (m_buffer->size() == m_capacity - 1) {
-    m_full_cond->notify_all();
+  if (try_pop(e)) {
+    return to_tuple(e);
   }
-  return std::make_tuple(m_shmem->get_address_from_handle(e.m_handle), e.m_type,
-                         e.m_op_type);
+  return std::make_tuple<void *, shm_type_id_t, element_op_tag>(nullptr, 0,
+                                                                new_object);
 }
 
 size_t shm_queue::size() const {
-  boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
-      *m_mutex);
-  return m_buffer->size();
+  uint64_t head = m_ring->m_head.load(std::memory_order_acquire);
+  return m_ring->m_tail.load(std::memory_order_acquire) - head;
 }
 
 void shm_queue::wake_up_if_empty() {
+  m_wake_up = true;
   boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
       *m_mutex);
-
-  if (m_buffer->empty()) {
-    m_empty_cond->notify_all();
-  }
-}
-size_t shm_queue::empty() const {
-  boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
-      *m_mutex);
-  return m_buffer->empty();
+  m_empty_cond->notify_all();
 }
+size_t shm_queue::empty() const { return size() == 0; }
 
 shm_queue::~shm_queue() {
   LOG(INFO) << "m_shmem: " << (void *)m_shmem;
-  if (m_shmem && m_buffer) {
-    m_shmem->destroy_ptr(m_buffer);
+  //! by name, as the other side may have destroyed them already
+  if (m_shmem && m_slots) {
+    m_shmem->destroy<vector_elem_t>(slots_name().c_str());
   }
-  if (m_allocator) {
-    delete m_allocator;
+  if (m_shmem && m_ring) {
+    m_shmem->destroy<ring_t>(m_name.c_str());
   }
   m_session->bookkeeper()->release_named_mutex(mutex_name());
   m_session->bookkeeper()->release_named_condition(empty_cond_name());
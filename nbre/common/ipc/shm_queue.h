@@ -21,6 +21,7 @@
 #include "common/common.h"
 #include "common/ipc/shm_base.h"
 #include "common/ipc/shm_session.h"
+#include <atomic>
 
 namespace neb {
 namespace ipc {
@@ -32,6 +33,12 @@ struct shm_queue_failure : public std::exception {
 protected:
   std::string m_msg;
 };
+//! A fixed capacity single producer single consumer ring in shared memory.
+//! Both sides move head and tail with atomics only, the named mutex and
+//! conditions are touched just when one side has to park, on an empty or a
+//! full ring, and by the other side to wake it up. Each queue is written by
+//! the service thread of one process and read by the queue watcher of the
+//! other, thus push_back and recycle must stay on one thread.
 class shm_queue {
 public:
   enum element_op_tag {
@@ -48,23 +55,7 @@ public:
   void push_back(shm_type_id_t type_id, void *ptr);
 
   template <typename T> void recycle(T *ptr) {
-    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
-        *m_mutex);
-    if (m_buffer->size() == m_capacity) {
-      m_full_cond->wait(_l);
-    }
-    if (m_buffer->size() >= m_capacity)
-      return;
-    boost::interprocess::managed_shared_memory::handle_t h =
-        m_shmem->get_handle_from_address(ptr);
-    vector_elem_t e;
-    e.m_handle = h;
-    e.m_type = T::pkg_identifier;
-    e.m_op_type = recycle_object;
-    m_buffer->push_back(e);
-    if (m_buffer->size() == 1) {
-      m_empty_cond->notify_one();
-    }
+    push_back(T::pkg_identifier, ptr, recycle_object);
   }
 
   std::tuple<void *, shm_type_id_t, element_op_tag> pop_front();
@@ -84,6 +75,9 @@ private:
   std::string mutex_name() { return m_name + ".mutex"; }
   std::string empty_cond_name() { return m_name + ".empty_cond"; }
   std::string full_cond_name() { return m_name + ".full_cond"; }
+  std::string slots_name() { return m_name + ".slots"; }
+
+  void push_back(shm_type_id_t type_id, void *ptr, element_op_tag op_type);
 
 protected:
   struct vector_elem_t {
@@ -91,19 +85,43 @@ protected:
     shm_type_id_t m_type;
     element_op_tag m_op_type;
   };
-  typedef boost::interprocess::allocator<
-      vector_elem_t,
-      boost::interprocess::managed_shared_memory::segment_manager>
-      shmem_allocator_t;
-  typedef boost::interprocess::vector<vector_elem_t, shmem_allocator_t>
-      shm_vector_t;
+
+  //! head and tail keep growing, slot of index i is i % m_capacity. Each of
+  //! them is on its own cache line, so the producer and the consumer don't
+  //! invalidate each other's line on every element.
+  struct ring_t {
+    ring_t(size_t capacity)
+        : m_head(0), m_tail(0), m_consumer_parked(0), m_producer_parked(0),
+          m_capacity(capacity) {}
+    //! written by the consumer
+    alignas(64) std::atomic<uint64_t> m_head;
+    //! written by the producer
+    alignas(64) std::atomic<uint64_t> m_tail;
+    alignas(64) std::atomic<uint32_t> m_consumer_parked;
+    std::atomic<uint32_t> m_producer_parked;
+    uint64_t m_capacity;
+  };
+
+  //! spin before parking, an element usually comes within a few yields
+  static constexpr size_t spin_num = 64;
+
+  bool try_push(const vector_elem_t &e);
+  bool try_pop(vector_elem_t &e);
+  std::tuple<void *, shm_type_id_t, element_op_tag>
+  to_tuple(const vector_elem_t &e);
+
   std::string m_name;
   boost::interprocess::managed_shared_memory *m_shmem;
-  shmem_allocator_t *m_shm_allocator;
-  shmem_allocator_t *m_allocator;
 
-  shm_vector_t *m_buffer;
+  ring_t *m_ring;
+  vector_elem_t *m_slots;
   size_t m_capacity;
+  //! last head seen by the producer and last tail seen by the consumer, to
+  //! read the other side's cache line only when the ring looks full or empty
+  uint64_t m_cached_head;
+  uint64_t m_cached_tail;
+  //! set by wake_up_if_empty, so a consumer that is about to park returns
+  std::atomic_bool m_wake_up;
 
   std::unique_ptr<boost::interprocess::named_mutex> m_mutex;
   std::unique_ptr<boost::interprocess::named_condition> m_empty_cond;
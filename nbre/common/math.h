@@ -18,7 +18,9 @@
 // <http://www.gnu.org/licenses/>.
 //
 #pragma once
+#include "common/math/internal/math_batch.h"
 #include "common/math/internal/math_extension.h"
+#include "common/math/internal/math_kernel.h"
 #include "common/math/internal/math_template.h"
 #include "common/math/softfloat.hpp"
 
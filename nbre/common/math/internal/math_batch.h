@@ -0,0 +1,99 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "common/math/internal/math_extension.h"
+
+namespace neb {
+namespace math {
+
+//! Element wise versions of the series in math_extension.h. Each element runs
+//! the very same softfloat operations as the scalar function, so results are
+//! bit identical, while the series invariants are computed once per batch.
+namespace batch {
+
+template <typename T> void exp(const std::vector<T> &x, std::vector<T> &ret) {
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::exp(x[i], c);
+  }
+}
+
+template <typename T>
+void arctan(const std::vector<T> &x, std::vector<T> &ret) {
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::arctan(x[i], c);
+  }
+}
+
+template <typename T> void sin(const std::vector<T> &x, std::vector<T> &ret) {
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::sin(x[i], c);
+  }
+}
+
+template <typename T> void ln(const std::vector<T> &x, std::vector<T> &ret) {
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::ln(x[i], c);
+  }
+}
+
+template <typename T>
+void fast_ln(const std::vector<T> &x, std::vector<T> &ret) {
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::fast_ln(x[i], c);
+  }
+}
+
+//! ret[i] = x[i]^y[i]
+template <typename T>
+void pow(const std::vector<T> &x, const std::vector<T> &y,
+         std::vector<T> &ret) {
+  if (x.size() != y.size()) {
+    throw std::invalid_argument("batch pow with different sizes");
+  }
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::pow(x[i], y[i], c);
+  }
+}
+
+//! ret[i] = x[i]^y
+template <typename T>
+void pow(const std::vector<T> &x, const T &y, std::vector<T> &ret) {
+  internal::series_constants<T> c;
+  ret.resize(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    ret[i] = internal::pow(x[i], y, c);
+  }
+}
+} // namespace batch
+} // namespace math
+} // namespace neb
@@ -43,64 +43,83 @@ template <typename T> T from_string(const std::string &str) {
   return val;
 }
 
-template <typename T> bool exit_cond(const T &x, const T &y) {
-  if (x - y < MATH_MIN && y - x < MATH_MIN) {
+namespace internal {
+//! invariants of the series below, hoisted so that a batch computes them once
+template <typename T> struct series_constants {
+  series_constants()
+      : zero(softfloat_cast<uint32_t, typename T::value_type>(0)),
+        one(softfloat_cast<uint32_t, typename T::value_type>(1)),
+        two(softfloat_cast<uint32_t, typename T::value_type>(2)),
+        min_delta(MATH_MIN), pi(constants<T>::pi()), half_pi(pi / two),
+        double_pi(two * pi) {}
+
+  T zero, one, two, min_delta, pi, half_pi, double_pi;
+};
+
+//! bits of x as float64, what operator<< prints
+template <typename T> uint64_t float64_bits(const T &x) {
+  return softfloat_cast<typename T::value_type, float64_t>(x).v;
+}
+//! x prints as "inf"
+template <typename T> bool is_pos_inf(const T &x) {
+  return float64_bits(x) == 0x7ff0000000000000;
+}
+//! x prints as "-nan"
+template <typename T> bool is_neg_nan(const T &x) {
+  uint64_t b = float64_bits(x);
+  return (b >> 63) && (b & 0x7ff0000000000000) == 0x7ff0000000000000 &&
+         (b & 0x000fffffffffffff);
+}
+
+template <typename T>
+bool exit_cond(const T &x, const T &y, const series_constants<T> &c) {
+  if (x - y < c.min_delta && y - x < c.min_delta) {
     return true;
   }
-  if (to_string(x) == std::string("inf") &&
-      to_string(y) == std::string("inf")) {
+  if (is_pos_inf(x) && is_pos_inf(y)) {
     return true;
   }
-  if (to_string(x) == std::string("-nan") &&
-      to_string(y) == std::string("-nan")) {
+  if (is_neg_nan(x) && is_neg_nan(y)) {
     return true;
   }
   return false;
 }
 
-template <typename T> T exp(const T &x) {
-  T zero = softfloat_cast<uint32_t, typename T::value_type>(0);
-  T one = softfloat_cast<uint32_t, typename T::value_type>(1);
-
-  if (x < zero) {
-    return one / exp(-x);
+template <typename T> T exp(const T &x, const series_constants<T> &c) {
+  if (x < c.zero) {
+    return c.one / exp(-x, c);
   }
 
-  T ret = one;
-  T i = one;
+  T ret = c.one;
+  T i = c.one;
   T tail = x;
 
   while (true) {
     T tmp;
 
     tmp = ret + tail;
-    if (exit_cond(tmp, ret)) {
+    if (exit_cond(tmp, ret, c)) {
       break;
     }
 
     ret = tmp;
-    i += one;
+    i += c.one;
     tail *= x / i;
   }
 
   return ret;
 }
 
-template <typename T> T arctan(const T &x) {
-  T zero = softfloat_cast<uint32_t, typename T::value_type>(0);
-  T one = softfloat_cast<uint32_t, typename T::value_type>(1);
-  T two = softfloat_cast<uint32_t, typename T::value_type>(2);
-  T half_pi = constants<T>::pi() / two;
-
-  if (x > one) {
-    return half_pi - arctan(one / x);
-  } else if (x < zero - one) {
-    return zero - half_pi - arctan(one / x);
+template <typename T> T arctan(const T &x, const series_constants<T> &c) {
+  if (x > c.one) {
+    return c.half_pi - arctan(c.one / x, c);
+  } else if (x < c.zero - c.one) {
+    return c.zero - c.half_pi - arctan(c.one / x, c);
   }
 
   T x2 = x * x;
-  T ret = zero;
-  T i = one;
+  T ret = c.zero;
+  T i = c.one;
   T s = x;
   bool odd = false;
 
@@ -111,34 +130,30 @@ template <typename T> T arctan(const T &x) {
     } else {
       tmp = ret + s / i;
     }
-    if (exit_cond(tmp, ret)) {
+    if (exit_cond(tmp, ret, c)) {
       break;
     }
     ret = tmp;
     odd = !odd;
-    i += two;
+    i += c.two;
     s = s * x2;
   }
   return ret;
 }
 
-template <typename T> T sin(const T &x) {
-  T zero = softfloat_cast<uint32_t, typename T::value_type>(0);
-  if (x < zero) {
-    return zero - sin(zero - x);
+template <typename T> T sin(const T &x, const series_constants<T> &c) {
+  if (x < c.zero) {
+    return c.zero - sin(c.zero - x, c);
   }
 
-  T one = softfloat_cast<uint32_t, typename T::value_type>(1);
-  T two = softfloat_cast<uint32_t, typename T::value_type>(2);
-  T double_pi = two * constants<T>::pi();
-  if (x > double_pi) {
-    T tmp = (x / double_pi).integer_val();
-    return sin(x - tmp * double_pi);
+  if (x > c.double_pi) {
+    T tmp = (x / c.double_pi).integer_val();
+    return sin(x - tmp * c.double_pi, c);
   }
 
   T x2 = x * x;
-  T ret = zero;
-  T i = one;
+  T ret = c.zero;
+  T i = c.one;
   T tail = x;
   bool odd = false;
 
@@ -149,28 +164,24 @@ template <typename T> T sin(const T &x) {
     } else {
       tmp = ret + tail;
     }
-    if (exit_cond(tmp, ret)) {
+    if (exit_cond(tmp, ret, c)) {
       break;
     }
     ret = tmp;
     odd = !odd;
-    tail *= (x2 / ((i + one) * (i + two)));
-    i += two;
+    tail *= (x2 / ((i + c.one) * (i + c.two)));
+    i += c.two;
   }
   return ret;
 }
 
-template <typename T> T ln(const T &x) {
-  T zero = softfloat_cast<uint32_t, typename T::value_type>(0);
-  T one = softfloat_cast<uint32_t, typename T::value_type>(1);
-  T two = softfloat_cast<uint32_t, typename T::value_type>(2);
-
+template <typename T> T ln(const T &x, const series_constants<T> &c) {
   auto func = [&](T x) {
-    T ret = zero;
+    T ret = c.zero;
     bool odd = true;
 
     T s = x;
-    T i = one;
+    T i = c.one;
 
     while (true) {
       T tmp;
@@ -180,51 +191,77 @@ template <typename T> T ln(const T &x) {
       } else {
         tmp = ret - s / i;
       }
-      if (exit_cond(tmp, ret)) {
+      if (exit_cond(tmp, ret, c)) {
         break;
       }
 
       ret = tmp;
       odd = !odd;
-      i += one;
+      i += c.one;
       s = s * x;
     }
     return ret;
   };
 
-  if (x > two) {
-    return zero - func(one / x - one);
+  if (x > c.two) {
+    return c.zero - func(c.one / x - c.one);
   }
-  return func(x - one);
+  return func(x - c.one);
 }
 
-template <typename T> T fast_ln(const T &x) {
-  T zero = softfloat_cast<uint32_t, typename T::value_type>(0);
-  T one = softfloat_cast<uint32_t, typename T::value_type>(1);
-  T two = softfloat_cast<uint32_t, typename T::value_type>(2);
-
+template <typename T> T fast_ln(const T &x, const series_constants<T> &c) {
   auto func = [&](T x) {
-    T ret = zero;
-    T s = two * x;
-    T i = one;
+    T ret = c.zero;
+    T s = c.two * x;
+    T i = c.one;
     T x2 = x * x;
 
     while (true) {
       T tmp;
 
       tmp = ret + s / i;
-      if (exit_cond(tmp, ret)) {
+      if (exit_cond(tmp, ret, c)) {
         break;
       }
 
       ret = tmp;
-      i += two;
+      i += c.two;
       s = s * x2;
     }
     return ret;
   };
 
-  return func((x - one) / (x + one));
+  return func((x - c.one) / (x + c.one));
+}
+
+template <typename T>
+T pow(const T &x, const T &y, const series_constants<T> &c) {
+  return exp(y * fast_ln(x, c), c);
+}
+} // namespace internal
+
+template <typename T> bool exit_cond(const T &x, const T &y) {
+  return internal::exit_cond(x, y, internal::series_constants<T>());
+}
+
+template <typename T> T exp(const T &x) {
+  return internal::exp(x, internal::series_constants<T>());
+}
+
+template <typename T> T arctan(const T &x) {
+  return internal::arctan(x, internal::series_constants<T>());
+}
+
+template <typename T> T sin(const T &x) {
+  return internal::sin(x, internal::series_constants<T>());
+}
+
+template <typename T> T ln(const T &x) {
+  return internal::ln(x, internal::series_constants<T>());
+}
+
+template <typename T> T fast_ln(const T &x) {
+  return internal::fast_ln(x, internal::series_constants<T>());
 }
 
 namespace internal {
@@ -307,7 +344,7 @@ template <typename T> T log2(const T &x) { return ln(x) / constants<T>::ln2(); }
 
 //! return x^y
 template <typename T> T pow(const T &x, const T &y) {
-  return exp(y * fast_ln(x));
+  return internal::pow(x, y, internal::series_constants<T>());
 }
 
 template <typename T> T pow(const T &x, const int64_t &y) {
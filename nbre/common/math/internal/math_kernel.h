@@ -0,0 +1,264 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "common/math/internal/math_extension.h"
+
+namespace neb {
+namespace math {
+
+//! Fixed cost transcendental kernels, i.e., range reduction, a table lookup
+//! and a fixed degree minimax polynomial, all evaluated in softfloat, thus
+//! deterministic across platforms. Coefficients are fitted for float32
+//! (floatxx_t), errors are a few ulps of float32.
+//!
+//! These do not return the same bits as the series in math_extension.h, the
+//! series stay for the existing NR and DIP versions.
+namespace kernel {
+namespace internal {
+
+template <typename T> struct kernel_constants {
+  kernel_constants()
+      : zero(softfloat_cast<uint32_t, typename T::value_type>(0)),
+        one(softfloat_cast<uint32_t, typename T::value_type>(1)),
+        two(softfloat_cast<uint32_t, typename T::value_type>(2)), half(0.5),
+        sqrt2(1.4142135623730951), two_pow_64(18446744073709551616.0),
+        // ln2 = ln2_hi + ln2_lo, ln2_hi has few bits, so n * ln2_hi is exact
+        ln2_hi(0.693359375), ln2_lo(-2.1219444005469057e-04),
+        inv_ln2(1.4426950408889634),
+        // pi/2 = pio2_hi + pio2_lo
+        pio2_hi(1.5703125), pio2_lo(4.8382679489661923e-04),
+        two_over_pi(0.6366197723675814), half_pi(1.5707963267948966),
+        sixteen(16), one_sixteenth(0.0625),
+        // exp(r), r in [-ln2/2, ln2/2]
+        exp_p{T(0.9999999999190661), T(1.0000000377260072),
+              T(0.5000000168414279), T(0.16666415482010763),
+              T(0.04166608359157548), T(0.00837512857394843),
+              T(0.0013956056105000878)},
+        // ln(m) = 2s + s^3 * P(s^2), s = (m - 1) / (m + 1), m in
+        // [sqrt(2)/2, sqrt(2)]
+        ln_p{T(0.6666668526603459), T(0.3998871887288297),
+             T(0.29582046854437166)},
+        // sin(r) = r + r^3 * P(r^2), r in [-pi/4, pi/4]
+        sin_p{T(-0.1666666466792797), T(0.008332748998473615),
+              T(-0.00019588008863807968)},
+        // cos(r) = 1 - r^2 / 2 + r^4 * P(r^2), r in [-pi/4, pi/4]
+        cos_p{T(0.04166666466418935), T(-0.0013888303643379276),
+              T(2.4548040545072063e-05)},
+        // atan(u) = u + u^3 * P(u^2), u in [-1/32, 1/32]
+        atan_p{T(-0.33333331642012143), T(0.1998607299506754)},
+        // atan(k / 16), k in [0, 16]
+        atan_table{T(0.0),
+                   T(0.06241880999595735),
+                   T(0.12435499454676144),
+                   T(0.18534794999569476),
+                   T(0.24497866312686414),
+                   T(0.3028848683749714),
+                   T(0.35877067027057225),
+                   T(0.4124104415973873),
+                   T(0.4636476090008061),
+                   T(0.5123894603107377),
+                   T(0.5585993153435624),
+                   T(0.6022873461349642),
+                   T(0.6435011087932844),
+                   T(0.6823165548747481),
+                   T(0.7188299996216245),
+                   T(0.7531512809621944),
+                   T(0.7853981633974483)} {}
+
+  T zero, one, two, half, sqrt2, two_pow_64;
+  T ln2_hi, ln2_lo, inv_ln2;
+  T pio2_hi, pio2_lo, two_over_pi, half_pi;
+  T sixteen, one_sixteenth;
+  std::array<T, 7> exp_p;
+  std::array<T, 3> ln_p;
+  std::array<T, 3> sin_p;
+  std::array<T, 3> cos_p;
+  std::array<T, 2> atan_p;
+  std::array<T, 17> atan_table;
+};
+
+template <typename T> const kernel_constants<T> &kc() {
+  static const kernel_constants<T> c;
+  return c;
+}
+
+//! round to the nearest integer, ties away from zero, whatever the softfloat
+//! rounding mode is
+template <typename T> int64_t round_to_int64(const T &x) {
+  const auto &c = kc<T>();
+  T t = x < c.zero ? x - c.half : x + c.half;
+  return softfloat_cast<typename T::value_type, int64_t>(t);
+}
+
+template <typename T, size_t N>
+T horner(const std::array<T, N> &p, const T &x) {
+  T ret = p[N - 1];
+  for (size_t i = N - 1; i > 0; i--) {
+    ret = ret * x + p[i - 1];
+  }
+  return ret;
+}
+
+//! 2^n for n in [1 - bias, bias], built from the exponent bits
+template <typename T> T pow2(int64_t n) {
+  typedef math::internal::float_detail<T> detail_t;
+  typename detail_t::value_type dt;
+  dt.v = kc<T>().one;
+  dt.detail.exponent = n + detail_t::bias;
+  return T(dt.v);
+}
+
+//! x * 2^n, in steps so that each factor is a normal number
+template <typename T> T scale2(T x, int64_t n) {
+  constexpr int64_t bias = math::internal::float_detail<T>::bias;
+  n = std::max<int64_t>(-3 * bias, std::min<int64_t>(3 * bias, n));
+  while (n > bias) {
+    x = x * pow2<T>(bias);
+    n -= bias;
+  }
+  while (n < 1 - bias) {
+    x = x * pow2<T>(1 - bias);
+    n += bias - 1;
+  }
+  return x * pow2<T>(n);
+}
+
+template <typename T> T sin_poly(const T &r) {
+  const auto &c = kc<T>();
+  T t = r * r;
+  return r + r * t * horner(c.sin_p, t);
+}
+
+template <typename T> T cos_poly(const T &r) {
+  const auto &c = kc<T>();
+  T t = r * r;
+  return c.one - c.half * t + t * t * horner(c.cos_p, t);
+}
+} // namespace internal
+
+template <typename T> T exp(const T &x) {
+  const auto &c = internal::kc<T>();
+  if (x != x) {
+    return x;
+  }
+  int64_t n = internal::round_to_int64(x * c.inv_ln2);
+  // out of range of any float type, result is inf or 0 anyway
+  n = std::max<int64_t>(-65536, std::min<int64_t>(65536, n));
+  T nf = softfloat_cast<int64_t, typename T::value_type>(n);
+  T r = (x - nf * c.ln2_hi) - nf * c.ln2_lo;
+  return internal::scale2(internal::horner(c.exp_p, r), n);
+}
+
+template <typename T> T ln(const T &x) {
+  const auto &c = internal::kc<T>();
+  typedef math::internal::float_detail<T> detail_t;
+  typedef typename detail_t::value_type detail_type;
+  constexpr int64_t max_exponent = 2 * detail_t::bias + 1;
+
+  if (x != x || x < c.zero) {
+    return (x - x) / (x - x);
+  }
+  if (x == c.zero) {
+    return (c.zero - c.one) / c.zero;
+  }
+
+  detail_type dt;
+  dt.v = x;
+  int64_t e = 0;
+  if (dt.detail.exponent == max_exponent) {
+    return x;
+  }
+  if (dt.detail.exponent == 0) {
+    // subnormal
+    dt.v = x * c.two_pow_64;
+    e -= 64;
+  }
+  e += int64_t(dt.detail.exponent) - detail_t::bias;
+  dt.detail.exponent = detail_t::bias;
+  T m(dt.v);
+  if (m > c.sqrt2) {
+    m = m * c.half;
+    e++;
+  }
+
+  T s = (m - c.one) / (m + c.one);
+  T t = s * s;
+  T ef = softfloat_cast<int64_t, typename T::value_type>(e);
+  return ef * c.ln2_hi +
+         (c.two * s + (s * t * internal::horner(c.ln_p, t) + ef * c.ln2_lo));
+}
+
+template <typename T> T sin(const T &x) {
+  const auto &c = internal::kc<T>();
+  if (x != x || x - x != c.zero) {
+    // nan or inf
+    return (x - x) / (x - x);
+  }
+  int64_t k = internal::round_to_int64(x * c.two_over_pi);
+  T kf = softfloat_cast<int64_t, typename T::value_type>(k);
+  T r = (x - kf * c.pio2_hi) - kf * c.pio2_lo;
+  switch (k & 0x3) {
+  case 0:
+    return internal::sin_poly(r);
+  case 1:
+    return internal::cos_poly(r);
+  case 2:
+    return c.zero - internal::sin_poly(r);
+  default:
+    return c.zero - internal::cos_poly(r);
+  }
+}
+
+template <typename T> T arctan(const T &x) {
+  const auto &c = internal::kc<T>();
+  if (x != x) {
+    return x;
+  }
+  if (x < c.zero) {
+    return c.zero - arctan(c.zero - x);
+  }
+
+  T a = x;
+  bool inverted = false;
+  if (a > c.one) {
+    a = c.one / a;
+    inverted = true;
+  }
+  // atan(a) = atan(k / 16) + atan(u)
+  int64_t k = internal::round_to_int64(a * c.sixteen);
+  T ck = softfloat_cast<int64_t, typename T::value_type>(k) * c.one_sixteenth;
+  T u = (a - ck) / (c.one + a * ck);
+  T t = u * u;
+  T ret = c.atan_table[k] + (u + u * t * internal::horner(c.atan_p, t));
+  return inverted ? c.half_pi - ret : ret;
+}
+
+//! return x^y, x > 0
+template <typename T> T pow(const T &x, const T &y) {
+  const auto &c = internal::kc<T>();
+  if (x == c.zero) {
+    return y > c.zero ? c.zero : c.one / c.zero;
+  }
+  return kernel::exp(y * kernel::ln(x));
+}
+} // namespace kernel
+} // namespace math
+} // namespace neb
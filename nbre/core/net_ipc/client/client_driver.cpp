@@ -157,9 +157,14 @@ void client_driver_base::init_timer_thread() {
 void client_driver_base::init_nbre() {
 
   fs::bc_storage_session::instance().init(
-      configuration::instance().neb_db_dir(), fs::storage_open_for_readonly);
+      configuration::instance().neb_db_dir(),
+      configuration::instance().neb_db_secondary()
+          ? fs::storage_open_as_secondary
+          : fs::storage_open_for_readonly,
+      configuration::instance().neb_db_profile());
 
   auto *rs = neb::fs::storage_holder::instance().nbre_db_ptr();
+  jit_driver::instance().set_object_storage(rs);
   neb::block_height_t height = 1;
   try {
     auto tmp = rs->get(neb::configuration::instance().nbre_max_height_name());
@@ -21,54 +21,73 @@
 
 namespace neb {
 namespace fs {
-bc_storage_session::bc_storage_session() : m_storage(), m_mutex() {
-  m_storage = std::make_unique<rocksdb_storage>();
-  m_init_already = false;
-}
+bc_storage_session::bc_storage_session()
+    : m_storage(std::make_unique<rocksdb_storage>()), m_generation(0),
+      m_init_already(false) {}
 
-bc_storage_session::~bc_storage_session() {
-  boost::unique_lock<boost::shared_mutex> _l(m_mutex);
-  m_storage->close_database();
-}
+bc_storage_session::~bc_storage_session() {}
 
 void bc_storage_session::init(const std::string &path,
-                              enum storage_open_flag flag) {
-  boost::unique_lock<boost::shared_mutex> _l(m_mutex);
+                              enum storage_open_flag flag,
+                              const std::string &profile) {
+  std::unique_lock<std::mutex> _l(m_reopen_mutex);
   if (m_init_already)
     return;
   m_init_already = true;
   m_open_flag = flag;
   m_path = path;
-  m_storage->open_database(m_path, m_open_flag);
+  m_profile = profile;
+  auto rs = std::make_unique<rocksdb_storage>();
+  rs->open_database(m_path, m_open_flag, m_profile);
+  m_storage.exchange(std::move(rs));
 }
 
-bytes bc_storage_session::get_bytes(const bytes &key) {
-  boost::shared_lock<boost::shared_mutex> _l(m_mutex);
-  bool no_exception = true;
-  bool tried_already = false;
-  while (no_exception) {
-    if (tried_already) {
-      return m_storage->get_bytes(key);
-    } else {
-      try {
-        return m_storage->get_bytes(key);
-      } catch (...) {
-        tried_already = true;
-        _l.unlock();
-        m_mutex.lock();
-        m_storage->close_database();
-        m_storage->open_database(m_path, m_open_flag);
-        m_mutex.unlock();
-        _l.lock();
-      }
-    }
+void bc_storage_session::close() {
+  std::unique_lock<std::mutex> _l(m_reopen_mutex);
+  // the old one is closed once its readers are done
+  m_storage.exchange(std::make_unique<rocksdb_storage>());
+  m_init_already = false;
+  m_generation++;
+}
+
+void bc_storage_session::reopen(uint64_t generation) {
+  std::unique_lock<std::mutex> _l(m_reopen_mutex);
+  if (m_generation != generation) {
+    return;
   }
-  return bytes();
+  if (m_open_flag == storage_open_as_secondary) {
+    m_storage.read(
+        [](rocksdb_storage *rs) { rs->try_catch_up_with_primary(); });
+  } else if (m_open_flag == storage_open_for_readonly) {
+    // readers keep the old one until they are done, then it's closed
+    auto rs = std::make_unique<rocksdb_storage>();
+    rs->open_database(m_path, m_open_flag, m_profile);
+    m_storage.exchange(std::move(rs));
+  }
+  // a read-write db sees its own writes, nothing to reopen, just retry
+  m_generation++;
+}
+
+int &bc_storage_session::read_depth() {
+  static thread_local int depth = 0;
+  return depth;
+}
+
+bytes bc_storage_session::get_bytes(const bytes &key) {
+  return read_with_reopen([&key](rocksdb_storage *rs) {
+    return rs->get_bytes(key);
+  });
+}
+
+std::vector<bytes>
+bc_storage_session::multi_get_bytes(const std::vector<bytes> &keys) {
+  return read_with_reopen([&keys](rocksdb_storage *rs) {
+    return rs->multi_get_bytes(keys);
+  });
 }
 
 void bc_storage_session::put_bytes(const bytes &key, const bytes &val) {
-  boost::shared_lock<boost::shared_mutex> _l(m_mutex);
-  m_storage->put_bytes(key, val);
+  read([&key, &val](rocksdb_storage *rs) { rs->put_bytes(key, val); });
 }
 } // namespace fs
 } // namespace neb
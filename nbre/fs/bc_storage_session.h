@@ -22,6 +22,7 @@
 #include "common/common.h"
 #include "fs/rocksdb_storage.h"
 #include "fs/storage.h"
+#include "util/epoch_ptr.h"
 #include "util/singleton.h"
 
 namespace neb {
@@ -31,7 +32,12 @@ public:
   bc_storage_session();
   ~bc_storage_session();
 
-  void init(const std::string &path, enum storage_open_flag flag);
+  //! profile is a name of rocksdb_profiles, empty for the built-in options
+  void init(const std::string &path, enum storage_open_flag flag,
+            const std::string &profile = std::string());
+
+  //! close the db, the next init opens one again
+  void close();
 
   bytes get_bytes(const bytes &key);
 
@@ -43,6 +49,9 @@ public:
     return get_bytes(string_to_byte(key));
   }
 
+  //! values of keys in the same order, in one RocksDB MultiGet
+  std::vector<bytes> multi_get_bytes(const std::vector<bytes> &keys);
+
   inline std::string get_string(const bytes &key) {
     return byte_to_string(get_bytes(key));
   }
@@ -64,12 +73,52 @@ public:
     return put_bytes(string_to_byte(key), string_to_byte(value));
   }
 
+  //! what f puts through this session is written at once
+  template <typename Func> void batch_write(Func &&f) {
+    read([&f](rocksdb_storage *rs) { rs->batch_write(f); });
+  }
+
+protected:
+  //! reads don't lock, the live rocksdb_storage is behind an epoch_ptr
+  template <typename Func> auto read(Func &&f) -> decltype(f(nullptr)) {
+    read_depth_guard _g;
+    return m_storage.read(f);
+  }
+
+  //! a read-only db doesn't see what the primary wrote after it was opened,
+  //! catch up or reopen it and try again once if the read fails
+  template <typename Func>
+  auto read_with_reopen(Func &&f) -> decltype(f(nullptr)) {
+    uint64_t generation = m_generation;
+    try {
+      return read(f);
+    } catch (...) {
+      // a nested read would wait for its outer read in reopen()
+      if (read_depth() > 0) {
+        throw;
+      }
+      reopen(generation);
+    }
+    return read(f);
+  }
+
+  //! skip if another reader reopened since generation
+  void reopen(uint64_t generation);
+
+  struct read_depth_guard {
+    read_depth_guard() { read_depth()++; }
+    ~read_depth_guard() { read_depth()--; }
+  };
+  static int &read_depth();
+
 protected:
-  std::unique_ptr<rocksdb_storage> m_storage;
-  boost::shared_mutex m_mutex;
+  util::epoch_ptr<rocksdb_storage> m_storage;
+  std::mutex m_reopen_mutex;
+  std::atomic<uint64_t> m_generation;
   std::string m_path;
   bool m_init_already;
   enum storage_open_flag m_open_flag;
+  std::string m_profile;
 };
 } // namespace fs
 } // namespace neb
@@ -21,9 +21,171 @@
 #include "fs/blockchain.h"
 #include "common/byte.h"
 #include "fs/bc_storage_session.h"
+#include <algorithm>
+#include <ff/functionflow.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 
 namespace neb {
 namespace fs {
+
+block_cache::block_cache() : m_blocks(256), m_headers(1 << 16) {}
+
+block_cptr_t block_cache::get_block(const neb::bytes &hash) {
+  block_cptr_t ret;
+  if (m_blocks.get(hash, ret)) {
+    return ret;
+  }
+  neb::bytes block_bytes = bc_storage_session::instance().get_bytes(hash);
+  auto block = std::make_shared<corepb::Block>();
+  bool succ = block->ParseFromArray(block_bytes.value(), block_bytes.size());
+  if (!succ) {
+    throw std::runtime_error("parse block failed");
+  }
+  ret = block;
+  m_blocks.set(hash, ret);
+  return ret;
+}
+
+block_header_cptr_t block_cache::get_block_header(const neb::bytes &hash) {
+  block_header_cptr_t ret;
+  if (m_headers.get(hash, ret)) {
+    return ret;
+  }
+  // no need to count a block miss here
+  block_cptr_t block;
+  if (m_blocks.exists(hash) && m_blocks.get(hash, block)) {
+    ret = to_header(*block);
+  } else {
+    ret = parse_header(bc_storage_session::instance().get_bytes(hash));
+  }
+  m_headers.set(hash, ret);
+  return ret;
+}
+
+std::unique_ptr<block_header_t>
+block_cache::to_header(const corepb::Block &block) {
+  auto ret = std::make_unique<block_header_t>();
+  auto &header = block.header();
+  ret->m_height = block.height();
+  ret->m_timestamp = header.timestamp();
+  ret->m_hash = header.hash();
+  ret->m_state_root = header.state_root();
+  ret->m_txs_root = header.txs_root();
+  ret->m_events_root = header.events_root();
+  return ret;
+}
+
+std::unique_ptr<block_header_t>
+block_cache::parse_header(const neb::bytes &block_bytes) {
+  using google::protobuf::internal::WireFormatLite;
+
+  corepb::Block block;
+  google::protobuf::io::CodedInputStream input(block_bytes.value(),
+                                               block_bytes.size());
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    bool succ = true;
+    auto field = WireFormatLite::GetTagFieldNumber(tag);
+    if (field == corepb::Block::kHeaderFieldNumber) {
+      uint32_t len;
+      succ = input.ReadVarint32(&len);
+      if (succ) {
+        auto limit = input.PushLimit(len);
+        succ = block.mutable_header()->MergeFromCodedStream(&input) &&
+               input.ConsumedEntireMessage();
+        input.PopLimit(limit);
+      }
+    } else if (field == corepb::Block::kHeightFieldNumber) {
+      uint64_t height;
+      succ = input.ReadVarint64(&height);
+      block.set_height(height);
+    } else {
+      succ = WireFormatLite::SkipField(&input, tag);
+    }
+    if (!succ) {
+      throw std::runtime_error("parse block failed");
+    }
+  }
+  return to_header(block);
+}
+
+//! data type of a serialized transaction, the last one wins as in parsing
+static std::string tx_data_type(const byte_t *data, int size) {
+  using google::protobuf::internal::WireFormatLite;
+
+  std::string type;
+  google::protobuf::io::CodedInputStream input(data, size);
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    bool succ = true;
+    if (WireFormatLite::GetTagFieldNumber(tag) ==
+        corepb::Transaction::kDataFieldNumber) {
+      uint32_t len;
+      succ = input.ReadVarint32(&len);
+      if (succ) {
+        auto limit = input.PushLimit(len);
+        for (uint32_t t = input.ReadTag(); t != 0 && succ;
+             t = input.ReadTag()) {
+          if (WireFormatLite::GetTagFieldNumber(t) ==
+              corepb::Data::kTypeFieldNumber) {
+            succ = WireFormatLite::ReadString(&input, &type);
+          } else {
+            succ = WireFormatLite::SkipField(&input, t);
+          }
+        }
+        succ = succ && input.ConsumedEntireMessage();
+        input.PopLimit(limit);
+      }
+    } else {
+      succ = WireFormatLite::SkipField(&input, tag);
+    }
+    if (!succ) {
+      throw std::runtime_error("parse transaction failed");
+    }
+  }
+  return type;
+}
+
+std::vector<corepb::Transaction>
+block_cache::parse_txs_of_type(const neb::bytes &block_bytes,
+                               const std::string &type) {
+  using google::protobuf::internal::WireFormatLite;
+
+  std::vector<corepb::Transaction> ret;
+  // a transaction of type has type in its bytes, most blocks have none
+  if (!type.empty() &&
+      std::search(block_bytes.value(), block_bytes.value() + block_bytes.size(),
+                  type.begin(), type.end()) ==
+          block_bytes.value() + block_bytes.size()) {
+    return ret;
+  }
+
+  google::protobuf::io::CodedInputStream input(block_bytes.value(),
+                                               block_bytes.size());
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    bool succ = true;
+    if (WireFormatLite::GetTagFieldNumber(tag) ==
+        corepb::Block::kTransactionsFieldNumber) {
+      uint32_t len;
+      succ = input.ReadVarint32(&len) &&
+             input.CurrentPosition() + uint64_t(len) <= block_bytes.size();
+      if (succ) {
+        const byte_t *tx_bytes = block_bytes.value() + input.CurrentPosition();
+        if (tx_data_type(tx_bytes, len) == type) {
+          ret.emplace_back();
+          succ = ret.back().ParseFromArray(tx_bytes, len);
+        }
+        succ = succ && input.Skip(len);
+      }
+    } else {
+      succ = WireFormatLite::SkipField(&input, tag);
+    }
+    if (!succ) {
+      throw std::runtime_error("parse block failed");
+    }
+  }
+  return ret;
+}
+
 std::unique_ptr<corepb::Block> blockchain::load_LIB_block() {
   return load_block_with_tag_string(
       std::string(Block_LIB, std::allocator<char>()));
@@ -31,19 +193,55 @@ std::unique_ptr<corepb::Block> blockchain::load_LIB_block() {
 
 std::unique_ptr<corepb::Block>
 blockchain::load_block_with_height(block_height_t height) {
-  std::unique_ptr<corepb::Block> block = std::make_unique<corepb::Block>();
+  return std::make_unique<corepb::Block>(
+      *load_shared_block_with_height(height));
+}
+
+block_cptr_t blockchain::load_shared_block_with_height(block_height_t height) {
+  neb::bytes height_hash = bc_storage_session::instance().get_bytes(
+      neb::number_to_byte<neb::bytes>(height));
+  return block_cache::instance().get_block(height_hash);
+}
 
+block_header_cptr_t
+blockchain::load_block_header_with_height(block_height_t height) {
   neb::bytes height_hash = bc_storage_session::instance().get_bytes(
       neb::number_to_byte<neb::bytes>(height));
+  return block_cache::instance().get_block_header(height_hash);
+}
+
+std::vector<neb::bytes>
+blockchain::load_block_bytes_with_heights(block_height_t start_height,
+                                          block_height_t end_height) {
+  std::vector<neb::bytes> height_keys;
+  for (block_height_t h = start_height; h < end_height; h++) {
+    height_keys.push_back(neb::number_to_byte<neb::bytes>(h));
+  }
+  auto &session = bc_storage_session::instance();
+  return session.multi_get_bytes(session.multi_get_bytes(height_keys));
+}
 
-  neb::bytes block_bytes =
-      bc_storage_session::instance().get_bytes(height_hash);
+std::vector<std::vector<corepb::Transaction>>
+blockchain::load_txs_of_type_with_heights(block_height_t start_height,
+                                          block_height_t end_height,
+                                          const std::string &type) {
+  std::vector<neb::bytes> blocks_bytes =
+      load_block_bytes_with_heights(start_height, end_height);
 
-  bool ret = block->ParseFromArray(block_bytes.value(), block_bytes.size());
-  if (!ret) {
-    throw std::runtime_error("parse block failed");
+  std::vector<std::vector<corepb::Transaction>> ret(blocks_bytes.size());
+  auto parse = [&](size_t i) {
+    ret[i] = block_cache::parse_txs_of_type(blocks_bytes[i], type);
+  };
+  if (blocks_bytes.size() > 1 && ff::is_initialized()) {
+    ff::paragroup pg;
+    pg.for_each(static_cast<size_t>(0), blocks_bytes.size(), parse);
+    ff::ff_wait(ff::all(pg));
+  } else {
+    for (size_t i = 0; i < blocks_bytes.size(); i++) {
+      parse(i);
+    }
   }
-  return block;
+  return ret;
 }
 
 std::unique_ptr<corepb::Block>
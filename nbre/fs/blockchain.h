@@ -24,10 +24,64 @@
 #include "fs/bc_storage_session.h"
 #include "fs/proto/block.pb.h"
 #include "fs/rocksdb_storage.h"
+#include "util/sharded_lru_cache.h"
+#include "util/singleton.h"
 
 namespace neb {
 namespace fs {
 
+//! header fields of a block which are read by NBRE
+struct block_header_t {
+  block_height_t m_height;
+  int64_t m_timestamp;
+  std::string m_hash;
+  std::string m_state_root;
+  std::string m_txs_root;
+  std::string m_events_root;
+};
+
+typedef std::shared_ptr<const corepb::Block> block_cptr_t;
+typedef std::shared_ptr<const block_header_t> block_header_cptr_t;
+
+//! Parsed blocks and block headers keyed by block hash, hence a block of the
+//! same height on another fork is never served.
+class block_cache : public util::singleton<block_cache> {
+public:
+  block_cache();
+
+  block_cptr_t get_block(const neb::bytes &hash);
+  block_header_cptr_t get_block_header(const neb::bytes &hash);
+
+  inline void set_block_capacity(size_t capacity) {
+    m_blocks.set_capacity(capacity);
+  }
+  inline void set_header_capacity(size_t capacity) {
+    m_headers.set_capacity(capacity);
+  }
+  inline void clear() {
+    m_blocks.clear();
+    m_headers.clear();
+  }
+
+  inline uint64_t block_hits() const { return m_blocks.hits(); }
+  inline uint64_t block_misses() const { return m_blocks.misses(); }
+  inline uint64_t header_hits() const { return m_headers.hits(); }
+  inline uint64_t header_misses() const { return m_headers.misses(); }
+
+  static std::unique_ptr<block_header_t> to_header(const corepb::Block &block);
+  //! parse header and height only, transactions are skipped
+  static std::unique_ptr<block_header_t>
+  parse_header(const neb::bytes &block_bytes);
+  //! parse transactions which data type is type only, others are skipped
+  //! after reading their type, and a block without the type is skipped at all
+  static std::vector<corepb::Transaction>
+  parse_txs_of_type(const neb::bytes &block_bytes, const std::string &type);
+
+private:
+  util::sharded_lru_cache<neb::bytes, block_cptr_t> m_blocks;
+  util::sharded_lru_cache<neb::bytes, block_header_cptr_t> m_headers;
+};
+
 class blockchain {
 public:
   static constexpr char const *Block_LIB = "blockchain_lib";
@@ -37,6 +91,24 @@ public:
   static std::unique_ptr<corepb::Block>
   load_block_with_height(block_height_t height);
 
+  //! cached, prefer these if the block is not to be changed
+  static block_cptr_t load_shared_block_with_height(block_height_t height);
+  static block_header_cptr_t
+  load_block_header_with_height(block_height_t height);
+
+  //! serialized blocks [start_height, end_height), read by two MultiGet,
+  //! heights to hashes then hashes to blocks, bypassing block_cache
+  static std::vector<neb::bytes>
+  load_block_bytes_with_heights(block_height_t start_height,
+                                block_height_t end_height);
+
+  //! transactions of data type of blocks [start_height, end_height), blocks
+  //! are read by load_block_bytes_with_heights and parsed in parallel
+  static std::vector<std::vector<corepb::Transaction>>
+  load_txs_of_type_with_heights(block_height_t start_height,
+                                block_height_t end_height,
+                                const std::string &type);
+
   static void write_LIB_block(corepb::Block *block);
 
 private:
@@ -35,6 +35,18 @@ wei_t account_db::get_balance(const address_t &addr, block_height_t height) {
   return storage_to_wei(neb::string_to_byte(balance_str));
 }
 
+std::vector<wei_t>
+account_db::get_balances(const std::vector<address_t> &addrs,
+                         block_height_t height, bool parallel) {
+  auto accounts = m_blockchain->get_accounts_api(addrs, height, parallel);
+  std::vector<wei_t> ret;
+  for (auto &corepb_account_ptr : accounts) {
+    std::string balance_str = corepb_account_ptr->balance();
+    ret.push_back(storage_to_wei(neb::string_to_byte(balance_str)));
+  }
+  return ret;
+}
+
 address_t account_db::get_contract_deployer(const address_t &addr,
                                             block_height_t height) {
   auto corepb_account_ptr = m_blockchain->get_account_api(addr, height);
@@ -33,6 +33,9 @@ public:
   account_db(blockchain_api_base *blockchain_ptr);
 
   wei_t get_balance(const address_t &addr, block_height_t height);
+  //! the same as get_balance for each of addrs, but in one state trie walk
+  std::vector<wei_t> get_balances(const std::vector<address_t> &addrs,
+                                  block_height_t height, bool parallel = false);
   address_t get_contract_deployer(const address_t &address_t,
                                   block_height_t height);
 
@@ -24,12 +24,23 @@
 #include "fs/util.h"
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <ff/functionflow.h>
 
 namespace neb {
 namespace fs {
 
 blockchain_api_base::~blockchain_api_base() {}
 
+std::vector<std::unique_ptr<corepb::Account>>
+blockchain_api_base::get_accounts_api(const std::vector<address_t> &addrs,
+                                      block_height_t height, bool parallel) {
+  std::vector<std::unique_ptr<corepb::Account>> ret;
+  for (auto &addr : addrs) {
+    ret.push_back(get_account_api(addr, height));
+  }
+  return ret;
+}
+
 blockchain_api::blockchain_api() {}
 
 blockchain_api::~blockchain_api() {}
@@ -37,19 +48,30 @@ blockchain_api::~blockchain_api() {}
 std::unique_ptr<std::vector<transaction_info_t>>
 blockchain_api::get_block_transactions_api(block_height_t height) {
 
+  // special for  block height 1
+  if (height <= 1) {
+    return std::make_unique<std::vector<transaction_info_t>>();
+  }
+  auto block = blockchain::load_shared_block_with_height(height);
+  return get_transactions_of_block_api(*block);
+}
+
+std::unique_ptr<std::vector<transaction_info_t>>
+blockchain_api::get_transactions_of_block_api(const corepb::Block &block) {
+
   auto ret = std::make_unique<std::vector<transaction_info_t>>();
+  block_height_t height = block.height();
   // special for  block height 1
   if (height <= 1) {
     return ret;
   }
 
-  auto block = blockchain::load_block_with_height(height);
-  int64_t timestamp = block->header().timestamp();
+  int64_t timestamp = block.header().timestamp();
 
-  std::string events_root_str = block->header().events_root();
+  std::string events_root_str = block.header().events_root();
   neb::bytes events_root_bytes = neb::string_to_byte(events_root_str);
 
-  for (auto &tx : block->transactions()) {
+  for (auto &tx : block.transactions()) {
     transaction_info_t info;
 
     info.m_height = height;
@@ -126,16 +148,17 @@ blockchain_api::json_parse_event(const std::string &json) {
 std::unique_ptr<corepb::Account>
 blockchain_api::get_account_api(const address_t &addr, block_height_t height) {
 
-  auto block = blockchain::load_block_with_height(height);
+  auto header = blockchain::load_block_header_with_height(height);
 
   // get block header account state
-  std::string state_root_str = block->header().state_root();
+  std::string state_root_str = header->m_state_root;
   neb::bytes state_root_bytes = neb::string_to_byte(state_root_str);
 
   // get trie node
   trie t;
   neb::bytes trie_node_bytes;
-  bool is_found = t.get_trie_node(state_root_bytes, addr, trie_node_bytes);
+  bool is_found =
+      t.get_trie_node(state_root_bytes, addr.to_bytes(), trie_node_bytes);
   auto corepb_account_ptr = std::make_unique<corepb::Account>();
   if (!is_found) {
     corepb_account_ptr->set_address(std::to_string(addr));
@@ -151,16 +174,77 @@ blockchain_api::get_account_api(const address_t &addr, block_height_t height) {
   return corepb_account_ptr;
 }
 
+std::vector<std::unique_ptr<corepb::Account>>
+blockchain_api::get_accounts_api(const std::vector<address_t> &addrs,
+                                 block_height_t height, bool parallel) {
+
+  std::vector<std::unique_ptr<corepb::Account>> ret(addrs.size());
+  if (addrs.empty()) {
+    return ret;
+  }
+
+  auto header = blockchain::load_block_header_with_height(height);
+  neb::bytes state_root_bytes = neb::string_to_byte(header->m_state_root);
+
+  // sorted, so that addresses in the same chunk share more trie nodes
+  std::vector<size_t> order(addrs.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&addrs](size_t a, size_t b) { return addrs[a] < addrs[b]; });
+
+  // addresses begin with the same magic number, so split the sorted
+  // addresses into ranges instead of by the first nibble
+  size_t chunk_num = parallel ? std::min<size_t>(16, addrs.size()) : 1;
+  auto get_chunk = [&](size_t c) {
+    size_t begin = addrs.size() * c / chunk_num;
+    size_t end = addrs.size() * (c + 1) / chunk_num;
+    std::vector<neb::bytes> keys;
+    for (size_t k = begin; k < end; k++) {
+      keys.push_back(addrs[order[k]].to_bytes());
+    }
+
+    trie t;
+    std::vector<neb::bytes> trie_nodes;
+    auto found = t.get_trie_nodes(state_root_bytes, keys, trie_nodes);
+    for (size_t k = begin; k < end; k++) {
+      auto corepb_account_ptr = std::make_unique<corepb::Account>();
+      auto &trie_node_bytes = trie_nodes[k - begin];
+      if (!found[k - begin]) {
+        corepb_account_ptr->set_address(std::to_string(addrs[order[k]]));
+        corepb_account_ptr->set_balance(
+            std::to_string(neb::wei_to_storage(0)));
+      } else if (!corepb_account_ptr->ParseFromArray(trie_node_bytes.value(),
+                                                      trie_node_bytes.size())) {
+        throw std::runtime_error("parse corepb Account failed");
+      }
+      ret[order[k]] = std::move(corepb_account_ptr);
+    }
+  };
+
+  if (chunk_num > 1 && ff::is_initialized()) {
+    ff::paragroup pg;
+    pg.for_each(static_cast<size_t>(0), chunk_num, get_chunk);
+    ff::ff_wait(ff::all(pg));
+  } else {
+    for (size_t c = 0; c < chunk_num; c++) {
+      get_chunk(c);
+    }
+  }
+  return ret;
+}
+
 std::unique_ptr<corepb::Transaction>
 blockchain_api::get_transaction_api(const std::string &tx_hash,
                                     block_height_t height) {
   auto corepb_txs_ptr = std::make_unique<corepb::Transaction>();
 
   // suppose height is the latest block height
-  auto block = blockchain::load_block_with_height(height);
+  auto header = blockchain::load_block_header_with_height(height);
 
   // get block header transaction root
-  std::string txs_root_str = block->header().txs_root();
+  std::string txs_root_str = header->m_txs_root;
   neb::bytes txs_root_bytes = neb::string_to_byte(txs_root_str);
 
   // get trie node
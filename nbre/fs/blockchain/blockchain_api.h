@@ -57,6 +57,12 @@ public:
   get_account_api(const address_t &addr, block_height_t height) = 0;
   virtual std::unique_ptr<corepb::Transaction>
   get_transaction_api(const std::string &tx_hash, block_height_t height) = 0;
+
+  //! accounts of addrs at the same height, the default calls get_account_api
+  //! for each
+  virtual std::vector<std::unique_ptr<corepb::Account>>
+  get_accounts_api(const std::vector<address_t> &addrs, block_height_t height,
+                   bool parallel);
 };
 
 class blockchain_api : public blockchain_api_base {
@@ -66,12 +72,20 @@ public:
 
   virtual std::unique_ptr<std::vector<transaction_info_t>>
   get_block_transactions_api(block_height_t height);
+  //! as get_block_transactions_api, of a block read already
+  std::unique_ptr<std::vector<transaction_info_t>>
+  get_transactions_of_block_api(const corepb::Block &block);
 
   virtual std::unique_ptr<corepb::Account>
   get_account_api(const address_t &addr, block_height_t height);
   virtual std::unique_ptr<corepb::Transaction>
   get_transaction_api(const std::string &tx_hash, block_height_t height);
 
+  //! load the block once and look up all addrs in one state trie walk
+  virtual std::vector<std::unique_ptr<corepb::Account>>
+  get_accounts_api(const std::vector<address_t> &addrs, block_height_t height,
+                   bool parallel);
+
 private:
   std::unique_ptr<event_info_t>
   get_transaction_result_api(const neb::bytes &events_root,
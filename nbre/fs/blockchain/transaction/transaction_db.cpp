@@ -23,8 +23,13 @@
 namespace neb {
 namespace fs {
 
-transaction_db::transaction_db(blockchain_api_base *blockchain_ptr)
-    : m_blockchain(blockchain_ptr) {}
+transaction_db::transaction_db(blockchain_api_base *blockchain_ptr,
+                               rocksdb_storage *index_storage)
+    : m_blockchain(blockchain_ptr) {
+  if (index_storage) {
+    m_index = std::make_unique<transaction_index>(index_storage);
+  }
+}
 
 std::unique_ptr<std::vector<transaction_info_t>>
 transaction_db::read_transactions_from_db_with_duration(
@@ -32,9 +37,35 @@ transaction_db::read_transactions_from_db_with_duration(
 
   auto ret = std::make_unique<std::vector<transaction_info_t>>();
 
-  for (block_height_t h = start_block; h < end_block; h++) {
+  if (!m_index) {
+    for (block_height_t h = start_block; h < end_block; h++) {
+      auto tmp = m_blockchain->get_block_transactions_api(h);
+      ret->insert(ret->end(), tmp->begin(), tmp->end());
+    }
+    return ret;
+  }
+
+  block_height_t max_indexable = m_index->max_indexable_height();
+  block_height_t next = start_block;
+  auto read_from_blockchain = [this, &ret, max_indexable](block_height_t h) {
     auto tmp = m_blockchain->get_block_transactions_api(h);
+    if (h <= max_indexable) {
+      m_index->put_block_transactions(h, *tmp);
+    }
     ret->insert(ret->end(), tmp->begin(), tmp->end());
+  };
+
+  m_index->scan_block_transactions(
+      start_block, end_block,
+      [&](block_height_t height, std::vector<transaction_info_t> &txs) {
+        for (; next < height; next++) {
+          read_from_blockchain(next);
+        }
+        ret->insert(ret->end(), txs.begin(), txs.end());
+        next = height + 1;
+      });
+  for (; next < end_block; next++) {
+    read_from_blockchain(next);
   }
   return ret;
 }
@@ -46,10 +77,7 @@ transaction_db::read_transactions_with_address_type(
 
   auto ret = std::make_unique<std::vector<transaction_info_t>>();
   for (auto &tx : txs) {
-    neb::bytes from_bytes = tx.m_from;
-    neb::bytes to_bytes = tx.m_to;
-
-    if (from_bytes[1] == from_type && to_bytes[1] == to_type) {
+    if (tx.m_from[1] == from_type && tx.m_to[1] == to_type) {
       ret->push_back(tx);
     }
   }
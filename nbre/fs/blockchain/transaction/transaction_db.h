@@ -21,13 +21,17 @@
 #pragma once
 
 #include "fs/blockchain/blockchain_api.h"
+#include "fs/blockchain/transaction/transaction_index.h"
 
 namespace neb {
 namespace fs {
 
 class transaction_db {
 public:
-  transaction_db(blockchain_api_base *blockchain_ptr);
+  //! if index_storage is not null, transactions are read from
+  //! transaction_index first, missing blocks are read from blockchain
+  transaction_db(blockchain_api_base *blockchain_ptr,
+                 rocksdb_storage *index_storage = nullptr);
 
   std::unique_ptr<std::vector<transaction_info_t>>
   read_transactions_from_db_with_duration(block_height_t start_block,
@@ -40,6 +44,7 @@ public:
 
 private:
   blockchain_api_base *m_blockchain;
+  std::unique_ptr<transaction_index> m_index;
 };
 } // namespace fs
 } // namespace neb
@@ -0,0 +1,185 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "fs/blockchain/transaction/transaction_index.h"
+#include "common/nebulas_currency.h"
+#include "fs/ir_manager/ir_manager_helper.h"
+
+namespace neb {
+namespace fs {
+
+namespace internal {
+const byte_t tx_index_format_version = 1;
+const size_t wei_storage_len = 16;
+
+class record_writer {
+public:
+  template <typename T> void write_number(T v) {
+    m_buf.append_bytes(number_to_byte<bytes>(v));
+  }
+  template <typename BytesType> void write_bytes(const BytesType &v) {
+    write_number<uint32_t>(v.size());
+    m_buf.append_bytes(v.value(), v.size());
+  }
+  void write_wei(const wei_t &v) { m_buf.append_bytes(wei_to_storage(v)); }
+
+  bytes &buf() { return m_buf; }
+
+private:
+  bytes m_buf;
+};
+
+class record_reader {
+public:
+  record_reader(const bytes &buf) : m_buf(buf), m_pos(0) {}
+
+  template <typename T> T read_number() {
+    check(sizeof(T));
+    T v = byte_to_number<T>(const_cast<byte_t *>(m_buf.value()) + m_pos,
+                            sizeof(T));
+    m_pos += sizeof(T);
+    return v;
+  }
+  bytes read_bytes() {
+    uint32_t len = read_number<uint32_t>();
+    check(len);
+    bytes v(m_buf.value() + m_pos, len);
+    m_pos += len;
+    return v;
+  }
+  wei_t read_wei() {
+    check(wei_storage_len);
+    bytes v(m_buf.value() + m_pos, wei_storage_len);
+    m_pos += wei_storage_len;
+    return storage_to_wei(v);
+  }
+
+private:
+  void check(size_t len) {
+    if (m_pos + len > m_buf.size()) {
+      throw std::invalid_argument("invalid transaction index record");
+    }
+  }
+
+  const bytes &m_buf;
+  size_t m_pos;
+};
+} // namespace internal
+
+transaction_index::transaction_index(rocksdb_storage *storage)
+    : m_storage(storage) {}
+
+block_height_t transaction_index::max_indexable_height() {
+  return ir_manager_helper::nbre_block_height(m_storage);
+}
+
+void transaction_index::index_block(block_height_t height,
+                                    blockchain_api_base *blockchain_ptr) {
+  auto txs = blockchain_ptr->get_block_transactions_api(height);
+  put_block_transactions(height, *txs);
+}
+
+void transaction_index::put_block_transactions(
+    block_height_t height, const std::vector<transaction_info_t> &txs) {
+  m_storage->put_bytes(height_to_key(height), encode_transactions(txs));
+}
+
+bool transaction_index::get_block_transactions(
+    block_height_t height, std::vector<transaction_info_t> &txs) {
+  bytes record;
+  try {
+    record = m_storage->get_bytes(height_to_key(height));
+  } catch (const storage_general_failure &e) {
+    return false;
+  }
+  decode_transactions(record, height, txs);
+  return true;
+}
+
+void transaction_index::scan_block_transactions(
+    block_height_t start_block, block_height_t end_block,
+    const std::function<void(block_height_t height,
+                             std::vector<transaction_info_t> &txs)> &cb) {
+  if (start_block >= end_block) {
+    return;
+  }
+  size_t prefix_len = std::strlen(key_prefix);
+  m_storage->scan(
+      height_to_key(start_block), height_to_key(end_block),
+      [&cb, prefix_len](const bytes &key, const bytes &val) {
+        block_height_t height = byte_to_number<block_height_t>(
+            const_cast<byte_t *>(key.value()) + prefix_len,
+            key.size() - prefix_len);
+        std::vector<transaction_info_t> txs;
+        decode_transactions(val, height, txs);
+        cb(height, txs);
+      });
+}
+
+bytes transaction_index::height_to_key(block_height_t height) {
+  bytes key = string_to_byte(key_prefix);
+  key.append_bytes(number_to_byte<bytes>(height));
+  return key;
+}
+
+bytes transaction_index::encode_transactions(
+    const std::vector<transaction_info_t> &txs) {
+  internal::record_writer w;
+  w.write_number<byte_t>(internal::tx_index_format_version);
+  w.write_number<uint32_t>(txs.size());
+  for (auto &tx : txs) {
+    w.write_number<int32_t>(tx.m_status);
+    w.write_number<int64_t>(tx.m_timestamp);
+    w.write_bytes(tx.m_from);
+    w.write_bytes(tx.m_to);
+    w.write_bytes(string_to_byte(tx.m_tx_type));
+    w.write_wei(tx.m_tx_value);
+    w.write_wei(tx.m_gas_used);
+    w.write_wei(tx.m_gas_price);
+  }
+  return w.buf();
+}
+
+void transaction_index::decode_transactions(
+    const bytes &record, block_height_t height,
+    std::vector<transaction_info_t> &txs) {
+  internal::record_reader r(record);
+  if (r.read_number<byte_t>() != internal::tx_index_format_version) {
+    throw std::invalid_argument("unsupported transaction index record");
+  }
+  uint32_t n = r.read_number<uint32_t>();
+  txs.reserve(txs.size() + n);
+  for (uint32_t i = 0; i < n; i++) {
+    transaction_info_t tx;
+    tx.m_height = height;
+    tx.m_status = r.read_number<int32_t>();
+    tx.m_timestamp = r.read_number<int64_t>();
+    tx.m_from = r.read_bytes();
+    tx.m_to = r.read_bytes();
+    tx.m_tx_type = byte_to_string(r.read_bytes());
+    tx.m_tx_value = r.read_wei();
+    tx.m_gas_used = r.read_wei();
+    tx.m_gas_price = r.read_wei();
+    txs.push_back(tx);
+  }
+}
+
+} // namespace fs
+} // namespace neb
@@ -0,0 +1,71 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include "fs/blockchain/blockchain_api.h"
+#include "fs/rocksdb_storage.h"
+
+namespace neb {
+namespace fs {
+
+//! NBRE side index of the successful transactions of each LIB block, as
+//! returned by blockchain_api::get_block_transactions_api, so that reading
+//! transactions needs neither the events trie nor JSON parsing.
+//!
+//! Key is a prefix followed by the big endian height, hence a height range is
+//! a key range. Value is a compact binary record of the block, empty blocks
+//! are indexed too.
+class transaction_index {
+public:
+  static constexpr char const *key_prefix = "tx_index_";
+
+  transaction_index(rocksdb_storage *storage);
+
+  //! Index blocks which are irreversible only, i.e. not above the height NBRE
+  //! has parsed.
+  block_height_t max_indexable_height();
+
+  void index_block(block_height_t height, blockchain_api_base *blockchain_ptr);
+
+  void put_block_transactions(block_height_t height,
+                              const std::vector<transaction_info_t> &txs);
+
+  bool get_block_transactions(block_height_t height,
+                              std::vector<transaction_info_t> &txs);
+
+  //! Scan indexed blocks in [start_block, end_block), cb is called in height
+  //! order for each indexed block.
+  void scan_block_transactions(
+      block_height_t start_block, block_height_t end_block,
+      const std::function<void(block_height_t height,
+                               std::vector<transaction_info_t> &txs)> &cb);
+
+  static bytes height_to_key(block_height_t height);
+
+  static bytes encode_transactions(const std::vector<transaction_info_t> &txs);
+  static void decode_transactions(const bytes &record, block_height_t height,
+                                  std::vector<transaction_info_t> &txs);
+
+private:
+  rocksdb_storage *m_storage;
+};
+} // namespace fs
+} // namespace neb
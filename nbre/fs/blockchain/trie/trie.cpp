@@ -19,6 +19,7 @@
 //
 
 #include "fs/blockchain/trie/trie.h"
+#include "common/configuration.h"
 #include "fs/bc_storage_session.h"
 #include <exception>
 
@@ -44,7 +45,7 @@ trie_node::trie_node(const neb::bytes &triepb_bytes) {
 
 trie_node::trie_node(const std::vector<neb::bytes> &val) : m_val(val) {}
 
-trie_node_type trie_node::get_trie_node_type() {
+trie_node_type trie_node::get_trie_node_type() const {
 
   if (m_val.size() == 16) {
     return trie_node_branch;
@@ -89,6 +90,20 @@ std::unique_ptr<triepb::Node> trie_node::to_proto() const {
   return ret;
 }
 
+trie_node_cache::trie_node_cache()
+    : m_cache(configuration::instance().trie_node_cache_size()) {}
+
+trie_node_cptr trie_node_cache::fetch_node(const neb::bytes &hash) {
+  trie_node_cptr ret;
+  if (m_cache.get(hash, ret)) {
+    return ret;
+  }
+  neb::bytes triepb_bytes = bc_storage_session::instance().get_bytes(hash);
+  ret = std::make_shared<const trie_node>(triepb_bytes);
+  m_cache.set(hash, ret);
+  return ret;
+}
+
 trie::trie(const hash_t &hash) : m_root_hash(hash) {}
 
 trie::trie() {}
@@ -115,7 +130,11 @@ void trie::commit_node(trie_node *node) {
 }
 
 hash_t trie::put(const hash_t &key, const neb::bytes &val) {
-  auto new_hash = update(m_root_hash, key_to_route(key), val);
+  // update() never reads back the nodes it commits, so they can be written in
+  // one batch
+  hash_t new_hash;
+  bc_storage_session::instance().batch_write(
+      [&]() { new_hash = update(m_root_hash, key_to_route(key), val); });
   m_root_hash = new_hash;
   return new_hash;
 }
@@ -264,14 +283,13 @@ hash_t trie::update_when_meet_leaf(trie_node *root_node,
 }
 
 std::unique_ptr<trie_node> trie::fetch_node(const hash_t &hash) {
-  neb::bytes triepb_bytes =
-      bc_storage_session::instance().get_bytes(from_fix_bytes(hash));
-  return std::make_unique<trie_node>(triepb_bytes);
+  return fetch_node(from_fix_bytes(hash));
 }
 
 std::unique_ptr<trie_node> trie::fetch_node(const neb::bytes &hash) {
-  neb::bytes triepb_bytes = bc_storage_session::instance().get_bytes(hash);
-  return std::make_unique<trie_node>(triepb_bytes);
+  // a copy, callers may change it
+  return std::make_unique<trie_node>(
+      *trie_node_cache::instance().fetch_node(hash));
 }
 
 bool trie::get_trie_node(const neb::bytes &root_hash, const neb::bytes &key,
@@ -287,7 +305,7 @@ bool trie::get_trie_node(const neb::bytes &root_hash, const neb::bytes &key,
 
     while (route_ptr <= end_ptr) {
 
-      auto root_node = fetch_node(hash);
+      auto root_node = trie_node_cache::instance().fetch_node(hash);
       auto root_type = root_node->get_trie_node_type();
       if (route_ptr == end_ptr && root_type != trie_node_leaf) {
         throw std::runtime_error("key/path too short");
@@ -330,6 +348,84 @@ bool trie::get_trie_node(const neb::bytes &root_hash, const neb::bytes &key,
   throw std::runtime_error("key path not found");
 }
 
+std::vector<bool> trie::get_trie_nodes(const neb::bytes &root_hash,
+                                       const std::vector<neb::bytes> &keys,
+                                       std::vector<neb::bytes> &trie_nodes) {
+  std::vector<bool> found(keys.size(), false);
+  trie_nodes.clear();
+  trie_nodes.resize(keys.size());
+
+  std::vector<neb::bytes> routes;
+  std::vector<size_t> indexes;
+  for (size_t i = 0; i < keys.size(); i++) {
+    routes.push_back(key_to_route(keys[i]));
+    indexes.push_back(i);
+  }
+  if (!indexes.empty()) {
+    get_trie_nodes(root_hash, 0, routes, indexes, found, trie_nodes);
+  }
+  return found;
+}
+
+void trie::get_trie_nodes(const neb::bytes &hash, size_t depth,
+                          const std::vector<neb::bytes> &routes,
+                          const std::vector<size_t> &indexes,
+                          std::vector<bool> &found,
+                          std::vector<neb::bytes> &trie_nodes) {
+  // the same as get_trie_node, for keys sharing route[0, depth)
+  trie_node_cptr root_node;
+  try {
+    root_node = trie_node_cache::instance().fetch_node(hash);
+  } catch (const std::exception &e) {
+    return;
+  }
+  auto root_type = root_node->get_trie_node_type();
+
+  if (root_type == trie_node_branch) {
+    std::vector<size_t> children[16];
+    for (size_t i : indexes) {
+      if (routes[i].size() > depth) {
+        children[routes[i][depth]].push_back(i);
+      }
+    }
+    for (size_t c = 0; c < 16; c++) {
+      if (!children[c].empty()) {
+        get_trie_nodes(root_node->val_at(c), depth + 1, routes, children[c],
+                       found, trie_nodes);
+      }
+    }
+  } else if (root_type == trie_node_extension) {
+    auto &key_path = root_node->val_at(1);
+    std::vector<size_t> next;
+    for (size_t i : indexes) {
+      size_t left_size = routes[i].size() - depth;
+      if (left_size == 0) {
+        continue;
+      }
+      size_t matched_len =
+          prefix_len(key_path, routes[i].value() + depth, left_size);
+      if (matched_len == key_path.size()) {
+        next.push_back(i);
+      }
+    }
+    if (!next.empty()) {
+      get_trie_nodes(root_node->val_at(2), depth + key_path.size(), routes,
+                     next, found, trie_nodes);
+    }
+  } else if (root_type == trie_node_leaf) {
+    auto &key_path = root_node->val_at(1);
+    for (size_t i : indexes) {
+      size_t left_size = routes[i].size() - depth;
+      size_t matched_len =
+          prefix_len(key_path, routes[i].value() + depth, left_size);
+      if (matched_len == key_path.size() && matched_len == left_size) {
+        found[i] = true;
+        trie_nodes[i] = root_node->val_at(2);
+      }
+    }
+  }
+}
+
 neb::bytes trie::route_to_key(const neb::bytes &route) {
 
   size_t size = route.size() >> 1;
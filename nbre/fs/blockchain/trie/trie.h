@@ -25,6 +25,8 @@
 #include "fs/blockchain/trie/byte_shared.h"
 #include "fs/proto/trie.pb.h"
 #include "fs/rocksdb_storage.h"
+#include "util/sharded_lru_cache.h"
+#include "util/singleton.h"
 
 namespace neb {
 namespace fs {
@@ -42,7 +44,7 @@ public:
 
   trie_node(const std::vector<neb::bytes> &val);
 
-  trie_node_type get_trie_node_type();
+  trie_node_type get_trie_node_type() const;
 
   inline const neb::bytes &val_at(size_t index) const { return m_val[index]; }
   inline neb::bytes &val_at(size_t index) { return m_val[index]; }
@@ -61,6 +63,27 @@ private:
 };
 
 typedef std::unique_ptr<trie_node> trie_node_ptr;
+typedef std::shared_ptr<const trie_node> trie_node_cptr;
+
+//! Decoded trie nodes keyed by node hash. A node's hash is the hash of its
+//! content, so a cached node never goes stale. Holds up to
+//! configuration::trie_node_cache_size() nodes.
+class trie_node_cache : public util::singleton<trie_node_cache> {
+public:
+  trie_node_cache();
+
+  trie_node_cptr fetch_node(const neb::bytes &hash);
+
+  inline void set_capacity(size_t capacity) { m_cache.set_capacity(capacity); }
+  inline size_t capacity() const { return m_cache.capacity(); }
+  inline size_t size() const { return m_cache.size(); }
+  inline void clear() { m_cache.clear(); }
+  inline uint64_t hits() const { return m_cache.hits(); }
+  inline uint64_t misses() const { return m_cache.misses(); }
+
+private:
+  util::sharded_lru_cache<neb::bytes, trie_node_cptr> m_cache;
+};
 
 class trie {
 public:
@@ -70,6 +93,13 @@ public:
   bool get_trie_node(const neb::bytes &root_hash, const neb::bytes &key,
                      neb::bytes &trie_node);
 
+  //! Look up keys under the same root at once, nodes on a common route prefix
+  //! are visited once. Returns whether each key is found, its value is in
+  //! trie_nodes at the same index.
+  std::vector<bool> get_trie_nodes(const neb::bytes &root_hash,
+                                   const std::vector<neb::bytes> &keys,
+                                   std::vector<neb::bytes> &trie_nodes);
+
   hash_t put(const hash_t &key, const neb::bytes &val);
 
   trie_node_ptr create_node(const std::vector<neb::bytes> &val);
@@ -84,6 +114,12 @@ private:
   std::unique_ptr<trie_node> fetch_node(const neb::bytes &hash);
   std::unique_ptr<trie_node> fetch_node(const hash_t &hash);
 
+  void get_trie_nodes(const neb::bytes &hash, size_t depth,
+                      const std::vector<neb::bytes> &routes,
+                      const std::vector<size_t> &indexes,
+                      std::vector<bool> &found,
+                      std::vector<neb::bytes> &trie_nodes);
+
   hash_t update(const hash_t &root, const neb::bytes &route,
                 const neb::bytes &val);
 
@@ -24,6 +24,8 @@
 #include "common/configuration.h"
 #include "common/version.h"
 #include "fs/bc_storage_session.h"
+#include "fs/blockchain.h"
+#include "fs/blockchain/transaction/transaction_index.h"
 #include "fs/ir_manager/api/ir_api.h"
 #include "fs/ir_manager/ir_manager_helper.h"
 #include "fs/storage_holder.h"
@@ -34,11 +36,12 @@
 #include "util/json_parser.h"
 #include <boost/format.hpp>
 #include <ff/functionflow.h>
+#include <future>
 
 namespace neb {
 namespace fs {
 
-ir_manager::ir_manager() {
+ir_manager::ir_manager() : m_ir_closures(64), m_ir_closures_generation(0) {
   m_storage = storage_holder::instance().nbre_db_ptr();
 }
 
@@ -73,6 +76,12 @@ ir_manager::read_irs(const std::string &name, block_height_t height,
   return irs;
 }
 
+static std::string ir_key(const std::string &name, version_t version) {
+  std::stringstream ss;
+  ss << name << version;
+  return ss.str();
+}
+
 void ir_manager::read_ir_depends(const std::string &name, version_t version,
                                  block_height_t height, bool depends,
                                  std::vector<nbre::NBREIR> &irs) {
@@ -82,42 +91,106 @@ void ir_manager::read_ir_depends(const std::string &name, version_t version,
     throw std::runtime_error("need to update nbre runtime version");
   }
 
-  std::unique_ptr<nbre::NBREIR> nbre_ir = std::make_unique<nbre::NBREIR>();
+  ir_closure_ptr_t closure = read_ir_closure(name, version);
   std::unordered_set<std::string> ir_set;
-  std::queue<std::pair<std::string, version_t>> q;
-  q.push(std::make_pair(name, version));
+  std::queue<std::string> q;
+  q.push(ir_key(name, version));
 
   while (!q.empty()) {
-    auto &ele = q.front();
+    std::string key = q.front();
     q.pop();
-    std::stringstream ss;
-    ss << ele.first << ele.second;
 
-    if (ir_set.find(ss.str()) == ir_set.end()) {
-      ir_set.insert(ss.str());
-      neb::bytes nbre_bytes;
-      try {
-        nbre_bytes = m_storage->get(ss.str());
-      } catch (const std::exception &e) {
-        LOG(INFO) << "get ir " << ele.first << " failed " << e.what();
+    if (ir_set.find(key) == ir_set.end()) {
+      ir_set.insert(key);
+      const ir_node_t &node = closure->at(key);
+      if (!node.m_exists) {
         return;
       }
-
-      bool ret = nbre_ir->ParseFromArray(nbre_bytes.value(), nbre_bytes.size());
-      if (!ret) {
+      if (!node.m_parsed) {
         throw std::runtime_error("parse nbre failed");
       }
 
-      if (nbre_ir->height() <= height) {
+      if (node.m_ir.height() <= height) {
         if (depends) {
-          for (auto &deps : nbre_ir->depends()) {
-            q.push(std::make_pair(deps.name(), deps.version()));
+          for (auto &deps : node.m_ir.depends()) {
+            q.push(ir_key(deps.name(), deps.version()));
           }
         }
-        irs.push_back(*nbre_ir);
+        irs.push_back(node.m_ir);
+      }
+    }
+  }
+}
+
+ir_manager::ir_closure_ptr_t
+ir_manager::read_ir_closure(const std::string &name, version_t version) {
+  std::string root = ir_key(name, version);
+  ir_closure_ptr_t ret;
+  if (m_ir_closures.get(root, ret)) {
+    return ret;
+  }
+
+  uint64_t generation = m_ir_closures_generation;
+  auto closure = std::make_shared<ir_closure_t>();
+  bool complete = true;
+  std::vector<std::string> level;
+  level.push_back(root);
+
+  while (!level.empty()) {
+    std::vector<ir_node_t> nodes(level.size());
+    auto read = [this, &level, &nodes](size_t i) {
+      neb::bytes nbre_bytes;
+      try {
+        nbre_bytes = m_storage->get(level[i]);
+      } catch (const std::exception &e) {
+        LOG(INFO) << "get ir " << level[i] << " failed " << e.what();
+        return;
+      }
+      nodes[i].m_exists = true;
+      nodes[i].m_parsed =
+          nodes[i].m_ir.ParseFromArray(nbre_bytes.value(), nbre_bytes.size());
+    };
+    if (level.size() > 1 && ff::is_initialized()) {
+      ff::paragroup pg;
+      pg.for_each(static_cast<size_t>(0), level.size(), read);
+      ff::ff_wait(ff::all(pg));
+    } else {
+      for (size_t i = 0; i < level.size(); i++) {
+        read(i);
+      }
+    }
+
+    for (size_t i = 0; i < level.size(); i++) {
+      complete = complete && nodes[i].m_exists;
+      closure->insert(std::make_pair(level[i], std::move(nodes[i])));
+    }
+    std::vector<std::string> next;
+    for (auto &key : level) {
+      const ir_node_t &node = closure->at(key);
+      if (!node.m_parsed) {
+        continue;
+      }
+      for (auto &deps : node.m_ir.depends()) {
+        std::string dep_key = ir_key(deps.name(), deps.version());
+        if (closure->find(dep_key) == closure->end() &&
+            std::find(next.begin(), next.end(), dep_key) == next.end()) {
+          next.push_back(dep_key);
+        }
       }
     }
+    level.swap(next);
+  }
+
+  //! one with a missing IR is read again, the IR may be deployed by then
+  if (complete && generation == m_ir_closures_generation) {
+    m_ir_closures.set(root, closure);
   }
+  return closure;
+}
+
+void ir_manager::invalidate_ir_closures() {
+  m_ir_closures_generation++;
+  m_ir_closures.clear();
 }
 
 void ir_manager::parse_irs(
@@ -146,22 +219,72 @@ void ir_manager::parse_irs(
   }
 }
 
+std::vector<ir_manager::prefetched_block_t>
+ir_manager::prefetch_blocks(block_height_t start_height,
+                            block_height_t end_height,
+                            const std::string &ir_tx_type, bool index) {
+  std::vector<prefetched_block_t> ret(end_height - start_height);
+  if (!index) {
+    auto txs_of_blocks = blockchain::load_txs_of_type_with_heights(
+        start_height, end_height, ir_tx_type);
+    for (size_t i = 0; i < ret.size(); i++) {
+      ret[i].m_ir_txs = std::move(txs_of_blocks[i]);
+    }
+    return ret;
+  }
+
+  auto blocks_bytes =
+      blockchain::load_block_bytes_with_heights(start_height, end_height);
+  auto parse = [&](size_t i) {
+    corepb::Block block;
+    if (!block.ParseFromArray(blocks_bytes[i].value(),
+                              blocks_bytes[i].size())) {
+      throw std::runtime_error("parse block failed");
+    }
+    for (auto &tx : block.transactions()) {
+      if (tx.data().type() == ir_tx_type) {
+        ret[i].m_ir_txs.push_back(tx);
+      }
+    }
+    blockchain_api ba;
+    ret[i].m_txs = ba.get_transactions_of_block_api(block);
+  };
+  if (ret.size() > 1 && ff::is_initialized()) {
+    ff::paragroup pg;
+    pg.for_each(static_cast<size_t>(0), ret.size(), parse);
+    ff::ff_wait(ff::all(pg));
+  } else {
+    for (size_t i = 0; i < ret.size(); i++) {
+      parse(i);
+    }
+  }
+  return ret;
+}
+
 void ir_manager::parse_when_missing_block(block_height_t start_height,
                                           block_height_t end_height) {
   std::string ir_tx_type = neb::configuration::instance().ir_tx_payload_type();
-
-  for (block_height_t h = start_height; h < end_height; h++) {
-    auto block = blockchain::load_block_with_height(h);
-    std::vector<corepb::Transaction> txs;
-
-    for (auto &tx : block->transactions()) {
-      auto &data = tx.data();
-      const std::string &type = data.type();
-      if (type == ir_tx_type) {
-        txs.push_back(tx);
-      }
+  block_height_t window = std::max<block_height_t>(
+      neb::configuration::instance().block_prefetch_window(), 1);
+  bool index = neb::configuration::instance().index_txs_on_parse() &&
+               !neb::use_test_blockchain;
+  auto read = [ir_tx_type, end_height, window, index](block_height_t from) {
+    return prefetch_blocks(from, std::min(end_height, from + window),
+                           ir_tx_type, index);
+  };
+
+  // the next window is read while blocks of this one are parsed in order
+  auto next = std::async(std::launch::async, read, start_height);
+  for (block_height_t h = start_height; h < end_height;) {
+    auto blocks = next.get();
+    block_height_t to = h + blocks.size();
+    if (to < end_height) {
+      next = std::async(std::launch::async, read, to);
+    }
+    for (auto &block : blocks) {
+      parse_with_height(h, block.m_ir_txs, block.m_txs.get());
+      h++;
     }
-    parse_with_height(h, txs);
   }
 }
 
@@ -169,7 +292,7 @@ void ir_manager::parse_next_block(block_height_t height,
                                   const std::vector<std::string> &txs_seri) {
   std::vector<corepb::Transaction> txs;
   if (txs_seri.empty()) {
-    parse_with_height(height, txs);
+    parse_with_height(height, txs, nullptr);
     return;
   }
 
@@ -183,11 +306,12 @@ void ir_manager::parse_next_block(block_height_t height,
     }
     txs.push_back(*tx);
   }
-  parse_with_height(height, txs);
+  parse_with_height(height, txs, nullptr);
 }
 
 void ir_manager::parse_with_height(
-    block_height_t height, const std::vector<corepb::Transaction> &txs) {
+    block_height_t height, const std::vector<corepb::Transaction> &txs,
+    const std::vector<transaction_info_t> *txs_to_index) {
 
   std::string failed_flag =
       neb::configuration::instance().nbre_failed_flag_name();
@@ -202,6 +326,20 @@ void ir_manager::parse_with_height(
       neb::number_to_byte<neb::bytes>(height));
   ir_manager_helper::del_failed_flag(m_storage, failed_flag);
 
+  // index transactions of the LIB block, the record of a block is written at
+  // once, so a failure leaves no record and transaction_db reads the block
+  // from blockchain as if it were never indexed
+  if (neb::configuration::instance().index_txs_on_parse() &&
+      !neb::use_test_blockchain) {
+    transaction_index ti(m_storage);
+    if (txs_to_index) {
+      ti.put_block_transactions(height, *txs_to_index);
+    } else {
+      blockchain_api ba;
+      ti.index_block(height, &ba);
+    }
+  }
+
   neb::rt::dip::dip_handler::instance().start(height);
 }
 
@@ -247,6 +385,7 @@ void ir_manager::parse_irs_by_height(
       ir_manager_helper::compile_payload_code(nbre_ir.get(), payload_bytes);
       ir_manager_helper::deploy_auth_table(m_storage, *nbre_ir.get(),
                                            m_auth_table, payload_bytes);
+      invalidate_ir_closures();
       continue;
     }
 
@@ -273,6 +412,7 @@ void ir_manager::parse_irs_by_height(
 
     // deploy ir
     ir_manager_helper::deploy_ir(name, version, payload_bytes, m_storage);
+    invalidate_ir_closures();
 
     deploy_if_dip(name, version, ht);
   }
@@ -284,6 +424,14 @@ void ir_manager::deploy_if_dip(const std::string &name, version_t version,
     return;
   }
   neb::rt::dip::dip_handler::instance().deploy(version, available_height);
+
+  // same key and irs as dip_handler::run_dip_ir
+  std::vector<nbre::NBREIR> irs;
+  read_ir_depends(name, version, available_height, true, irs);
+  std::stringstream ss;
+  ss << name << version;
+  jit_driver::instance().precompile(
+      ss.str(), irs, neb::configuration::instance().dip_func_name());
 }
 
 } // namespace fs
@@ -22,8 +22,11 @@
 #include "common/address.h"
 #include "common/common.h"
 #include "core/net_ipc/nipc_pkg.h"
+#include "fs/blockchain/blockchain_api.h"
 #include "fs/ir_manager/ir_manager_helper.h"
+#include "util/sharded_lru_cache.h"
 #include "util/wakeable_queue.h"
+#include <atomic>
 
 namespace neb {
 namespace fs {
@@ -48,15 +51,48 @@ private:
                        block_height_t height, bool depends,
                        std::vector<nbre::NBREIR> &irs);
 
+  struct ir_node_t {
+    //! false if it isn't in storage
+    bool m_exists = false;
+    //! false if it failed to parse
+    bool m_parsed = false;
+    nbre::NBREIR m_ir;
+  };
+  //! every IR reachable from one by depends, whatever their heights, keyed
+  //! by name and version
+  typedef std::unordered_map<std::string, ir_node_t> ir_closure_t;
+  typedef std::shared_ptr<const ir_closure_t> ir_closure_ptr_t;
+
+  //! from m_ir_closures, or read level by level, the IRs of a level in
+  //! parallel
+  ir_closure_ptr_t read_ir_closure(const std::string &name,
+                                   version_t version);
+  //! a closure may refer to an IR that is deployed later
+  void invalidate_ir_closures();
+
   void parse_next_block(block_height_t height,
                         const std::vector<std::string> &txs_seri);
   void parse_when_missing_block(block_height_t start_block,
                                 block_height_t end_height);
 
+  struct prefetched_block_t {
+    std::vector<corepb::Transaction> m_ir_txs;
+    //! to index, only if index_txs_on_parse
+    std::unique_ptr<std::vector<transaction_info_t>> m_txs;
+  };
+  //! blocks [start_height, end_height) by one batch, parsed in parallel, in
+  //! full only if they are to be indexed
+  static std::vector<prefetched_block_t>
+  prefetch_blocks(block_height_t start_height, block_height_t end_height,
+                  const std::string &ir_tx_type, bool index);
+
   void parse_irs_by_height(block_height_t height,
                            const std::vector<corepb::Transaction> &txs);
+  //! txs_to_index is what parse_with_height indexes, nullptr to read the
+  //! block again
   void parse_with_height(block_height_t height,
-                         const std::vector<corepb::Transaction> &txs);
+                         const std::vector<corepb::Transaction> &txs,
+                         const std::vector<transaction_info_t> *txs_to_index);
 
   void deploy_if_dip(const std::string &name, version_t version,
                      block_height_t available_height);
@@ -64,6 +100,9 @@ private:
 private:
   rocksdb_storage *m_storage;
   std::map<auth_key_t, auth_val_t> m_auth_table;
+  util::sharded_lru_cache<std::string, ir_closure_ptr_t, 4> m_ir_closures;
+  //! closures read before an invalidation aren't cached
+  std::atomic<uint64_t> m_ir_closures_generation;
 };
 } // namespace fs
 } // namespace neb
@@ -274,7 +274,7 @@ void ir_manager_helper::compile_payload_code(nbre::NBREIR *nbre_ir,
     std::stringstream ss;
     ss << nbre_ir->name();
     ss << nbre_ir->version();
-    cpp::cpp_ir ci(std::make_pair(ss.str(), nbre_ir->ir()));
+    cpp::cpp_ir ci(std::make_pair(ss.str(), nbre_ir->ir()), false);
 
     neb::bytes ir = ci.llvm_ir_content();
     nbre_ir->set_ir(neb::byte_to_string(ir));
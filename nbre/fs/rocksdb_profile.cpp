@@ -0,0 +1,143 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "fs/rocksdb_profile.h"
+#include "common/configuration.h"
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/statistics.h>
+#include <rocksdb/table.h>
+#include <sys/resource.h>
+
+namespace neb {
+namespace fs {
+
+rocksdb_profiles::rocksdb_profiles() {
+  // point lookups from trie walks on a read-only DB, keys mostly exist
+  rocksdb_profile trie_random_read;
+  trie_random_read.bloom_bits_per_key = 10;
+  trie_random_read.optimize_filters_for_hits = true;
+  trie_random_read.cache_index_and_filter_blocks = true;
+  m_profiles.insert(std::make_pair("trie-random-read", trie_random_read));
+
+  // small read-write DB of IRs and NBRE results
+  rocksdb_profile ir_store;
+  ir_store.bloom_bits_per_key = 10;
+  ir_store.write_buffer_size = 16 * 1024 * 1024;
+  ir_store.parallelism = 2;
+  m_profiles.insert(std::make_pair("ir-store", ir_store));
+
+  rocksdb_profile bulk_write;
+  bulk_write.bloom_bits_per_key = 10;
+  bulk_write.compaction_readahead_size = 2 * 1024 * 1024;
+  bulk_write.write_buffer_size = 256 * 1024 * 1024;
+  bulk_write.max_write_buffer_number = 4;
+  bulk_write.parallelism = std::max(4u, std::thread::hardware_concurrency());
+  m_profiles.insert(std::make_pair("bulk-write", bulk_write));
+}
+
+rocksdb_profile rocksdb_profiles::get(const std::string &name) const {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  auto it = m_profiles.find(name);
+  if (it == m_profiles.end()) {
+    throw std::invalid_argument("no such rocksdb profile " + name);
+  }
+  return it->second;
+}
+
+void rocksdb_profiles::set(const std::string &name,
+                           const rocksdb_profile &profile) {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  m_profiles[name] = profile;
+}
+
+std::shared_ptr<rocksdb::Cache> rocksdb_profiles::block_cache() {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  if (!m_block_cache) {
+    m_block_cache = rocksdb::NewLRUCache(
+        configuration::instance().rocksdb_block_cache_size());
+  }
+  return m_block_cache;
+}
+
+rocksdb::Options rocksdb_profiles::to_options(const std::string &name,
+                                              storage_open_flag flag) {
+  rocksdb_profile p = get(name);
+  rocksdb::Options options;
+  options.keep_log_file_num = 1;
+  options.max_open_files = p.max_open_files;
+  if (configuration::instance().rocksdb_max_open_files() != 0) {
+    options.max_open_files = configuration::instance().rocksdb_max_open_files();
+  }
+  check_open_files_limit(options.max_open_files);
+
+  rocksdb::BlockBasedTableOptions table_options;
+  if (p.bloom_bits_per_key > 0) {
+    table_options.filter_policy.reset(
+        rocksdb::NewBloomFilterPolicy(p.bloom_bits_per_key));
+  }
+  table_options.block_cache = block_cache();
+  table_options.block_size = p.block_size;
+  table_options.cache_index_and_filter_blocks = p.cache_index_and_filter_blocks;
+  table_options.pin_l0_filter_and_index_blocks_in_cache =
+      p.cache_index_and_filter_blocks;
+  options.table_factory.reset(
+      rocksdb::NewBlockBasedTableFactory(table_options));
+  options.optimize_filters_for_hits = p.optimize_filters_for_hits;
+
+  options.use_direct_reads =
+      p.use_direct_reads || configuration::instance().rocksdb_direct_io();
+  if (p.statistics) {
+    options.statistics = rocksdb::CreateDBStatistics();
+  }
+
+  if (flag == storage_open_for_readwrite) {
+    options.create_if_missing = true;
+    options.write_buffer_size = p.write_buffer_size;
+    options.max_write_buffer_number = p.max_write_buffer_number;
+    options.compaction_readahead_size = p.compaction_readahead_size;
+    options.use_direct_io_for_flush_and_compaction =
+        configuration::instance().rocksdb_direct_io();
+    options.IncreaseParallelism(p.parallelism);
+  }
+  return options;
+}
+
+void rocksdb_profiles::check_open_files_limit(int max_open_files) {
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0 ||
+      limit.rlim_cur == RLIM_INFINITY) {
+    return;
+  }
+  if (max_open_files < 0) {
+    LOG(WARNING) << "rocksdb keeps every SST open, make sure ulimit -n "
+                 << limit.rlim_cur << " is above the SST count of the db";
+  } else if (static_cast<rlim_t>(max_open_files) >= limit.rlim_cur) {
+    LOG(WARNING) << "rocksdb max_open_files " << max_open_files
+                 << " is not below ulimit -n " << limit.rlim_cur;
+  }
+}
+
+rocksdb::ReadOptions
+rocksdb_profiles::to_read_options(const std::string &name) const {
+  rocksdb::ReadOptions options;
+  options.readahead_size = get(name).readahead_size;
+  return options;
+}
+} // namespace fs
+} // namespace neb
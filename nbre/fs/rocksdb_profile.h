@@ -0,0 +1,80 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "common/common.h"
+#include "fs/storage.h"
+#include "util/singleton.h"
+#include <rocksdb/cache.h>
+#include <rocksdb/options.h>
+
+namespace neb {
+namespace fs {
+
+//! Tuning of a RocksDB instance, applied by rocksdb_storage::open_database.
+//! Options about writes are ignored for read-only opens.
+struct rocksdb_profile {
+  //! -1 keeps every SST open, which needs ulimit -n above the SST count,
+  //! configuration::rocksdb_max_open_files overrides it
+  int max_open_files = 500;
+  //! 0 for no bloom filter
+  int bloom_bits_per_key = 0;
+  //! no filter on the last level, for lookups of keys that mostly exist
+  bool optimize_filters_for_hits = false;
+  bool cache_index_and_filter_blocks = false;
+  size_t block_size = 4 * 1024;
+  bool use_direct_reads = false;
+  //! readahead of iterators, 0 for RocksDB's own
+  size_t readahead_size = 0;
+  size_t compaction_readahead_size = 0;
+  size_t write_buffer_size = 64 * 1024 * 1024;
+  int max_write_buffer_number = 2;
+  int parallelism = 4;
+  bool statistics = false;
+};
+
+//! Named profiles, "trie-random-read" for the neb chain DB, "ir-store" for
+//! the NBRE DB and "bulk-write" for loading data. All of them share one
+//! block cache, with the capacity of configuration::rocksdb_block_cache_size.
+class rocksdb_profiles : public util::singleton<rocksdb_profiles> {
+public:
+  rocksdb_profiles();
+
+  //! throw std::invalid_argument if there is no profile name
+  rocksdb_profile get(const std::string &name) const;
+  void set(const std::string &name, const rocksdb_profile &profile);
+
+  std::shared_ptr<rocksdb::Cache> block_cache();
+
+  //! options of profile name, with direct I/O if configuration asks for it
+  rocksdb::Options to_options(const std::string &name,
+                              storage_open_flag flag);
+  rocksdb::ReadOptions to_read_options(const std::string &name) const;
+
+private:
+  //! warn if the process may run out of file descriptors
+  static void check_open_files_limit(int max_open_files);
+
+  std::unordered_map<std::string, rocksdb_profile> m_profiles;
+  mutable std::mutex m_mutex;
+  std::shared_ptr<rocksdb::Cache> m_block_cache;
+};
+} // namespace fs
+} // namespace neb
@@ -19,37 +19,111 @@
 //
 
 #include "rocksdb_storage.h"
+#include "common/configuration.h"
+#include "fs/rocksdb_profile.h"
+#include "fs/util.h"
 #include <rocksdb/advanced_options.h>
 #include <rocksdb/cache.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/options.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/statistics.h>
 #include <rocksdb/table.h>
+#include <unistd.h>
 
 namespace neb{
 namespace fs {
 
-rocksdb_storage::rocksdb_storage() : m_db(nullptr), m_enable_batch(false) {}
+namespace {
+inline rocksdb::Slice to_slice(const bytes &b) {
+  return rocksdb::Slice(reinterpret_cast<const char *>(b.value()), b.size());
+}
+
+class rocksdb_iterator : public storage_iterator {
+public:
+  rocksdb_iterator(rocksdb::DB *db, const rocksdb::ReadOptions &read_options,
+                   const bytes &begin_key, const bytes &end_key)
+      : m_end_key(end_key), m_upper_bound(to_slice(m_end_key)) {
+    rocksdb::ReadOptions options(read_options);
+    if (!m_end_key.empty()) {
+      options.iterate_upper_bound = &m_upper_bound;
+    }
+    m_it.reset(db->NewIterator(options));
+    m_it->Seek(to_slice(begin_key));
+    check_status();
+  }
+
+  virtual bool valid() const { return m_it->Valid(); }
+  virtual void next() {
+    m_it->Next();
+    check_status();
+  }
+  virtual bytes key() const {
+    rocksdb::Slice k = m_it->key();
+    return bytes(reinterpret_cast<const byte_t *>(k.data()), k.size());
+  }
+  virtual bytes value() const {
+    return bytes(value_data(), value_size());
+  }
+  virtual const byte_t *value_data() const {
+    return reinterpret_cast<const byte_t *>(m_it->value().data());
+  }
+  virtual size_t value_size() const { return m_it->value().size(); }
+
+private:
+  void check_status() {
+    if (!m_it->Valid() && !m_it->status().ok()) {
+      throw storage_general_failure(m_it->status().ToString());
+    }
+  }
 
-rocksdb_storage::~rocksdb_storage() { close_database(); }
+  //! keep the upper bound alive as long as the iterator
+  bytes m_end_key;
+  rocksdb::Slice m_upper_bound;
+  std::unique_ptr<rocksdb::Iterator> m_it;
+};
+
+std::atomic<uint64_t> storage_id(0);
+
+//! batches of the calling thread, keyed by rocksdb_storage::m_id
+typedef std::unordered_map<uint64_t,
+                           std::unique_ptr<rocksdb::WriteBatchWithIndex>>
+    thread_batches_t;
+thread_batches_t &thread_batches() {
+  static thread_local thread_batches_t batches;
+  return batches;
+}
+} // namespace
+
+rocksdb_storage::rocksdb_storage()
+    : m_db(nullptr), m_read_only(false), m_batch_options(),
+      m_id(storage_id++) {}
+
+rocksdb_storage::~rocksdb_storage() {
+  thread_batches().erase(m_id);
+  close_database();
+}
 
 void rocksdb_storage::open_database(const std::string &db_name,
-                                    storage_open_flag flag) {
+                                    storage_open_flag flag,
+                                    const std::string &profile) {
   rocksdb::DB *db = nullptr;
   rocksdb::Status status;
 
   if (nullptr == m_db) {
-    if (flag == storage_open_for_readonly) {
-      rocksdb::Options options;
+    rocksdb::Options options;
+    m_read_options = rocksdb::ReadOptions();
+    if (!profile.empty()) {
+      options = rocksdb_profiles::instance().to_options(profile, flag);
+      m_read_options = rocksdb_profiles::instance().to_read_options(profile);
+    } else if (flag != storage_open_for_readwrite) {
       options.keep_log_file_num = 1;
       options.max_open_files = 500;
-      status = rocksdb::DB::OpenForReadOnly(options, db_name, &db, false);
-      m_enable_batch = true;
     } else {
-      rocksdb::Options options;
       options.keep_log_file_num = 1;
 
-      //! TODO setup bloomfilter, LRUCache, writer buffer size
       rocksdb::BlockBasedTableOptions table_options;
       table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
       table_options.block_cache = rocksdb::NewLRUCache(512 << 20);
@@ -60,14 +134,33 @@ void rocksdb_storage::open_database(const std::string &db_name,
       options.max_open_files = 500;
       options.write_buffer_size = 64 * 1024 * 1024;
       options.IncreaseParallelism(4);
+    }
+    m_statistics = options.statistics;
+
+    if (flag == storage_open_for_readonly) {
+      status = rocksdb::DB::OpenForReadOnly(options, db_name, &db, false);
+    } else if (flag == storage_open_as_secondary) {
+      // a secondary keeps all files open to follow the primary
+      options.max_open_files = -1;
+      m_secondary_path = neb::fs::join_path(
+          neb::fs::tmp_dir(), "nbre_secondary_" + std::to_string(getpid()) +
+                                  "_" + std::to_string(m_id));
+      status = rocksdb::DB::OpenAsSecondary(options, db_name,
+                                            m_secondary_path, &db);
+    } else {
       status = rocksdb::DB::Open(options, db_name, &db);
-      m_enable_batch = false;
     }
+    m_read_only = flag != storage_open_for_readwrite;
+    m_batch_options.max_batch_bytes =
+        configuration::instance().rocksdb_batch_max_bytes();
+    m_batch_options.max_batch_count =
+        configuration::instance().rocksdb_batch_max_count();
 
     if (status.ok()) {
       m_db = std::unique_ptr<rocksdb::DB>(db);
     } else {
       LOG(ERROR) << "open db error: " << status.ToString();
+      remove_secondary_dir();
       throw storage_general_failure(status.ToString());
     }
   } else {
@@ -75,6 +168,16 @@ void rocksdb_storage::open_database(const std::string &db_name,
   }
 }
 
+void rocksdb_storage::try_catch_up_with_primary() {
+  if (!m_db) {
+    throw storage_exception_no_init();
+  }
+  auto status = m_db->TryCatchUpWithPrimary();
+  if (!status.ok()) {
+    throw storage_general_failure(status.ToString());
+  }
+}
+
 void rocksdb_storage::close_database() {
   if (!m_db) {
     return;
@@ -84,39 +187,101 @@ void rocksdb_storage::close_database() {
     throw std::runtime_error("close database failed");
   }
   m_db.reset(nullptr);
+  remove_secondary_dir();
+}
+
+void rocksdb_storage::remove_secondary_dir() {
+  if (m_secondary_path.empty()) {
+    return;
+  }
+  neb::fs::remove_all(m_secondary_path);
+  m_secondary_path.clear();
 }
 
 bytes rocksdb_storage::get_bytes(const bytes &key) {
   if (!m_db) {
     throw storage_exception_no_init();
   }
-  rocksdb::Slice s(reinterpret_cast<const char *>(key.value()), key.size());
-  std::string value;
-  auto status = m_db->Get(rocksdb::ReadOptions(), s, &value);
+  bytes ret;
+  read_bytes(key, [&ret](const byte_t *value, size_t size) {
+    ret = bytes(value, size);
+  });
+  return ret;
+}
+
+void rocksdb_storage::read_bytes(
+    const bytes &key,
+    const std::function<void(const byte_t *value, size_t size)> &cb) {
+  if (!m_db) {
+    throw storage_exception_no_init();
+  }
+  //! pinned in the block cache or memtable, no intermediate std::string
+  rocksdb::PinnableSlice value;
+  rocksdb::Status status;
+  auto batch = thread_batch();
+  if (batch) {
+    status = batch->GetFromBatchAndDB(m_db.get(), m_read_options,
+                                      to_slice(key), &value);
+  } else {
+    status = m_db->Get(m_read_options, m_db->DefaultColumnFamily(),
+                       to_slice(key), &value);
+  }
   if (!status.ok()) {
     throw storage_general_failure(status.ToString());
   }
-  return string_to_byte(value);
+  cb(reinterpret_cast<const byte_t *>(value.data()), value.size());
+}
+
+std::vector<bytes>
+rocksdb_storage::multi_get_bytes(const std::vector<bytes> &keys) {
+  if (!m_db) {
+    throw storage_exception_no_init();
+  }
+  auto batch = thread_batch();
+  if (batch && batch->GetWriteBatch()->Count() > 0) {
+    //! MultiGet doesn't see the batch
+    return storage::multi_get_bytes(keys);
+  }
+  std::vector<rocksdb::Slice> slices;
+  slices.reserve(keys.size());
+  for (auto &k : keys) {
+    slices.push_back(to_slice(k));
+  }
+  std::vector<std::string> values;
+  auto status = m_db->MultiGet(m_read_options, slices, &values);
+
+  std::vector<bytes> ret;
+  ret.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!status[i].ok()) {
+      throw storage_general_failure(status[i].ToString());
+    }
+    ret.push_back(string_to_byte(values[i]));
+  }
+  return ret;
+}
+
+storage_iterator_ptr rocksdb_storage::new_iterator(const bytes &begin_key,
+                                                   const bytes &end_key) {
+  if (!m_db) {
+    throw storage_exception_no_init();
+  }
+  return std::make_unique<rocksdb_iterator>(m_db.get(), m_read_options,
+                                            begin_key, end_key);
 }
 
 void rocksdb_storage::put_bytes(const bytes &key, const bytes &val) {
   if (!m_db) {
     throw storage_exception_no_init();
   }
-  if (m_enable_batch) {
-    m_batched_ops.emplace_back([key, val](rocksdb::WriteBatch &wb) {
-      std::string str_value = byte_to_string(val);
-      rocksdb::Slice s(reinterpret_cast<const char *>(key.value()), key.size());
-      auto status = wb.Put(s, str_value);
-      if (!status.ok()) {
-        throw storage_general_failure(status.ToString());
-      }
-    });
+  check_writable();
+  auto batch = thread_batch();
+  if (batch) {
+    batch->Put(to_slice(key), to_slice(val));
+    flush_batch_if_full(batch);
     return;
   }
-  std::string str_value = byte_to_string(val);
-  rocksdb::Slice s(reinterpret_cast<const char *>(key.value()), key.size());
-  auto status = m_db->Put(rocksdb::WriteOptions(), s, str_value);
+  auto status = m_db->Put(write_options(), to_slice(key), to_slice(val));
   if (!status.ok()) {
     throw storage_general_failure(status.ToString());
   }
@@ -126,44 +291,117 @@ void rocksdb_storage::del_by_bytes(const bytes &key) {
   if (!m_db) {
     throw storage_exception_no_init();
   }
-  if (m_enable_batch) {
-    m_batched_ops.emplace_back([key](rocksdb::WriteBatch &wb) {
-      rocksdb::Slice s(reinterpret_cast<const char *>(key.value()), key.size());
-      auto status = wb.Delete(s);
-      if (!status.ok()) {
-        throw storage_general_failure(status.ToString());
-      }
-    });
+  check_writable();
+  auto batch = thread_batch();
+  if (batch) {
+    batch->Delete(to_slice(key));
+    flush_batch_if_full(batch);
     return;
   }
-  rocksdb::Slice s(reinterpret_cast<const char *>(key.value()), key.size());
-  auto status = m_db->Delete(rocksdb::WriteOptions(), s);
+  auto status = m_db->Delete(write_options(), to_slice(key));
   if (!status.ok()) {
     throw storage_general_failure(status.ToString());
   }
 }
 
-void rocksdb_storage::enable_batch() { m_enable_batch = true; }
+void rocksdb_storage::enable_batch() {
+  if (!m_db) {
+    throw storage_exception_no_init();
+  }
+  check_writable();
+  auto &batch = thread_batches()[m_id];
+  if (!batch) {
+    batch = std::make_unique<rocksdb::WriteBatchWithIndex>();
+  }
+}
 void rocksdb_storage::disable_batch() {
-  if (m_enable_batch) {
-    flush();
+  auto it = thread_batches().find(m_id);
+  if (it == thread_batches().end()) {
+    return;
+  }
+  // leave batch mode even if the write fails
+  std::unique_ptr<rocksdb::WriteBatchWithIndex> batch = std::move(it->second);
+  thread_batches().erase(it);
+  if (m_db) {
+    flush_batch(batch.get());
   }
-  m_enable_batch = false;
 }
 void rocksdb_storage::flush() {
-  if (!m_enable_batch) {
+  auto batch = thread_batch();
+  if (!batch) {
     return;
   }
   if (!m_db) {
     return;
   }
-  rocksdb::WriteBatch wb(0, 0);
-  std::for_each(m_batched_ops.begin(), m_batched_ops.end(),
-                [&wb](const batch_operation_t &f) { f(wb); });
-  auto status = m_db->Write(rocksdb::WriteOptions(), &wb);
+  flush_batch(batch);
+}
+
+void rocksdb_storage::set_batch_options(const rocksdb_batch_options &options) {
+  m_batch_options = options;
+}
+
+rocksdb::WriteOptions rocksdb_storage::write_options() const {
+  rocksdb::WriteOptions options;
+  options.sync = m_batch_options.sync;
+  options.disableWAL = m_batch_options.disable_wal;
+  return options;
+}
+
+void rocksdb_storage::check_writable() const {
+  if (m_read_only) {
+    throw storage_general_failure("write to a read-only database");
+  }
+}
+
+rocksdb::WriteBatchWithIndex *rocksdb_storage::thread_batch() const {
+  auto &batches = thread_batches();
+  if (batches.empty()) {
+    return nullptr;
+  }
+  auto it = batches.find(m_id);
+  return it == batches.end() ? nullptr : it->second.get();
+}
+
+void rocksdb_storage::flush_batch(rocksdb::WriteBatchWithIndex *batch) {
+  rocksdb::WriteBatch *wb = batch->GetWriteBatch();
+  if (wb->Count() == 0) {
+    return;
+  }
+  auto status = m_db->Write(write_options(), wb);
   if (!status.ok()) {
     throw storage_general_failure(status.ToString());
   }
+  batch->Clear();
+}
+
+void rocksdb_storage::flush_batch_if_full(rocksdb::WriteBatchWithIndex *batch) {
+  rocksdb::WriteBatch *wb = batch->GetWriteBatch();
+  if ((m_batch_options.max_batch_count != 0 &&
+       static_cast<size_t>(wb->Count()) >= m_batch_options.max_batch_count) ||
+      (m_batch_options.max_batch_bytes != 0 &&
+       wb->GetDataSize() >= m_batch_options.max_batch_bytes)) {
+    flush_batch(batch);
+  }
+}
+
+std::string rocksdb_storage::statistics() const {
+  if (!m_statistics) {
+    return std::string();
+  }
+  return m_statistics->ToString();
+}
+
+void rocksdb_storage::enable_perf_context(bool enable) {
+  rocksdb::SetPerfLevel(enable ? rocksdb::PerfLevel::kEnableTimeExceptForMutex
+                               : rocksdb::PerfLevel::kDisable);
+  rocksdb::get_perf_context()->Reset();
+}
+
+std::string rocksdb_storage::perf_context() {
+  std::string ret = rocksdb::get_perf_context()->ToString(true);
+  rocksdb::get_perf_context()->Reset();
+  return ret;
 }
 
 void rocksdb_storage::display(
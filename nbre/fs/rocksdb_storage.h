@@ -22,12 +22,23 @@
 #include "common/address.h"
 #include "common/common.h"
 #include "fs/storage.h"
+#include <atomic>
 #include <rocksdb/db.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
 #include <rocksdb/write_batch.h>
 
 namespace neb {
 namespace fs {
 
+//! A batch is written once it has max_batch_bytes or max_batch_count, 0
+//! means no limit. sync and disable_wal go to the WriteOptions of all writes.
+struct rocksdb_batch_options {
+  size_t max_batch_bytes = 0;
+  size_t max_batch_count = 0;
+  bool sync = false;
+  bool disable_wal = false;
+};
+
 class rocksdb_storage : public storage {
 public:
   rocksdb_storage();
@@ -35,24 +46,66 @@ public:
   rocksdb_storage(const rocksdb_storage &rs) = delete;
   rocksdb_storage &operator=(const rocksdb_storage &) = delete;
 
-  void open_database(const std::string &db_name, storage_open_flag flag);
+  //! profile is a name of rocksdb_profiles, empty for the built-in options
+  void open_database(const std::string &db_name, storage_open_flag flag,
+                     const std::string &profile = std::string());
   void close_database();
 
+  //! for storage_open_as_secondary, see what the primary wrote since
+  void try_catch_up_with_primary();
+
   virtual bytes get_bytes(const bytes &key);
   virtual void put_bytes(const bytes &key, const bytes &val);
   virtual void del_by_bytes(const bytes &key);
 
+  virtual std::vector<bytes> multi_get_bytes(const std::vector<bytes> &keys);
+  virtual void read_bytes(
+      const bytes &key,
+      const std::function<void(const byte_t *value, size_t size)> &cb);
+  virtual storage_iterator_ptr new_iterator(const bytes &begin_key,
+                                            const bytes &end_key);
+
+  //! Batch mode is per thread, writes of a thread in batch mode go to its
+  //! own WriteBatchWithIndex, its reads by key see them before flush,
+  //! iterators don't. Other threads read and write the db directly.
+  //! Read-only and secondary opens reject writes and batch mode.
   virtual void enable_batch();
   virtual void disable_batch();
   virtual void flush();
+  virtual bool is_batch_enabled() const { return thread_batch() != nullptr; }
+
+  //! open_database takes the batch limits from configuration, this overrides
+  //! them. Not synchronized with writes, set it before them
+  void set_batch_options(const rocksdb_batch_options &options);
 
   virtual void display(const std::function<void(rocksdb::Iterator *)> &cb);
 
+  //! RocksDB statistics, empty if the profile doesn't enable them
+  std::string statistics() const;
+
+  //! perf context counters of the calling thread
+  static void enable_perf_context(bool enable);
+  //! counters since the last call, then reset them
+  static std::string perf_context();
+
 private:
+  rocksdb::WriteOptions write_options() const;
+  void check_writable() const;
+  //! the batch of the calling thread, nullptr if it isn't in batch mode
+  rocksdb::WriteBatchWithIndex *thread_batch() const;
+  void flush_batch(rocksdb::WriteBatchWithIndex *batch);
+  void flush_batch_if_full(rocksdb::WriteBatchWithIndex *batch);
+  //! the secondary's own info log and manifest, useless once it's closed
+  void remove_secondary_dir();
+
   std::unique_ptr<rocksdb::DB> m_db;
-  bool m_enable_batch;
-  typedef std::function<void(rocksdb::WriteBatch &wb)> batch_operation_t;
-  std::vector<batch_operation_t> m_batched_ops;
+  rocksdb::ReadOptions m_read_options;
+  std::shared_ptr<rocksdb::Statistics> m_statistics;
+  bool m_read_only;
+  std::string m_secondary_path;
+  rocksdb_batch_options m_batch_options;
+  //! key of the batches of this storage in the threads, never reused
+  uint64_t m_id;
 }; // end class rocksdb_storage
 } // end namespace fs
 } // end namespace neb
@@ -26,6 +26,8 @@ namespace fs {
 enum storage_open_flag {
   storage_open_for_readwrite,
   storage_open_for_readonly,
+  //! read-only, and catch up with the primary on demand
+  storage_open_as_secondary,
   storage_open_default = storage_open_for_readonly,
 };
 
@@ -42,6 +44,21 @@ struct storage_exception_no_init : public std::exception {
   inline const char *what() const throw() { return "storage no initialized"; }
 };
 
+//! forward iterator over a range of keys of a storage
+class storage_iterator {
+public:
+  virtual ~storage_iterator() = default;
+
+  virtual bool valid() const = 0;
+  virtual void next() = 0;
+  virtual bytes key() const = 0;
+  virtual bytes value() const = 0;
+  //! the value without copy, valid until next()
+  virtual const byte_t *value_data() const = 0;
+  virtual size_t value_size() const = 0;
+};
+typedef std::unique_ptr<storage_iterator> storage_iterator_ptr;
+
 class storage {
 public:
   template <typename T, typename KT>
@@ -69,13 +86,97 @@ public:
   }
   void del(const std::string &key) { del_by_bytes(string_to_byte(key)); }
 
+  std::vector<bytes> multi_get(const std::vector<std::string> &keys) {
+    std::vector<bytes> bkeys;
+    bkeys.reserve(keys.size());
+    for (auto &k : keys) {
+      bkeys.push_back(string_to_byte(k));
+    }
+    return multi_get_bytes(bkeys);
+  }
+
   virtual bytes get_bytes(const bytes &key) = 0;
   virtual void put_bytes(const bytes &key, const bytes &val) = 0;
   virtual void del_by_bytes(const bytes &key) = 0;
 
+  //! values of keys in the same order, throw like get_bytes if any key fails
+  virtual std::vector<bytes> multi_get_bytes(const std::vector<bytes> &keys) {
+    std::vector<bytes> ret;
+    ret.reserve(keys.size());
+    for (auto &k : keys) {
+      ret.push_back(get_bytes(k));
+    }
+    return ret;
+  }
+
+  //! call cb with the value of key, the value is only valid in cb, so that
+  //! an implementation may hand out its own buffer without copy
+  virtual void read_bytes(const bytes &key,
+                          const std::function<void(const byte_t *value,
+                                                   size_t size)> &cb) {
+    bytes v = get_bytes(key);
+    cb(v.value(), v.size());
+  }
+
+  //! iterator of keys in [begin_key, end_key) in order, an empty end_key
+  //! means no upper bound
+  virtual storage_iterator_ptr new_iterator(const bytes &begin_key,
+                                            const bytes &end_key) = 0;
+
+  //! iterate keys in [begin_key, end_key) in order
+  void scan(const bytes &begin_key, const bytes &end_key,
+            const std::function<void(const bytes &key, const bytes &val)> &cb) {
+    auto it = new_iterator(begin_key, end_key);
+    for (; it->valid(); it->next()) {
+      cb(it->key(), it->value());
+    }
+  }
+
+  //! iterate keys starting with prefix in order
+  void scan_prefix(
+      const bytes &prefix,
+      const std::function<void(const bytes &key, const bytes &val)> &cb) {
+    scan(prefix, prefix_end(prefix), cb);
+  }
+
+  //! the smallest key greater than all keys starting with prefix, empty if
+  //! there is no such key
+  static bytes prefix_end(const bytes &prefix) {
+    size_t len = prefix.size();
+    while (len > 0 && prefix[len - 1] == 0xff) {
+      len--;
+    }
+    if (len == 0) {
+      return bytes();
+    }
+    bytes ret(prefix.value(), len);
+    ret[len - 1]++;
+    return ret;
+  }
+
   virtual void enable_batch() = 0;
   virtual void disable_batch() = 0;
   virtual void flush() = 0;
+  virtual bool is_batch_enabled() const = 0;
+
+  //! run f with batch enabled and write what f puts at once, unless the
+  //! caller enabled batch already. What f wrote before an exception is still
+  //! written, as it would be without batch. Batch mode belongs to the calling
+  //! thread, writes of other threads meanwhile aren't part of it.
+  template <typename Func> void batch_write(Func &&f) {
+    if (is_batch_enabled()) {
+      f();
+      return;
+    }
+    enable_batch();
+    try {
+      f();
+    } catch (...) {
+      disable_batch();
+      throw;
+    }
+    disable_batch();
+  }
 };
 }
 }
@@ -59,6 +59,11 @@ bool exists(const std::string &p) {
   return boost::filesystem::exists(boost::filesystem::path(p));
 }
 
+void remove_all(const std::string &p) {
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(boost::filesystem::path(p), ec);
+}
+
 std::string get_user_name() { return std::string("usr"); }
 
 } // end namespace fs
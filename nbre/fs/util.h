@@ -31,6 +31,7 @@ std::string join_path(const std::string &parent, const std::string &fp);
 std::string parent_dir(const std::string &fp);
 bool is_absolute_path(const std::string &fp);
 bool exists(const std::string &p);
+void remove_all(const std::string &p);
 std::string get_user_name();
 
 } // end namespace fs
@@ -110,6 +110,10 @@ llvm::Error llvm::OrcLazyJIT::addModule(std::shared_ptr<Module> M) {
     }
   }
 
+  if (!Lazy)
+    return addModuleEagerly(std::move(M), std::move(CtorNames),
+                            std::move(DtorNames));
+
   // Symbol resolution order:
   //   1) Search the JIT symbols.
   //   2) Check for C++ runtime overrides.
@@ -149,6 +153,36 @@ llvm::Error llvm::OrcLazyJIT::addModule(std::shared_ptr<Module> M) {
   return Error::success();
 }
 
+llvm::Error llvm::OrcLazyJIT::addModuleEagerly(
+    std::shared_ptr<Module> M, std::vector<std::string> CtorNames,
+    std::vector<std::string> DtorNames) {
+  // Same resolution order as the lazy path, over the whole-module layer.
+  auto Resolver = orc::createLambdaResolver(
+      [this](const std::string &Name) -> JITSymbol {
+        if (auto Sym = IRDumpLayer.findSymbol(Name, true))
+          return Sym;
+        return CXXRuntimeOverrides.searchOverrides(Name);
+      },
+      [](const std::string &Name) {
+        if (auto Addr = RTDyldMemoryManager::getSymbolAddressInProcess(Name))
+          return JITSymbol(Addr, JITSymbolFlags::Exported);
+        return JITSymbol(nullptr);
+      });
+
+  auto HandleOrErr = IRDumpLayer.addModule(std::move(M), std::move(Resolver));
+  if (!HandleOrErr)
+    return HandleOrErr.takeError();
+
+  orc::CtorDtorRunner<IRDumpLayerT> CtorRunner(std::move(CtorNames),
+                                               *HandleOrErr);
+  if (auto Err = CtorRunner.runViaLayer(IRDumpLayer))
+    return Err;
+
+  EagerStaticDestructorRunners.emplace_back(std::move(DtorNames),
+                                            *HandleOrErr);
+  return Error::success();
+}
+
 // Defined in lli.cpp.
 // CodeGenOpt::Level getOptLevel();
 
@@ -21,8 +21,10 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/ADT/Twine.h"
+#include "jit/jit_memory_manager.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
@@ -78,11 +80,14 @@ public:
   OrcLazyJIT(std::unique_ptr<TargetMachine> TM,
              std::unique_ptr<CompileCallbackMgr> CCMgr,
              IndirectStubsManagerBuilder IndirectStubsMgrBuilder,
-             bool InlineStubs)
-      : TM(std::move(TM)), DL(this->TM->createDataLayout()),
-        CCMgr(std::move(CCMgr)),
-        ObjectLayer([]() { return std::make_shared<SectionMemoryManager>(); }),
-        CompileLayer(ObjectLayer, orc::SimpleCompiler(*this->TM)),
+             bool InlineStubs, ObjectCache *ObjCache = nullptr,
+             bool Lazy = true)
+      : Lazy(Lazy), CodeSize(0), TM(std::move(TM)),
+        DL(this->TM->createDataLayout()), CCMgr(std::move(CCMgr)),
+        ObjectLayer([this]() {
+          return std::make_shared<neb::jit::jit_memory_manager>(CodeSize);
+        }),
+        CompileLayer(ObjectLayer, orc::SimpleCompiler(*this->TM, ObjCache)),
         IRDumpLayer(CompileLayer, createDebugDumper()),
         CODLayer(IRDumpLayer, extractSingleFunction, *this->CCMgr,
                  std::move(IndirectStubsMgrBuilder), InlineStubs),
@@ -93,6 +98,9 @@ public:
     // Run any destructors registered with __cxa_atexit.
     CXXRuntimeOverrides.runDestructors();
     // Run any IR destructors.
+    for (auto &DtorRunner : EagerStaticDestructorRunners)
+      if (auto Err = DtorRunner.runViaLayer(IRDumpLayer))
+        report_fatal_error(std::move(Err));
     for (auto &DtorRunner : IRStaticDestructorRunners)
       if (auto Err = DtorRunner.runViaLayer(CODLayer)) {
         // FIXME: OrcLazyJIT should probably take a "shutdownError" callback to
@@ -104,9 +112,14 @@ public:
   Error addModule(std::shared_ptr<Module> M);
 
   JITSymbol findSymbol(const std::string &Name) {
+    if (!Lazy)
+      return IRDumpLayer.findSymbol(mangle(Name), true);
     return CODLayer.findSymbol(mangle(Name), true);
   }
 
+  // Bytes of the sections allocated for the objects of this JIT.
+  uint64_t getCodeSize() const { return CodeSize; }
+
   JITSymbol findSymbolIn(ModuleHandleT H, const std::string &Name) {
     return CODLayer.findSymbolIn(H, mangle(Name), true);
   }
@@ -129,6 +142,15 @@ private:
 
   static TransformFtor createDebugDumper();
 
+  // Without Lazy, modules skip the compile-on-demand layer, they are compiled
+  // whole when added and linked when a symbol's address is first taken. Calls
+  // then don't go through the JIT's trampolines, which aren't thread-safe.
+  Error addModuleEagerly(std::shared_ptr<Module> M,
+                         std::vector<std::string> CtorNames,
+                         std::vector<std::string> DtorNames);
+
+  bool Lazy;
+  std::atomic<uint64_t> CodeSize;
   std::unique_ptr<TargetMachine> TM;
   DataLayout DL;
   SectionMemoryManager CCMgrMemMgr;
@@ -141,6 +163,7 @@ private:
 
   orc::LocalCXXRuntimeOverrides CXXRuntimeOverrides;
   std::vector<orc::CtorDtorRunner<CODLayerT>> IRStaticDestructorRunners;
+  std::vector<orc::CtorDtorRunner<IRDumpLayerT>> EagerStaticDestructorRunners;
   llvm::Optional<CODLayerT::ModuleHandleT> ModulesHandle;
 };
 
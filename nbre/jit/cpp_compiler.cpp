@@ -0,0 +1,307 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "jit/cpp_compiler.h"
+#include "common/configuration.h"
+#include "crypto/hash.h"
+#include "fs/util.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/CodeGen/CodeGenAction.h"
+#include "clang/Driver/Compilation.h"
+#include "clang/Driver/Driver.h"
+#include "clang/Driver/Tool.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace neb {
+namespace cpp {
+
+namespace {
+//! diagnostics of the driver and the frontend, as text
+struct diagnostics_t {
+  diagnostics_t()
+      : m_os(m_text), m_opts(new clang::DiagnosticOptions()),
+        m_engine(new clang::DiagnosticIDs(), m_opts,
+                 new clang::TextDiagnosticPrinter(m_os, m_opts.get())) {}
+
+  inline std::string text() {
+    m_os.flush();
+    return m_text;
+  }
+
+  std::string m_text;
+  llvm::raw_string_ostream m_os;
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> m_opts;
+  clang::DiagnosticsEngine m_engine;
+};
+
+//! the header of #include "runtime/..." if it's the first line of source,
+//! but blank lines and // comments
+std::string leading_runtime_header(const std::string &cpp_content) {
+  static const std::string directive = "#include \"";
+  static const std::string runtime_dir = "runtime/";
+  std::stringstream ss(cpp_content);
+  std::string line;
+  while (std::getline(ss, line)) {
+    size_t b = line.find_first_not_of(" \t\r");
+    if (b == std::string::npos || line.compare(b, 2, "//") == 0) {
+      continue;
+    }
+    if (line.compare(b, directive.size(), directive) != 0 ||
+        line.compare(b + directive.size(), runtime_dir.size(), runtime_dir) !=
+            0) {
+      return std::string();
+    }
+    size_t s = b + directive.size();
+    size_t e = line.find('"', s);
+    if (e == std::string::npos) {
+      return std::string();
+    }
+    return line.substr(s, e - s);
+  }
+  return std::string();
+}
+
+//! the cc1 invocation which the clang driver makes for args
+std::shared_ptr<clang::CompilerInvocation>
+make_invocation(const std::vector<std::string> &args,
+                clang::DiagnosticsEngine &diags) {
+  std::vector<const char *> argv;
+  for (auto &a : args) {
+    argv.push_back(a.c_str());
+  }
+  clang::driver::Driver driver(argv[0], llvm::sys::getProcessTriple(), diags);
+  driver.setCheckInputsExist(false);
+  std::unique_ptr<clang::driver::Compilation> c(driver.BuildCompilation(argv));
+  if (!c || diags.hasErrorOccurred()) {
+    return nullptr;
+  }
+
+  const clang::driver::JobList &jobs = c->getJobs();
+  if (jobs.size() != 1 || !llvm::isa<clang::driver::Command>(*jobs.begin())) {
+    return nullptr;
+  }
+  const clang::driver::Command &cmd =
+      llvm::cast<clang::driver::Command>(*jobs.begin());
+  if (llvm::StringRef(cmd.getCreator().getName()) != "clang") {
+    return nullptr;
+  }
+  const llvm::opt::ArgStringList &cc1_args = cmd.getArguments();
+  auto ret = std::make_shared<clang::CompilerInvocation>();
+  if (!clang::CompilerInvocation::CreateFromArgs(
+          *ret, cc1_args.data(), cc1_args.data() + cc1_args.size(), diags)) {
+    return nullptr;
+  }
+  //! the driver passes -disable-free, which leaks in a long running process
+  ret->getFrontendOpts().DisableFree = false;
+  ret->getCodeGenOpts().DisableFree = false;
+  return ret;
+}
+} // namespace
+
+cpp_compiler::cpp_compiler()
+    : m_pch_dir(fs::join_path(fs::tmp_dir(), "nbre_pch")) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+}
+
+void cpp_compiler::set_llvm_root(const std::string &llvm_root) {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  m_llvm_root = llvm_root;
+}
+
+void cpp_compiler::set_pch_dir(const std::string &pch_dir) {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  m_pch_dir = pch_dir;
+  m_pchs.clear();
+}
+
+neb::bytes cpp_compiler::compile(const std::string &name,
+                                 const std::string &cpp_content,
+                                 const std::vector<std::string> &args) {
+  neb::bytes bitcode;
+  std::string diagnostics;
+  std::string pch_path = get_pch(cpp_content, args);
+  if (!pch_path.empty()) {
+    if (emit_bitcode(name, cpp_content, args, pch_path, bitcode,
+                     diagnostics)) {
+      return bitcode;
+    }
+    LOG(INFO) << "compile " << name << " again without " << pch_path;
+    drop_pch(pch_path);
+  }
+
+  if (!emit_bitcode(name, cpp_content, args, std::string(), bitcode,
+                    diagnostics)) {
+    LOG(ERROR) << "failed to compile " << name << "\n" << diagnostics;
+    return neb::bytes();
+  }
+  return bitcode;
+}
+
+std::string cpp_compiler::get_pch(const std::string &cpp_content,
+                                  const std::vector<std::string> &args) {
+  std::string header = leading_runtime_header(cpp_content);
+  std::unique_lock<std::mutex> _l(m_mutex);
+  if (header.empty() || m_pch_dir.empty()) {
+    return std::string();
+  }
+
+  std::stringstream ss;
+  ss << header << LLVM_VERSION_STRING << m_llvm_root;
+  for (auto &a : args) {
+    ss << ' ' << a;
+  }
+  auto h = crypto::sha3_256_hash(ss.str());
+  std::string pch_path = fs::join_path(
+      m_pch_dir, "cpp_pch_" + h.to_hex().substr(0, 16) + ".pch");
+
+  auto it = m_pchs.find(pch_path);
+  if (it != m_pchs.end()) {
+    return it->second ? pch_path : std::string();
+  }
+  //! one made by a previous process is checked by clang when it's used
+  bool usable = fs::exists(pch_path);
+  if (!usable) {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(m_pch_dir, ec);
+    usable = make_pch(header, pch_path, args);
+  }
+  m_pchs.insert(std::make_pair(pch_path, usable));
+  return usable ? pch_path : std::string();
+}
+
+void cpp_compiler::drop_pch(const std::string &pch_path) {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  boost::system::error_code ec;
+  boost::filesystem::remove(pch_path, ec);
+  //! to make it again by the next compile
+  m_pchs.erase(pch_path);
+}
+
+bool cpp_compiler::make_pch(const std::string &header,
+                            const std::string &pch_path,
+                            const std::vector<std::string> &args) {
+  //! the precompiled header refers to this file, so it's kept
+  std::string stub_path = pch_path + ".h";
+  {
+    std::ofstream ofs(stub_path, std::ios::out | std::ios::trunc);
+    ofs << "#include \"" << header << "\"\n";
+  }
+
+  diagnostics_t diags;
+  auto invocation = make_invocation(
+      driver_args(args, "c++-header", stub_path), diags.m_engine);
+  if (!invocation) {
+    LOG(INFO) << "failed to precompile " << header << "\n" << diags.text();
+    return false;
+  }
+  invocation->getFrontendOpts().OutputFile = pch_path;
+
+  clang::CompilerInstance ci;
+  ci.setInvocation(invocation);
+  ci.createDiagnostics(
+      new clang::TextDiagnosticPrinter(diags.m_os, &ci.getDiagnosticOpts()));
+  clang::GeneratePCHAction action;
+  if (!ci.ExecuteAction(action)) {
+    LOG(INFO) << "failed to precompile " << header << "\n" << diags.text();
+    return false;
+  }
+  LOG(INFO) << "precompiled " << header << " to " << pch_path;
+  return true;
+}
+
+bool cpp_compiler::emit_bitcode(const std::string &name,
+                                const std::string &cpp_content,
+                                const std::vector<std::string> &args,
+                                const std::string &pch_path,
+                                neb::bytes &bitcode, std::string &diagnostics) {
+  std::string file_name = name + ".cpp";
+  diagnostics_t diags;
+  auto invocation =
+      make_invocation(driver_args(args, "c++", file_name), diags.m_engine);
+  if (!invocation) {
+    diagnostics = diags.text();
+    return false;
+  }
+
+  //! the source is read from memory rather than file_name
+  auto buf = llvm::MemoryBuffer::getMemBuffer(cpp_content, file_name);
+  auto &inputs = invocation->getFrontendOpts().Inputs;
+  inputs.clear();
+  inputs.push_back(clang::FrontendInputFile(
+      buf.get(), clang::InputKind(clang::InputKind::CXX)));
+  if (!pch_path.empty()) {
+    invocation->getPreprocessorOpts().ImplicitPCHInclude = pch_path;
+  }
+
+  clang::CompilerInstance ci;
+  ci.setInvocation(invocation);
+  ci.createDiagnostics(
+      new clang::TextDiagnosticPrinter(diags.m_os, &ci.getDiagnosticOpts()));
+  clang::EmitLLVMOnlyAction action;
+  bool succ = ci.ExecuteAction(action);
+  std::unique_ptr<llvm::Module> module = action.takeModule();
+  if (!succ || !module) {
+    diagnostics = diags.text();
+    return false;
+  }
+
+  llvm::SmallVector<char, 0> out;
+  llvm::raw_svector_ostream os(out);
+  llvm::WriteBitcodeToFile(module.get(), os);
+  bitcode = neb::bytes(reinterpret_cast<const byte_t *>(out.data()),
+                       out.size());
+  return true;
+}
+
+std::vector<std::string>
+cpp_compiler::driver_args(const std::vector<std::string> &args,
+                          const std::string &lang,
+                          const std::string &input) const {
+  //! -fsyntax-only for a single cc1 job, which action is replaced
+  std::string llvm_root = m_llvm_root;
+  if (llvm_root.empty()) {
+    llvm_root =
+        fs::join_path(configuration::instance().nbre_root_dir(), "lib_llvm");
+  }
+  std::vector<std::string> ret;
+  ret.push_back(fs::join_path(llvm_root, "bin/clang"));
+  ret.push_back("-fsyntax-only");
+  ret.push_back("-O2");
+  ret.insert(ret.end(), args.begin(), args.end());
+  ret.push_back("-x");
+  ret.push_back(lang);
+  ret.push_back(input);
+  return ret;
+}
+} // namespace cpp
+} // namespace neb
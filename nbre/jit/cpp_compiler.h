@@ -0,0 +1,80 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#pragma once
+#include "common/byte.h"
+#include "common/common.h"
+#include "util/singleton.h"
+
+namespace neb {
+namespace cpp {
+
+//! Compiles C++ source to LLVM bitcode in process with the clang frontend
+//! libraries, instead of running the clang binary on temporary files. The
+//! clang driver of llvm_root is asked for the cc1 arguments, so that system
+//! and builtin headers are found as with the binary.
+//!
+//! A source which starts with #include "runtime/..." is compiled with a
+//! precompiled header of that header, made once per header and arguments and
+//! kept in pch_dir, so that repeated builds skip parsing the NBRE runtime
+//! headers. A source which can't be compiled with its precompiled header, like
+//! if the header changed since, is compiled again without it.
+class cpp_compiler : public util::singleton<cpp_compiler> {
+public:
+  cpp_compiler();
+
+  //! where clang is installed, lib_llvm of nbre_root_dir by default, set
+  //! before any compile
+  void set_llvm_root(const std::string &llvm_root);
+  //! empty to never use precompiled headers, a dir of tmp_dir by default
+  void set_pch_dir(const std::string &pch_dir);
+
+  //! args are extra clang arguments, like -I, return empty bytes and log
+  //! diagnostics if cpp_content fails to compile
+  neb::bytes compile(const std::string &name, const std::string &cpp_content,
+                     const std::vector<std::string> &args);
+
+protected:
+  //! the precompiled header for cpp_content and args, empty if none
+  std::string get_pch(const std::string &cpp_content,
+                      const std::vector<std::string> &args);
+  void drop_pch(const std::string &pch_path);
+
+  bool make_pch(const std::string &header, const std::string &pch_path,
+                const std::vector<std::string> &args);
+
+  bool emit_bitcode(const std::string &name, const std::string &cpp_content,
+                    const std::vector<std::string> &args,
+                    const std::string &pch_path, neb::bytes &bitcode,
+                    std::string &diagnostics);
+
+  std::vector<std::string> driver_args(const std::vector<std::string> &args,
+                                       const std::string &lang,
+                                       const std::string &input) const;
+
+protected:
+  std::mutex m_mutex;
+  std::string m_llvm_root;
+  std::string m_pch_dir;
+  //! precompiled headers made or found by this process, false if it failed
+  //! to make one
+  std::unordered_map<std::string, bool> m_pchs;
+}; // end class cpp_compiler
+} // namespace cpp
+} // namespace neb
@@ -19,17 +19,21 @@
 //
 #include "jit/cpp_ir.h"
 #include "fs/util.h"
+#include "jit/cpp_compiler.h"
 #include "util/chrono.h"
 
 namespace neb {
 namespace cpp {
 std::atomic_int cpp_ir::s_file_counter(1);
 
-cpp_ir::cpp_ir(const cpp_t &cpp)
+cpp_ir::cpp_ir(const cpp_t &cpp, bool in_process)
     : m_name_version(cpp.first), m_cpp_content(cpp.second),
-      m_b_got_error(false) {}
+      m_b_got_error(false), m_in_process(in_process) {}
 
 neb::bytes cpp_ir::llvm_ir_content() {
+  if (m_in_process) {
+    return llvm_ir_content_in_process();
+  }
   if (m_llvm_ir_fp == std::string("") && !m_b_got_error) {
 
     std::string fp_base = generate_fp() + '_' + m_name_version;
@@ -65,6 +69,23 @@ neb::bytes cpp_ir::llvm_ir_content() {
   ifs.close();
   return buf;
 }
+
+neb::bytes cpp_ir::llvm_ir_content_in_process() {
+  if (m_llvm_ir.empty() && !m_b_got_error) {
+    std::vector<std::string> args;
+    args.push_back(
+        std::string("-I") +
+        neb::fs::join_path(::neb::configuration::instance().nbre_root_dir(),
+                           "lib/include"));
+    m_llvm_ir =
+        cpp_compiler::instance().compile(m_name_version, m_cpp_content, args);
+    if (m_llvm_ir.empty()) {
+      m_b_got_error = true;
+    }
+  }
+  return m_llvm_ir;
+}
+
 std::string cpp_ir::generate_fp() {
   std::string temp_path = neb::fs::tmp_dir();
 
@@ -30,11 +30,15 @@ public:
   typedef std::string name_version_t;
   typedef std::string cpp_content_t;
   typedef std::pair<name_version_t, cpp_content_t> cpp_t;
-  cpp_ir(const cpp_t &cpp);
+  //! in_process compiles with cpp_compiler, otherwise with the clang binary,
+  //! which is what on-chain IR deploys have always used
+  cpp_ir(const cpp_t &cpp, bool in_process = false);
 
   neb::bytes llvm_ir_content();
 
 protected:
+  neb::bytes llvm_ir_content_in_process();
+
   int make_ir_bitcode(const std::string &cpp_file,
                       const std::string &ir_bc_file);
 
@@ -46,6 +50,8 @@ protected:
   std::string m_cpp_fp;
   std::string m_llvm_ir_fp;
   bool m_b_got_error;
+  bool m_in_process;
+  neb::bytes m_llvm_ir;
   static std::atomic_int s_file_counter;
 };
 } // namespace cpp
@@ -63,10 +63,12 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Instrumentation.h"
 #include <cerrno>
+#include <chrono>
+#include <ff/functionflow.h>
 
 namespace neb {
 
-jit_driver::jit_driver() {
+jit_driver::jit_driver() : m_stats_log_counter(0) {
   // llvm::sys::PrintStackTraceOnErrorSignal(
   // configuration::instance().exec_name(), false);
   llvm::InitializeNativeTarget();
@@ -113,18 +115,33 @@ bool jit_driver::find_mangling(llvm::Module *M, const std::string &func_name,
 std::unique_ptr<jit_driver::jit_context>
 jit_driver::make_context(const std::vector<nbre::NBREIR> &irs,
                          const std::string &func_name) {
+  auto start_time = std::chrono::high_resolution_clock::now();
   std::unique_ptr<jit_context> ret = std::make_unique<jit_context>();
 
-  std::string mangling_name;
-  std::vector<std::unique_ptr<llvm::Module>> modules;
-  for (const auto &ir : irs) {
-    std::string ir_str = ir.ir();
-    llvm::StringRef sr(ir_str);
+  std::vector<std::unique_ptr<llvm::Module>> parsed(irs.size());
+  for (size_t i = 0; i < irs.size(); i++) {
+    ret->m_contexts.push_back(std::make_unique<llvm::LLVMContext>());
+  }
+  auto parse = [&irs, &parsed, &ret](size_t i) {
+    llvm::StringRef sr(irs[i].ir());
     auto mem_buf = llvm::MemoryBuffer::getMemBuffer(sr, "", false);
     llvm::SMDiagnostic err;
+    parsed[i] = llvm::parseIR(mem_buf->getMemBufferRef(), err,
+                              *ret->m_contexts[i], true);
+  };
+  if (irs.size() > 1 && ff::is_initialized()) {
+    ff::paragroup pg;
+    pg.for_each(static_cast<size_t>(0), irs.size(), parse);
+    ff::ff_wait(ff::all(pg));
+  } else {
+    for (size_t i = 0; i < irs.size(); i++) {
+      parse(i);
+    }
+  }
 
-    auto module =
-        llvm::parseIR(mem_buf->getMemBufferRef(), err, ret->m_context, true);
+  std::string mangling_name;
+  std::vector<std::unique_ptr<llvm::Module>> modules;
+  for (auto &module : parsed) {
     find_mangling(module.get(), func_name, mangling_name);
     if (nullptr == module) {
       LOG(ERROR) << "Module broken";
@@ -132,22 +149,136 @@ jit_driver::make_context(const std::vector<nbre::NBREIR> &irs,
       modules.push_back(std::move(module));
     }
   }
-  ret->m_jit.init(std::move(modules), mangling_name);
+  ret->m_jit.init(std::move(modules), mangling_name, &m_object_cache);
+  ret->m_code_size = ret->m_jit.code_size();
+  auto end_time = std::chrono::high_resolution_clock::now();
+  ret->m_compile_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                            end_time - start_time)
+                            .count();
   return std::move(ret);
 }
 
-void jit_driver::timer_callback() {
+void jit_driver::set_object_storage(fs::storage *storage) {
+  m_object_cache.set_storage(storage);
+}
+
+void jit_driver::precompile(const std::string &ir_key,
+                            const std::vector<nbre::NBREIR> &irs,
+                            const std::string &func_name) {
+  m_precompile_thread.schedule([this, ir_key, irs, func_name]() {
+    try {
+      find_or_make_context(ir_key, irs, func_name, false);
+    } catch (const std::exception &e) {
+      LOG(INFO) << "precompile " << ir_key << " failed " << e.what();
+    }
+  });
+}
+
+jit_driver::jit_context_ptr_t
+jit_driver::find_or_make_context(const std::string &key,
+                                 const std::vector<nbre::NBREIR> &irs,
+                                 const std::string &func_name, bool is_run) {
   std::unique_lock<std::mutex> _l(m_mutex);
-  std::vector<std::string> keys;
-  for (auto &it : m_jit_instances) {
-    it.second->m_time_counter--;
-    if (it.second->m_time_counter < 0) {
-      keys.push_back(it.first);
+  if (is_run) {
+    jit_context_ptr_t context = find_and_touch(key);
+    if (context) {
+      return context;
+    }
+    m_stats.m_misses++;
+  } else {
+    auto it = m_jit_instances.find(key);
+    if (it != m_jit_instances.end()) {
+      return it->second->second;
     }
   }
-  for (auto &s : keys) {
-    m_jit_instances.erase(s);
+
+  auto making = m_making_contexts.find(key);
+  if (making != m_making_contexts.end()) {
+    std::shared_future<jit_context_ptr_t> f = making->second;
+    _l.unlock();
+    return f.get();
   }
+
+  std::promise<jit_context_ptr_t> promise;
+  m_making_contexts.insert(std::make_pair(key, promise.get_future().share()));
+  _l.unlock();
+
+  jit_context_ptr_t context;
+  try {
+    context = make_context(irs, func_name);
+  } catch (...) {
+    _l.lock();
+    m_making_contexts.erase(key);
+    _l.unlock();
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  _l.lock();
+  m_making_contexts.erase(key);
+  insert_and_shrink(key, context);
+  _l.unlock();
+  promise.set_value(context);
+  return context;
+}
+
+jit_driver::jit_context_ptr_t
+jit_driver::find_and_touch(const std::string &key) {
+  auto it = m_jit_instances.find(key);
+  if (it == m_jit_instances.end()) {
+    return nullptr;
+  }
+  m_stats.m_hits++;
+  m_lru_list.splice(m_lru_list.begin(), m_lru_list, it->second);
+  return it->second->second;
+}
+
+void jit_driver::insert_and_shrink(const std::string &key,
+                                   jit_context_ptr_t context) {
+  m_stats.m_compiles++;
+  m_stats.m_compile_time += context->m_compile_time;
+  m_stats.m_code_size += context->m_code_size;
+  m_lru_list.emplace_front(key, context);
+  m_jit_instances.insert(std::make_pair(key, m_lru_list.begin()));
+
+  uint64_t budget = configuration::instance().jit_cache_size();
+  auto it = m_lru_list.end();
+  while (m_stats.m_code_size > budget && it != m_lru_list.begin()) {
+    --it;
+    //! m_lru_list holds one, a run in progress holds another
+    bool in_use = it->second.use_count() > 1;
+    if (in_use || it->first == key) {
+      continue;
+    }
+    LOG(INFO) << "evict jit context " << it->first << " code size "
+              << it->second->m_code_size;
+    m_stats.m_code_size -= it->second->m_code_size;
+    m_stats.m_evictions++;
+    m_jit_instances.erase(it->first);
+    it = m_lru_list.erase(it);
+  }
+}
+
+jit_driver::stats_t jit_driver::stats() const {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  stats_t ret = m_stats;
+  ret.m_instances = m_jit_instances.size();
+  return ret;
+}
+
+void jit_driver::timer_callback() {
+  m_stats_log_counter++;
+  if (m_stats_log_counter < 10 * 60) {
+    return;
+  }
+  m_stats_log_counter = 0;
+  stats_t s = stats();
+  LOG(INFO) << "jit contexts " << s.m_instances << " code size "
+            << s.m_code_size << " budget "
+            << configuration::instance().jit_cache_size() << " hits "
+            << s.m_hits << " misses " << s.m_misses << " evictions "
+            << s.m_evictions << " compiles " << s.m_compiles
+            << " compile time(us) " << s.m_compile_time;
 }
 
 std::string jit_driver::gen_key(const std::vector<nbre::NBREIR> &irs,
@@ -159,21 +290,4 @@ std::string jit_driver::gen_key(const std::vector<nbre::NBREIR> &irs,
   ss << func_name;
   return ss.str();
 }
-
-void jit_driver::shrink_instances() {
-  if (m_jit_instances.size() < 16)
-    return;
-
-  int32_t min_count = 30 * 60 + 1;
-  std::string min_key;
-  for (auto &pair : m_jit_instances) {
-    if (pair.second->m_time_counter < min_count && !pair.second->m_using) {
-      min_count = pair.second->m_time_counter;
-      min_key = pair.first;
-    }
-  }
-  if (!min_key.empty()) {
-    m_jit_instances.erase(min_key);
-  }
-}
 } // namespace neb
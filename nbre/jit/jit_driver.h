@@ -23,7 +23,11 @@
 #include "core/ir_warden.h"
 #include "fs/proto/ir.pb.h"
 #include "jit/jit_engine.h"
+#include "jit/jit_object_cache.h"
+#include "util/quitable_thread.h"
 #include "util/singleton.h"
+#include <future>
+#include <list>
 
 namespace neb {
 namespace internal {
@@ -66,12 +70,10 @@ public:
     irs.push_back(ir);
     std::string key = gen_key(irs, func_name);
     std::unique_lock<std::mutex> _l(m_mutex);
-    auto it = m_jit_instances.find(key);
-    if (it == m_jit_instances.end())
+    //! the copy keeps the context alive even if it's evicted meanwhile
+    std::shared_ptr<jit_context> context = find_and_touch(key);
+    if (!context)
       return std::make_pair(false, RT());
-
-    auto &context = it->second;
-    context->m_time_counter = 30 * 60;
     _l.unlock();
     return std::make_pair(true, context->m_jit.run<RT>(args...));
   }
@@ -79,42 +81,66 @@ public:
   template <typename RT, typename... ARGS>
   RT run(const std::string &ir_key, const std::vector<nbre::NBREIR> &irs,
          const std::string &func_name, ARGS... args) {
-    std::string key = ir_key;
-    m_mutex.lock();
-    auto it = m_jit_instances.find(key);
-    if (it == m_jit_instances.end()) {
-      shrink_instances();
-      m_jit_instances.insert(std::make_pair(key, make_context(irs, func_name)));
-      it = m_jit_instances.find(key);
-    }
-    auto &context = it->second;
-    context->m_time_counter = 30 * 60;
-    m_mutex.unlock();
-    struct using_helper {
-      using_helper(jit_context *jc) : m_jc(jc) { jc->m_using = true; }
-      ~using_helper() { m_jc->m_using = false; }
-      jit_context *m_jc;
-    } _ul(context.get());
-    context->m_using = true;
+    std::shared_ptr<jit_context> context =
+        find_or_make_context(ir_key, irs, func_name, true);
     LOG(INFO) << "ir key " << ir_key << " irs size " << irs.size()
               << " func_name " << func_name;
     return context->m_jit.run<RT>(args...);
   }
 
+  //! log stats every while, called every second
   void timer_callback();
 
-protected:
-  void shrink_instances();
+  //! keep compiled objects in storage, usually the NBRE DB
+  void set_object_storage(fs::storage *storage);
 
-  std::string gen_key(const std::vector<nbre::NBREIR> &irs,
-                      const std::string &func_name);
+  //! make the context of ir_key in background, so that the first run of a
+  //! newly deployed IR doesn't parse and set up the JIT
+  void precompile(const std::string &ir_key,
+                  const std::vector<nbre::NBREIR> &irs,
+                  const std::string &func_name);
+
+  struct stats_t {
+    //! runs which found a context, or had to make one
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+    //! contexts made by runs and precompile, and time spent, in microseconds
+    uint64_t m_compiles = 0;
+    uint64_t m_compile_time = 0;
+    //! of contexts in cache now
+    uint64_t m_instances = 0;
+    uint64_t m_code_size = 0;
+  };
+  stats_t stats() const;
 
+protected:
   struct jit_context {
-    llvm::LLVMContext m_context;
+    //! one per module, so that modules are parsed in parallel
+    std::vector<std::unique_ptr<llvm::LLVMContext>> m_contexts;
     jit::jit_engine m_jit;
-    int32_t m_time_counter;
-    bool m_using;
+    uint64_t m_code_size;
+    //! in microseconds
+    uint64_t m_compile_time;
   };
+  typedef std::shared_ptr<jit_context> jit_context_ptr_t;
+  typedef std::list<std::pair<std::string, jit_context_ptr_t>> lru_list_t;
+
+  //! with m_mutex, move key to the front of the LRU list if it's there
+  jit_context_ptr_t find_and_touch(const std::string &key);
+  //! the context of key, made without m_mutex if it's missing, callers
+  //! missing the same key meanwhile wait for that one. Runs count hits and
+  //! misses, precompile doesn't.
+  jit_context_ptr_t find_or_make_context(const std::string &key,
+                                         const std::vector<nbre::NBREIR> &irs,
+                                         const std::string &func_name,
+                                         bool is_run);
+  //! with m_mutex, evict the least recently used contexts till the code size
+  //! fits configuration::jit_cache_size(), but contexts in use and key
+  void insert_and_shrink(const std::string &key, jit_context_ptr_t context);
+
+  std::string gen_key(const std::vector<nbre::NBREIR> &irs,
+                      const std::string &func_name);
 
   std::unique_ptr<jit_driver::jit_context>
   make_context(const std::vector<nbre::NBREIR> &irs,
@@ -124,7 +150,17 @@ protected:
                      std::string &mangling_name);
 
 protected:
-  std::mutex m_mutex;
-  std::unordered_map<std::string, std::unique_ptr<jit_context>> m_jit_instances;
+  mutable std::mutex m_mutex;
+  //! most recently used first, shared with the runs in progress, which call
+  //! without m_mutex
+  lru_list_t m_lru_list;
+  std::unordered_map<std::string, lru_list_t::iterator> m_jit_instances;
+  //! contexts being made, keyed like m_jit_instances
+  std::unordered_map<std::string, std::shared_future<jit_context_ptr_t>>
+      m_making_contexts;
+  stats_t m_stats;
+  int32_t m_stats_log_counter;
+  jit::jit_object_cache m_object_cache;
+  util::wakeable_thread m_precompile_thread;
 }; // end class jit_driver;
 } // end namespace neb
@@ -24,7 +24,7 @@ namespace jit {
 using namespace llvm;
 
 void jit_engine::init(std::vector<std::unique_ptr<Module>> ms,
-                      const std::string &func_name) {
+                      const std::string &func_name, ObjectCache *obj_cache) {
   m_modules = std::move(ms);
   m_func_name = func_name;
   // Grab a target machine and try to build a factory function for the
@@ -55,11 +55,13 @@ void jit_engine::init(std::vector<std::unique_ptr<Module>> ms,
         "No indirect stubs manager available for target");
   }
 
-  // Everything looks good. Build the JIT.
+  // Everything looks good. Build the JIT, which compiles whole modules
+  // rather than functions on demand, see run().
   bool OrcInlineStubs = true;
+  bool OrcLazy = false;
   m_jit = std::make_unique<OrcLazyJIT>(
       std::move(TM), std::move(CompileCallbackMgr),
-      std::move(IndirectStubsMgrBuilder), OrcInlineStubs);
+      std::move(IndirectStubsMgrBuilder), OrcInlineStubs, obj_cache, OrcLazy);
 
   // Add the module, look up main and run it.
   for (auto &M : m_modules) {
@@ -76,6 +78,13 @@ void jit_engine::init(std::vector<std::unique_ptr<Module>> ms,
     m_main_sym = std::make_unique<llvm::JITSymbol>(
         m_jit->findSymbol(std::string(m_func_name, std::allocator<char>())));
     if (*m_main_sym) {
+      // compile and link now, instead of in the first run
+      auto addr = m_main_sym->getAddress();
+      if (!addr) {
+        logAllUnhandledErrors(addr.takeError(), llvm::errs(), "");
+        throw neb::jit_internal_failure("Failed to compile target function");
+      }
+      m_main_addr = *addr;
       return;
     } else if (auto Err = m_main_sym->takeError()) {
       logAllUnhandledErrors(std::move(Err), llvm::errs(), "");
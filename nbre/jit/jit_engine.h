@@ -24,21 +24,29 @@
 namespace neb {
 namespace jit {
 using namespace llvm;
+//! Compiles all modules in init, so run is re-entrant: the function is
+//! called at a fixed address without lock, and every call keeps its state on
+//! its own stack. The compiled code is supposed to have no mutable globals.
 class jit_engine {
 public:
+  jit_engine() : m_main_addr(0) {}
 
-  template <typename RT, typename... ARGS> RT run(ARGS... args) {
-    std::unique_lock<std::mutex> _l(m_mutex);
+  template <typename RT, typename... ARGS> RT run(ARGS... args) const {
     using MainFnPtr = RT (*)(ARGS...);
-    auto main_func = fromTargetAddress<MainFnPtr>(
-        cantFail(m_main_sym->getAddress(), nullptr));
+    auto main_func = fromTargetAddress<MainFnPtr>(m_main_addr);
     if (nullptr == main_func)
       return RT();
     return main_func(args...);
   }
 
+  //! bytes of code and data sections, known once init returns
+  inline uint64_t code_size() const {
+    return m_jit ? m_jit->getCodeSize() : 0;
+  }
+
+  //! obj_cache, if any, is used to load and keep compiled objects
   void init(std::vector<std::unique_ptr<Module>> ms,
-            const std::string &func_name);
+            const std::string &func_name, ObjectCache *obj_cache = nullptr);
 
 protected:
   template <typename PtrTy>
@@ -52,9 +60,9 @@ protected:
   std::unique_ptr<llvm::EngineBuilder> m_EB;
   std::unique_ptr<Triple> m_T;
   std::unique_ptr<OrcLazyJIT> m_jit;
-  std::mutex m_mutex;
 
   std::unique_ptr<llvm::JITSymbol> m_main_sym;
+  llvm::JITTargetAddress m_main_addr;
 }; // end class jit_engine
 } // namespace jit
 } // namespace neb
@@ -0,0 +1,57 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#pragma once
+#include "common/common.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include <atomic>
+
+namespace neb {
+namespace jit {
+
+//! SectionMemoryManager which adds the size of every section it allocates to
+//! a counter, shared by all objects of one OrcLazyJIT, so that jit_driver can
+//! tell how much memory the code of a context takes.
+class jit_memory_manager : public llvm::SectionMemoryManager {
+public:
+  jit_memory_manager(std::atomic<uint64_t> &allocated)
+      : m_allocated(allocated) {}
+
+  virtual uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment,
+                                       unsigned SectionID,
+                                       llvm::StringRef SectionName) {
+    m_allocated += Size;
+    return llvm::SectionMemoryManager::allocateCodeSection(
+        Size, Alignment, SectionID, SectionName);
+  }
+
+  virtual uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment,
+                                       unsigned SectionID,
+                                       llvm::StringRef SectionName,
+                                       bool IsReadOnly) {
+    m_allocated += Size;
+    return llvm::SectionMemoryManager::allocateDataSection(
+        Size, Alignment, SectionID, SectionName, IsReadOnly);
+  }
+
+private:
+  std::atomic<uint64_t> &m_allocated;
+}; // end class jit_memory_manager
+} // namespace jit
+} // namespace neb
@@ -0,0 +1,83 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "jit/jit_object_cache.h"
+#include "crypto/hash.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace neb {
+namespace jit {
+
+static const char *object_key_prefix = "jit_object_";
+
+jit_object_cache::jit_object_cache() : m_storage(nullptr) {}
+
+std::string jit_object_cache::module_key(const llvm::Module *M) {
+  llvm::SmallVector<char, 0> buf;
+  llvm::raw_svector_ostream os(buf);
+  llvm::WriteBitcodeToFile(M, os);
+  os << LLVM_VERSION_STRING << llvm::sys::getHostCPUName();
+
+  auto h = crypto::sha3_256_hash(
+      bytes(reinterpret_cast<const byte_t *>(buf.data()), buf.size()));
+  return object_key_prefix + h.to_hex();
+}
+
+void jit_object_cache::notifyObjectCompiled(const llvm::Module *M,
+                                            llvm::MemoryBufferRef Obj) {
+  fs::storage *storage = m_storage;
+  if (!storage) {
+    return;
+  }
+  try {
+    storage->put(module_key(M),
+                 bytes(reinterpret_cast<const byte_t *>(Obj.getBufferStart()),
+                       Obj.getBufferSize()));
+  } catch (const std::exception &e) {
+    LOG(WARNING) << "failed to cache object of " << M->getModuleIdentifier()
+                 << ", " << e.what();
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+jit_object_cache::getObject(const llvm::Module *M) {
+  fs::storage *storage = m_storage;
+  if (!storage) {
+    return nullptr;
+  }
+  std::unique_ptr<llvm::MemoryBuffer> ret;
+  try {
+    storage->read_bytes(string_to_byte(module_key(M)),
+                        [&ret, M](const byte_t *value, size_t size) {
+                          ret = llvm::MemoryBuffer::getMemBufferCopy(
+                              llvm::StringRef(
+                                  reinterpret_cast<const char *>(value), size),
+                              M->getModuleIdentifier());
+                        });
+  } catch (const std::exception &e) {
+    //! not compiled yet
+    return nullptr;
+  }
+  return ret;
+}
+} // namespace jit
+} // namespace neb
@@ -0,0 +1,52 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#pragma once
+#include "common/common.h"
+#include "fs/storage.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <atomic>
+
+namespace neb {
+namespace jit {
+
+//! Object code compiled by OrcLazyJIT, kept in a storage (the NBRE DB) and
+//! keyed by the hash of the module's bitcode, LLVM version and host CPU. A
+//! restarted NBRE thus loads the objects of known IRs instead of running
+//! codegen again. Without a storage, nothing is cached.
+class jit_object_cache : public llvm::ObjectCache {
+public:
+  jit_object_cache();
+
+  inline void set_storage(fs::storage *storage) { m_storage = storage; }
+
+  virtual void notifyObjectCompiled(const llvm::Module *M,
+                                    llvm::MemoryBufferRef Obj);
+
+  virtual std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *M);
+
+  static std::string module_key(const llvm::Module *M);
+
+private:
+  std::atomic<fs::storage *> m_storage;
+}; // end class jit_object_cache
+} // namespace jit
+} // namespace neb
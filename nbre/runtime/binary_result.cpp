@@ -0,0 +1,153 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "runtime/binary_result.h"
+#include <cstring>
+
+namespace neb {
+namespace rt {
+
+static_assert(sizeof(floatxx_t::value_type) == sizeof(uint32_t),
+              "binary result stores floatxx_t as 4 bytes");
+
+bool binary_result::is_binary_result(const std::string &data,
+                                     uint32_t magic) {
+  return data.size() >= header_size &&
+         byte_to_number<uint32_t>(
+             reinterpret_cast<byte_t *>(const_cast<char *>(data.data())),
+             sizeof(uint32_t)) == magic;
+}
+
+binary_result_writer::binary_result_writer(uint32_t magic, size_t record_size,
+                                           size_t record_num,
+                                           const std::string &meta_info_json)
+    : m_record_size(record_size), m_record_num(record_num) {
+  m_buf.resize(binary_result::header_size + record_size * record_num, 0);
+  byte_t *p = reinterpret_cast<byte_t *>(&m_buf[0]);
+
+  uint8_t flags = 0;
+  uint64_t heights[3] = {0, 0, 0};
+  if (!meta_info_json.empty()) {
+    flags |= binary_result::has_meta_info;
+    auto meta_info = json_to_meta_info(meta_info_json);
+    for (size_t i = 0; i < 3; i++) {
+      heights[i] = std::stoull(meta_info[i].second);
+    }
+  }
+
+  write_number<uint32_t>(p, magic);
+  write_number<uint8_t>(p + 4, binary_result::format_version);
+  write_number<uint8_t>(p + 5, flags);
+  write_number<uint64_t>(p + 8, heights[0]);
+  write_number<uint64_t>(p + 16, heights[1]);
+  write_number<uint64_t>(p + 24, heights[2]);
+  write_number<uint32_t>(p + 32, record_num);
+}
+
+void binary_result_writer::write_address(byte_t *p, const address_t &addr) {
+  p[0] = addr.size();
+  std::memcpy(p + 1, addr.value(), addr.size());
+}
+
+void binary_result_writer::write_float(byte_t *p, const floatxx_t &v) {
+  typename floatxx_t::value_type t = v;
+  uint32_t bits;
+  std::memcpy(&bits, &t, sizeof(bits));
+  write_number<uint32_t>(p, bits);
+}
+
+void binary_result_writer::write_string(byte_t *p, const std::string &s) {
+  write_number<uint32_t>(p, m_strings.size());
+  write_number<uint32_t>(p + 4, s.size());
+  m_strings.append(s);
+}
+
+str_uptr_t binary_result_writer::finish() {
+  byte_t *p = reinterpret_cast<byte_t *>(&m_buf[0]);
+  write_number<uint32_t>(p + 36, m_strings.size());
+  auto ret = std::make_unique<std::string>(std::move(m_buf));
+  ret->append(m_strings);
+  return ret;
+}
+
+binary_result_view::binary_result_view(const byte_t *data, size_t size,
+                                       uint32_t magic, size_t record_size)
+    : m_data(data), m_size(size), m_record_size(record_size) {
+  if (size < binary_result::header_size ||
+      read_number<uint32_t>(data) != magic) {
+    throw std::invalid_argument("not a binary result");
+  }
+  if (read_number<uint8_t>(data + 4) != binary_result::format_version) {
+    throw std::invalid_argument("unsupported binary result version");
+  }
+  m_flags = read_number<uint8_t>(data + 5);
+  m_start_height = read_number<uint64_t>(data + 8);
+  m_end_height = read_number<uint64_t>(data + 16);
+  m_version = read_number<uint64_t>(data + 24);
+  m_record_num = read_number<uint32_t>(data + 32);
+  m_string_table_size = read_number<uint32_t>(data + 36);
+
+  if (binary_result::header_size + uint64_t(m_record_num) * record_size +
+          m_string_table_size !=
+      size) {
+    throw std::invalid_argument("binary result with invalid size");
+  }
+}
+
+std::string binary_result_view::meta_info_json() const {
+  if (!has_meta_info()) {
+    return std::string();
+  }
+  std::vector<std::pair<std::string, std::string>> meta_info;
+  meta_info.push_back(
+      std::make_pair("start_height", std::to_string(m_start_height)));
+  meta_info.push_back(
+      std::make_pair("end_height", std::to_string(m_end_height)));
+  meta_info.push_back(std::make_pair("version", std::to_string(m_version)));
+  return meta_info_to_json(meta_info);
+}
+
+address_t binary_result_view::read_address(const byte_t *p) {
+  size_t len = p[0];
+  if (len > NAS_ADDRESS_LEN) {
+    throw std::invalid_argument("binary result with invalid address");
+  }
+  return address_t(p + 1, len);
+}
+
+floatxx_t binary_result_view::read_float(const byte_t *p) {
+  uint32_t bits = read_number<uint32_t>(p);
+  typename floatxx_t::value_type t;
+  std::memcpy(&t, &bits, sizeof(bits));
+  return floatxx_t(t);
+}
+
+std::string binary_result_view::read_string(const byte_t *p) const {
+  uint32_t offset = read_number<uint32_t>(p);
+  uint32_t len = read_number<uint32_t>(p + 4);
+  if (uint64_t(offset) + len > m_string_table_size) {
+    throw std::invalid_argument("binary result with invalid string");
+  }
+  const byte_t *strings =
+      m_data + binary_result::header_size + m_record_num * m_record_size;
+  return std::string(reinterpret_cast<const char *>(strings + offset), len);
+}
+} // namespace rt
+} // namespace neb
@@ -0,0 +1,128 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include "common/address.h"
+#include "common/common.h"
+#include "runtime/util.h"
+
+namespace neb {
+namespace rt {
+
+//! Versioned binary layout of NR and DIP results, as kept in RocksDB and in
+//! memory instead of JSON. It is a fixed size header, then fixed width
+//! records, then a string table, all numbers are big endian. Field i of
+//! record k is at a known offset, hence a view reads it in place, from a
+//! RocksDB value or shared memory, without decoding the whole result.
+//!
+//!   header  magic(4) format_version(1) flags(1) reserved(2)
+//!           start_height(8) end_height(8) version(8)
+//!           record_num(4) string_table_size(4)
+//!   records record_num * record_size bytes
+//!   strings string_table_size bytes, referred by (offset, size) of records
+class binary_result {
+public:
+  static constexpr uint8_t format_version = 1;
+  static constexpr size_t header_size = 40;
+  //! address size(1) and bytes(NAS_ADDRESS_LEN)
+  static constexpr size_t address_size = 1 + NAS_ADDRESS_LEN;
+
+  //! flags
+  static constexpr uint8_t has_meta_info = 0x1;
+
+  static bool is_binary_result(const std::string &data, uint32_t magic);
+};
+
+class binary_result_writer {
+public:
+  //! meta_info_json is as std::get<1> of nr_ret_type and dip_ret_type, may be
+  //! empty
+  binary_result_writer(uint32_t magic, size_t record_size, size_t record_num,
+                       const std::string &meta_info_json);
+
+  inline byte_t *record(size_t i) {
+    return reinterpret_cast<byte_t *>(&m_buf[0]) +
+           binary_result::header_size + i * m_record_size;
+  }
+
+  template <typename T> static void write_number(byte_t *p, T v) {
+    number_to_byte(v, p, sizeof(T));
+  }
+  static void write_address(byte_t *p, const address_t &addr);
+  static void write_float(byte_t *p, const floatxx_t &v);
+  //! append s to the string table, write its (offset, size) to p
+  void write_string(byte_t *p, const std::string &s);
+
+  str_uptr_t finish();
+
+private:
+  size_t m_record_size;
+  size_t m_record_num;
+  std::string m_buf;
+  std::string m_strings;
+};
+
+class binary_result_view {
+public:
+  //! throw std::invalid_argument if data isn't a well formed result with
+  //! magic and record_size
+  binary_result_view(const byte_t *data, size_t size, uint32_t magic,
+                     size_t record_size);
+
+  inline size_t size() const { return m_record_num; }
+  inline bool has_meta_info() const {
+    return m_flags & binary_result::has_meta_info;
+  }
+  inline block_height_t start_height() const { return m_start_height; }
+  inline block_height_t end_height() const { return m_end_height; }
+  inline uint64_t version() const { return m_version; }
+
+  //! same as meta_info_to_json, empty if no meta info
+  std::string meta_info_json() const;
+
+protected:
+  inline const byte_t *record(size_t i) const {
+    if (i >= m_record_num) {
+      throw std::out_of_range("binary result record out of range");
+    }
+    return m_data + binary_result::header_size + i * m_record_size;
+  }
+
+  template <typename T> static T read_number(const byte_t *p) {
+    return byte_to_number<T>(const_cast<byte_t *>(p), sizeof(T));
+  }
+  static address_t read_address(const byte_t *p);
+  static floatxx_t read_float(const byte_t *p);
+  //! read the string which (offset, size) is at p
+  std::string read_string(const byte_t *p) const;
+
+  const byte_t *m_data;
+  size_t m_size;
+  size_t m_record_size;
+  uint8_t m_flags;
+  block_height_t m_start_height;
+  block_height_t m_end_height;
+  uint64_t m_version;
+  uint32_t m_record_num;
+  uint32_t m_string_table_size;
+};
+} // namespace rt
+} // namespace neb
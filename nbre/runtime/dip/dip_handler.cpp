@@ -42,9 +42,22 @@ dip_handler::dip_handler() : m_has_curr(false) {
 void dip_handler::check_dip_params(block_height_t height) {
 
   if (!m_has_curr && m_incoming.empty()) {
-    load_storage("dip_rewards", m_dip_reward);
-    load_storage("nr_results", m_nr_result, 1 << 4);
-    load_storage("nr_sums", m_nr_sum, 1 << 4);
+    load_storage("dip_rewards", m_dip_reward,
+                 [](const std::string &json) {
+                   return dip_reward::dip_info_to_binary(
+                       dip_reward::json_to_dip_info(json));
+                 });
+    load_storage("nr_results", m_nr_result,
+                 [](const std::string &json) {
+                   return nr::nebulas_rank::nr_info_to_binary(
+                       nr::nebulas_rank::json_to_nr_info(json));
+                 },
+                 1 << 4);
+    load_storage("nr_sums", m_nr_sum,
+                 [](const std::string &json) {
+                   return std::make_unique<std::string>(json);
+                 },
+                 1 << 4);
     auto dip_versions_ptr = neb::fs::ir_api::get_ir_versions("dip", m_storage);
     if (dip_versions_ptr->empty()) {
       return;
@@ -149,21 +162,24 @@ void dip_handler::start(neb::block_height_t height,
   try {
     auto dip_ret = run_dip_ir(dip_name, dip_version, hash_height, hash_height);
     if (std::get<0>(dip_ret)) {
-      auto dip_str_ptr = dip_reward::dip_info_to_json(dip_ret);
-      dump_storage("dip_rewards", hash_height,
-                   str_sptr_t{std::move(dip_str_ptr)}, m_dip_reward);
-      LOG(INFO) << "dump dip rewards done";
-
-      auto &nr_ret = std::get<3>(dip_ret);
-      auto nr_str_ptr = nr::nebulas_rank::nr_info_to_json(nr_ret);
-      dump_storage("nr_results", hash_height, str_sptr_t{std::move(nr_str_ptr)},
-                   m_nr_result, 1 << 4);
-      LOG(INFO) << "dump nr results done";
-
-      auto nr_sum_ptr = nr::nebulas_rank::get_nr_sum_str(nr_ret);
-      dump_storage("nr_sums", hash_height, str_sptr_t{std::move(nr_sum_ptr)},
-                   m_nr_sum, 1 << 4);
-      LOG(INFO) << "dump nr sums done";
+      // results of a height are written together
+      m_storage->batch_write([&]() {
+        auto dip_str_ptr = dip_reward::dip_info_to_binary(dip_ret);
+        dump_storage("dip_rewards", hash_height,
+                     str_sptr_t{std::move(dip_str_ptr)}, m_dip_reward);
+        LOG(INFO) << "dump dip rewards done";
+
+        auto &nr_ret = std::get<3>(dip_ret);
+        auto nr_str_ptr = nr::nebulas_rank::nr_info_to_binary(nr_ret);
+        dump_storage("nr_results", hash_height,
+                     str_sptr_t{std::move(nr_str_ptr)}, m_nr_result, 1 << 4);
+        LOG(INFO) << "dump nr results done";
+
+        auto nr_sum_ptr = nr::nebulas_rank::get_nr_sum_str(nr_ret);
+        dump_storage("nr_sums", hash_height,
+                     str_sptr_t{std::move(nr_sum_ptr)}, m_nr_sum, 1 << 4);
+        LOG(INFO) << "dump nr sums done";
+      });
     } else {
       LOG(INFO) << std::get<1>(dip_ret);
     }
@@ -276,8 +292,9 @@ str_sptr_t dip_handler::get_dip_reward(neb::block_height_t height) {
   LOG(INFO) << "dip reward exists";
   auto ret = m_dip_reward.try_get_val(hash_height);
   assert(ret.first);
-  LOG(INFO) << *ret.second;
-  return ret.second;
+  str_sptr_t json_ptr = dip_reward::dip_binary_to_json(*ret.second);
+  LOG(INFO) << *json_ptr;
+  return json_ptr;
 }
 
 str_sptr_t dip_handler::get_nr_result(neb::block_height_t height) {
@@ -291,8 +308,9 @@ str_sptr_t dip_handler::get_nr_result(neb::block_height_t height) {
   }
   assert(ret.first);
   auto &tmp = ret.second;
-  LOG(INFO) << *tmp.second;
-  return tmp.second;
+  str_sptr_t json_ptr = nr::nebulas_rank::nr_binary_to_json(*tmp.second);
+  LOG(INFO) << *json_ptr;
+  return json_ptr;
 }
 
 str_sptr_t dip_handler::get_nr_sum(neb::block_height_t height) {
@@ -309,6 +327,13 @@ str_sptr_t dip_handler::get_nr_sum(neb::block_height_t height) {
   return tmp.second;
 }
 
+neb::bytes dip_handler::storage_key(const std::string &key,
+                                    block_height_t height) {
+  neb::bytes ret = neb::string_to_byte(key + "_");
+  ret.append_bytes(neb::number_to_byte<neb::bytes>(height));
+  return ret;
+}
+
 void dip_handler::dump_storage(
     const std::string &key, neb::block_height_t hash_height,
     const str_sptr_t &val_ptr,
@@ -316,48 +341,12 @@ void dip_handler::dump_storage(
     size_t storage_max_size) {
   std::unique_lock<std::mutex> _l(m_mutex);
 
-  auto update_to_storage = [](const std::string &key,
-                              const boost::property_tree::ptree &val_pt,
-                              neb::fs::rocksdb_storage *rs) {
-    std::stringstream ss;
-    boost::property_tree::json_parser::write_json(ss, val_pt, false);
-    rs->put(key, neb::string_to_byte(ss.str()));
-  };
-
   LOG(INFO) << "call func dump_storage";
-  neb::bytes val_bytes;
-  try {
-    val_bytes = m_storage->get(key);
-  } catch (const std::exception &e) {
-    LOG(INFO) << key << " empty " << e.what();
-
-    boost::property_tree::ptree ele, arr, root;
-    ele.put("", *val_ptr);
-    arr.push_back(std::make_pair("", ele));
-    root.add_child(key, arr);
-    update_to_storage(key, root, m_storage);
-
-    mem_cache.insert(hash_height, val_ptr);
-    LOG(INFO) << "insert " << key << "pair height " << hash_height << ", "
-              << *val_ptr;
-    return;
-  }
-
-  LOG(INFO) << key << " not empty";
-  boost::property_tree::ptree root;
-  std::stringstream ss(neb::byte_to_string(val_bytes));
-  boost::property_tree::json_parser::read_json(ss, root);
-
-  boost::property_tree::ptree &arr = root.get_child(key);
-  boost::property_tree::ptree ele;
-  ele.put("", *val_ptr);
-  arr.push_back(std::make_pair("", ele));
-  LOG(INFO) << "insert " << key;
-  update_to_storage(key, root, m_storage);
+  m_storage->put_bytes(storage_key(key, hash_height),
+                       neb::string_to_byte(*val_ptr));
 
   mem_cache.insert(hash_height, val_ptr);
-  LOG(INFO) << "insert " << key << " pair height " << hash_height << ", "
-            << *val_ptr;
+  LOG(INFO) << "insert " << key << " pair height " << hash_height;
 
   if (mem_cache.size() > storage_max_size) {
     auto first_ele = mem_cache.begin();
@@ -368,44 +357,64 @@ void dip_handler::dump_storage(
 void dip_handler::load_storage(
     const std::string &key,
     thread_safe_map<block_height_t, str_sptr_t> &mem_cache,
+    const std::function<str_uptr_t(const std::string &json)> &from_json,
     size_t storage_max_size) {
   std::unique_lock<std::mutex> _l(m_mutex);
 
   LOG(INFO) << "call func load_storage";
+  migrate_storage(key, from_json);
+
+  m_storage->scan(
+      storage_key(key, 0),
+      storage_key(key, std::numeric_limits<block_height_t>::max()),
+      [&](const neb::bytes &k, const neb::bytes &v) {
+        auto h = neb::byte_to_number<block_height_t>(
+            const_cast<neb::byte_t *>(k.value()) + key.size() + 1,
+            k.size() - key.size() - 1);
+        mem_cache.insert(h, std::make_shared<std::string>(
+                                neb::byte_to_string(v)));
+        LOG(INFO) << "insert " << key << " pair height " << h;
+
+        if (mem_cache.size() > storage_max_size) {
+          auto first_ele = mem_cache.begin();
+          mem_cache.erase(first_ele.first);
+        }
+      });
+}
+
+void dip_handler::migrate_storage(
+    const std::string &key,
+    const std::function<str_uptr_t(const std::string &json)> &from_json) {
   neb::bytes val_bytes;
   try {
     val_bytes = m_storage->get(key);
   } catch (const std::exception &e) {
-    LOG(INFO) << key << " empty " << e.what();
     return;
   }
 
-  LOG(INFO) << key << " not empty";
+  LOG(INFO) << "migrate " << key << " from json array";
   boost::property_tree::ptree root;
   std::stringstream ss(neb::byte_to_string(val_bytes));
   boost::property_tree::json_parser::read_json(ss, root);
 
-  BOOST_FOREACH (boost::property_tree::ptree::value_type &v,
-                 root.get_child(key)) {
-    boost::property_tree::ptree pt = v.second;
-    auto record_ptr =
-        std::make_shared<std::string>(pt.get<std::string>(std::string()));
-
-    boost::property_tree::ptree tmp_pt;
-    std::stringstream ss(*record_ptr);
-    boost::property_tree::json_parser::read_json(ss, tmp_pt);
-    block_height_t end_height = tmp_pt.get<block_height_t>("end_height");
-
-    auto h = end_height + 1;
-    mem_cache.insert(h, record_ptr);
-    LOG(INFO) << "insert " << key << " pair height " << h << ", "
-              << *record_ptr;
-
-    if (mem_cache.size() > storage_max_size) {
-      auto first_ele = mem_cache.begin();
-      mem_cache.erase(first_ele.first);
+  // written at once with the deletion of the legacy key
+  m_storage->batch_write([&]() {
+    BOOST_FOREACH (boost::property_tree::ptree::value_type &v,
+                   root.get_child(key)) {
+      boost::property_tree::ptree pt = v.second;
+      auto record = pt.get<std::string>(std::string());
+
+      boost::property_tree::ptree tmp_pt;
+      std::stringstream ss(record);
+      boost::property_tree::json_parser::read_json(ss, tmp_pt);
+      block_height_t end_height = tmp_pt.get<block_height_t>("end_height");
+
+      auto val_ptr = from_json(record);
+      m_storage->put_bytes(storage_key(key, end_height + 1),
+                           neb::string_to_byte(*val_ptr));
     }
-  }
+    m_storage->del(key);
+  });
 }
 
 dip_ret_type dip_handler::run_dip_ir(const std::string &name, version_t version,
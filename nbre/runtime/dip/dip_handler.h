@@ -65,13 +65,23 @@ private:
   dip_ret_type run_dip_ir(const std::string &name, version_t version,
                           block_height_t ir_height, block_height_t var_height);
 
-  void load_storage(const std::string &key,
-                    thread_safe_map<block_height_t, str_sptr_t> &mem_cache,
-                    size_t storage_max_size = 1024);
+  //! Each result is stored at its own key, see storage_key, NR results and
+  //! DIP rewards are in binary, see binary_result.h. Results stored as a JSON
+  //! array at key by older versions are converted by from_json first.
+  void load_storage(
+      const std::string &key,
+      thread_safe_map<block_height_t, str_sptr_t> &mem_cache,
+      const std::function<str_uptr_t(const std::string &json)> &from_json,
+      size_t storage_max_size = 1024);
   void dump_storage(const std::string &key, block_height_t height,
                     const str_sptr_t &val_ptr,
                     thread_safe_map<block_height_t, str_sptr_t> &mem_cache,
                     size_t storage_max_size = 1024);
+  void migrate_storage(
+      const std::string &key,
+      const std::function<str_uptr_t(const std::string &json)> &from_json);
+
+  static neb::bytes storage_key(const std::string &key, block_height_t height);
 
 private:
   neb::fs::rocksdb_storage *m_storage;
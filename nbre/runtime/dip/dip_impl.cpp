@@ -23,6 +23,7 @@
 #include "common/common.h"
 #include "common/configuration.h"
 #include "fs/blockchain/blockchain_api_test.h"
+#include "fs/storage_holder.h"
 #include "runtime/dip/dip_handler.h"
 #include "runtime/dip/dip_reward.h"
 #include "runtime/nr/impl/nebulas_rank.h"
@@ -40,15 +41,17 @@ dip_ret_type entry_point_dip_impl(compatible_uint64_t start_block,
                                   dip_float_t alpha, dip_float_t beta) {
 
   std::unique_ptr<neb::fs::blockchain_api_base> pba;
+  neb::fs::rocksdb_storage *index_storage = nullptr;
   if (neb::use_test_blockchain) {
     pba = std::unique_ptr<neb::fs::blockchain_api_base>(
         new neb::fs::blockchain_api_test());
   } else {
     pba = std::unique_ptr<neb::fs::blockchain_api_base>(
         new neb::fs::blockchain_api());
+    index_storage = neb::fs::storage_holder::instance().nbre_db_ptr();
   }
   nr::transaction_db_ptr_t tdb_ptr =
-      std::make_unique<neb::fs::transaction_db>(pba.get());
+      std::make_unique<neb::fs::transaction_db>(pba.get(), index_storage);
   nr::account_db_ptr_t adb_ptr =
       std::make_unique<neb::fs::account_db>(pba.get());
 
@@ -121,25 +121,27 @@ void dip_reward::full_fill_meta_info(
   }
 }
 
-str_uptr_t dip_reward::dip_info_to_json(const dip_ret_type &dip_ret) {
+str_uptr_t dip_reward::dip_infos_to_json(
+    const std::string &meta_info_json, size_t n,
+    const std::function<dip_info_t(size_t)> &get_info) {
 
   boost::property_tree::ptree root;
   boost::property_tree::ptree arr;
 
-  const auto &meta_info_json = std::get<1>(dip_ret);
-  const auto &meta_info = neb::rt::json_to_meta_info(meta_info_json);
-  if (!meta_info.empty()) {
-    full_fill_meta_info(meta_info, root);
+  if (!meta_info_json.empty()) {
+    const auto &meta_info = neb::rt::json_to_meta_info(meta_info_json);
+    if (!meta_info.empty()) {
+      full_fill_meta_info(meta_info, root);
+    }
   }
 
-  auto &dip_infos = std::get<2>(dip_ret);
-  if (dip_infos.empty()) {
+  if (!n) {
     boost::property_tree::ptree p;
     arr.push_back(std::make_pair(std::string(), p));
   }
 
-  for (auto &info_ptr : dip_infos) {
-    auto &info = *info_ptr;
+  for (size_t i = 0; i < n; i++) {
+    auto info = get_info(i);
     boost::property_tree::ptree p;
 
     std::vector<std::pair<std::string, std::string>> kv_pair(
@@ -161,6 +163,12 @@ str_uptr_t dip_reward::dip_info_to_json(const dip_ret_type &dip_ret) {
   return tmp_ptr;
 }
 
+str_uptr_t dip_reward::dip_info_to_json(const dip_ret_type &dip_ret) {
+  auto &dip_infos = std::get<2>(dip_ret);
+  return dip_infos_to_json(std::get<1>(dip_ret), dip_infos.size(),
+                           [&dip_infos](size_t i) { return *dip_infos[i]; });
+}
+
 dip_ret_type dip_reward::json_to_dip_info(const std::string &dip_reward) {
 
   dip_ret_type dip_ret;
@@ -199,6 +207,51 @@ dip_ret_type dip_reward::json_to_dip_info(const std::string &dip_reward) {
   return dip_ret;
 }
 
+dip_result_view::dip_result_view(const byte_t *data, size_t size)
+    : binary_result_view(data, size, magic, record_size) {}
+
+dip_result_view::dip_result_view(const std::string &data)
+    : dip_result_view(reinterpret_cast<const byte_t *>(data.data()),
+                      data.size()) {}
+
+dip_info_t dip_result_view::info(size_t i) const {
+  return dip_info_t({deployer(i), contract(i), reward(i)});
+}
+
+str_uptr_t dip_reward::dip_info_to_binary(const dip_ret_type &dip_ret) {
+  auto &dip_infos = std::get<2>(dip_ret);
+  binary_result_writer w(dip_result_view::magic, dip_result_view::record_size,
+                         dip_infos.size(), std::get<1>(dip_ret));
+  for (size_t i = 0; i < dip_infos.size(); i++) {
+    const dip_info_t &info = *dip_infos[i];
+    byte_t *p = w.record(i);
+    w.write_address(p + dip_result_view::deployer_offset, info.m_deployer);
+    w.write_address(p + dip_result_view::contract_offset, info.m_contract);
+    w.write_string(p + dip_result_view::reward_offset, info.m_reward);
+  }
+  return w.finish();
+}
+
+dip_ret_type dip_reward::binary_to_dip_info(const std::string &dip_reward) {
+  dip_result_view view(dip_reward);
+
+  dip_ret_type dip_ret;
+  std::get<0>(dip_ret) = 0;
+  std::get<1>(dip_ret) = view.meta_info_json();
+  auto &infos = std::get<2>(dip_ret);
+  infos.reserve(view.size());
+  for (size_t i = 0; i < view.size(); i++) {
+    infos.push_back(std::make_shared<dip_info_t>(view.info(i)));
+  }
+  return dip_ret;
+}
+
+str_uptr_t dip_reward::dip_binary_to_json(const std::string &dip_reward) {
+  dip_result_view view(dip_reward);
+  return dip_infos_to_json(view.meta_info_json(), view.size(),
+                           [&view](size_t i) { return view.info(i); });
+}
+
 std::unique_ptr<
     std::unordered_map<address_t, std::unordered_map<address_t, uint32_t>>>
 dip_reward::account_call_contract_count(
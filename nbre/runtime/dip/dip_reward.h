@@ -39,6 +39,36 @@ using dip_ret_type =
     std::tuple<int32_t, std::string, std::vector<std::shared_ptr<dip_info_t>>,
                nr::nr_ret_type>;
 
+//! In place reader of DIP results encoded by dip_reward::dip_info_to_binary,
+//! a record is deployer(27) contract(27) padding(2) reward(8), reward refers
+//! to the string table.
+class dip_result_view : public binary_result_view {
+public:
+  static constexpr uint32_t magic = 0x4e424450; // "NBDP"
+  //! record layout, shared by the writer, a string reference takes 8 bytes
+  static constexpr size_t deployer_offset = 0;
+  static constexpr size_t contract_offset = binary_result::address_size;
+  static constexpr size_t reward_offset =
+      contract_offset + binary_result::address_size + 2;
+  static constexpr size_t record_size = reward_offset + 8;
+  static_assert(record_size == 64, "DIP result format changed");
+
+  dip_result_view(const byte_t *data, size_t size);
+  dip_result_view(const std::string &data);
+
+  inline address_t deployer(size_t i) const {
+    return read_address(record(i) + deployer_offset);
+  }
+  inline address_t contract(size_t i) const {
+    return read_address(record(i) + contract_offset);
+  }
+  inline std::string reward(size_t i) const {
+    return read_string(record(i) + reward_offset);
+  }
+
+  dip_info_t info(size_t i) const;
+};
+
 class dip_reward {
 public:
   static auto
@@ -52,6 +82,12 @@ public:
   static str_uptr_t dip_info_to_json(const dip_ret_type &dip_ret);
   static dip_ret_type json_to_dip_info(const std::string &dip_reward);
 
+  //! DIP results are stored and cached in binary, see dip_result_view, JSON
+  //! is made only when a caller asks for it.
+  static str_uptr_t dip_info_to_binary(const dip_ret_type &dip_ret);
+  static dip_ret_type binary_to_dip_info(const std::string &dip_reward);
+  static str_uptr_t dip_binary_to_json(const std::string &dip_reward);
+
 #ifdef Release
 private:
 #else
@@ -83,6 +119,10 @@ public:
       const std::vector<std::pair<std::string, std::string>> &meta,
       boost::property_tree::ptree &root);
 
+  static str_uptr_t
+  dip_infos_to_json(const std::string &meta_info_json, size_t n,
+                    const std::function<dip_info_t(size_t)> &get_info);
+
   static void
   back_to_coinbase(std::vector<std::shared_ptr<dip_info_t>> &dip_infos,
                    floatxx_t reward_left, const address_t &coinbase_addr);
@@ -21,6 +21,7 @@
 #include "runtime/nr/graph/algo.h"
 #include "common/math.h"
 #include "util/chrono.h"
+#include <ff/functionflow.h>
 #include <stack>
 
 namespace neb {
@@ -342,7 +343,7 @@ void graph_algo::merge_edges_with_same_from_and_same_to(
 transaction_graph *graph_algo::merge_two_graphs(transaction_graph *tg,
                                                 const transaction_graph *sg) {
 
-  transaction_graph::internal_graph_t sgi = sg->internal_graph();
+  const transaction_graph::internal_graph_t &sgi = sg->internal_graph();
   transaction_graph::viterator_t vi, vi_end;
 
   for (boost::tie(vi, vi_end) = boost::vertices(sgi); vi != vi_end; vi++) {
@@ -374,6 +375,47 @@ graph_algo::merge_graphs(const std::vector<transaction_graph_ptr_t> &graphs) {
   return nullptr;
 }
 
+transaction_graph_ptr_t
+graph_algo::merge_graphs(const std::vector<const transaction_graph *> &graphs) {
+  if (graphs.empty()) {
+    return std::make_unique<transaction_graph>();
+  }
+  // as merge_graphs on graphs[0], which keeps its vertices without edges
+  transaction_graph_ptr_t ret =
+      std::make_unique<transaction_graph>(*graphs.front());
+  for (auto it = graphs.begin() + 1; it != graphs.end(); it++) {
+    merge_two_graphs(ret.get(), *it);
+  }
+  return ret;
+}
+
+transaction_graph *graph_algo::merge_graphs_in_tree(
+    const std::vector<transaction_graph_ptr_t> &graphs, bool parallel) {
+  if (graphs.empty()) {
+    return nullptr;
+  }
+
+  size_t graphs_size = graphs.size();
+  for (size_t stride = 1; stride < graphs_size; stride <<= 1) {
+    size_t pairs = (graphs_size - stride + (stride << 1) - 1) / (stride << 1);
+    auto merge_pair = [&graphs, stride](size_t i) {
+      size_t left = i * (stride << 1);
+      merge_two_graphs(graphs[left].get(), graphs[left + stride].get());
+    };
+
+    if (parallel && pairs > 1) {
+      ff::paragroup pg;
+      pg.for_each(static_cast<size_t>(0), pairs, merge_pair);
+      ff::ff_wait(ff::all(pg));
+    } else {
+      for (size_t i = 0; i < pairs; i++) {
+        merge_pair(i);
+      }
+    }
+  }
+  return graphs.begin()->get();
+}
+
 void graph_algo::merge_topk_edges_with_same_from_and_same_to(
     transaction_graph::internal_graph_t &graph, uint32_t k) {
 
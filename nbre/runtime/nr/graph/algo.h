@@ -20,6 +20,7 @@
 #pragma once
 #include "common/address.h"
 #include "common/common.h"
+#include "runtime/nr/graph/csr_graph.h"
 #include "runtime/nr/graph/graph.h"
 
 namespace neb {
@@ -43,12 +44,31 @@ public:
   static void non_recursive_remove_cycles_based_on_time_sequence(
       transaction_graph::internal_graph_t &graph);
 
+  //! Same result as non_recursive_remove_cycles_based_on_time_sequence, with
+  //! acyclic parts pruned by strongly connected components and failed
+  //! searches reused, see decycle.cpp
+  static void fast_remove_cycles_based_on_time_sequence(
+      transaction_graph::internal_graph_t &graph);
+
   static void merge_edges_with_same_from_and_same_to(
       transaction_graph::internal_graph_t &graph);
 
   static transaction_graph *
   merge_graphs(const std::vector<transaction_graph_ptr_t> &graphs);
 
+  //! Merge graphs into a copy of the first one, the input graphs are left
+  //! untouched, the result is the same as merge_graphs above.
+  static transaction_graph_ptr_t
+  merge_graphs(const std::vector<const transaction_graph *> &graphs);
+
+  //! Merge graphs pairwise as a binary tree, stride 1, 2, 4, ..., the merge
+  //! pairs of each level run in parallel on functionflow runtime if parallel
+  //! is true. The pairing only depends on the graph index, thus the merged
+  //! graph has exactly the same (from, to, weight) edges as merge_graphs.
+  static transaction_graph *
+  merge_graphs_in_tree(const std::vector<transaction_graph_ptr_t> &graphs,
+                       bool parallel);
+
   static void merge_topk_edges_with_same_from_and_same_to(
       transaction_graph::internal_graph_t &graph, uint32_t k = 3);
 
@@ -73,6 +93,33 @@ public:
       std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
           &to_dead);
 
+  // overloads on csr_transaction_graph, see csr_algo.cpp
+  static void non_recursive_remove_cycles_based_on_time_sequence(
+      csr_transaction_graph &graph);
+
+  static void merge_edges_with_same_from_and_same_to(
+      csr_transaction_graph &graph);
+
+  static auto get_in_out_vals(const csr_transaction_graph &graph)
+      -> std::unique_ptr<std::unordered_map<address_t, in_out_val_t>>;
+
+  static auto get_stakes(const csr_transaction_graph &graph)
+      -> std::unique_ptr<std::unordered_map<address_t, wei_t>>;
+
+  static auto get_in_out_degrees(const csr_transaction_graph &graph)
+      -> std::unique_ptr<std::unordered_map<address_t, in_out_degree_t>>;
+
+  static auto get_degree_sum(const csr_transaction_graph &graph)
+      -> std::unique_ptr<std::unordered_map<address_t, uint32_t>>;
+
+  static bool decrease_graph_edges(
+      const csr_transaction_graph &graph,
+      std::unordered_set<transaction_graph::vertex_descriptor_t> &dead_v,
+      std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+          &dead_to,
+      std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+          &to_dead);
+
 #ifdef NDEBUG
 private:
 #else
@@ -108,6 +155,15 @@ public:
       std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
           &to_dead);
 
+  static void bfs_decrease_graph_edges(
+      const csr_transaction_graph &graph,
+      const std::unordered_set<transaction_graph::vertex_descriptor_t> &dead_v,
+      std::unordered_set<transaction_graph::vertex_descriptor_t> &tmp_dead,
+      std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+          &dead_to,
+      std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+          &to_dead);
+
   static void remove_a_cycle(
       transaction_graph::internal_graph_t &graph,
       const std::vector<transaction_graph::edge_descriptor_t> &edges);
@@ -0,0 +1,437 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "common/math.h"
+#include "runtime/nr/graph/algo.h"
+
+namespace neb {
+namespace rt {
+
+typedef csr_transaction_graph::vertex_id_t csr_vertex_t;
+typedef csr_transaction_graph::edge_id_t csr_edge_t;
+
+void graph_algo::bfs_decrease_graph_edges(
+    const csr_transaction_graph &graph,
+    const std::unordered_set<transaction_graph::vertex_descriptor_t> &dead_v,
+    std::unordered_set<transaction_graph::vertex_descriptor_t> &tmp_dead,
+    std::unordered_map<transaction_graph::vertex_descriptor_t, size_t> &dead_to,
+    std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+        &to_dead) {
+
+  std::queue<transaction_graph::vertex_descriptor_t> q;
+
+  auto is_alive = [&dead_v, &tmp_dead](csr_vertex_t v) {
+    return dead_v.find(v) == dead_v.end() && tmp_dead.find(v) == tmp_dead.end();
+  };
+  auto update_dead_to = [&graph, &is_alive, &dead_to](csr_vertex_t v) {
+    for (csr_edge_t e = graph.out_begin(v); e != graph.out_end(v); e++) {
+      if (graph.is_removed(e)) {
+        continue;
+      }
+      auto target = graph.target(e);
+      if (is_alive(target)) {
+        dead_to[target]++;
+      }
+    }
+  };
+  auto update_to_dead = [&graph, &is_alive, &to_dead](csr_vertex_t v) {
+    for (uint32_t i = graph.in_begin(v); i != graph.in_end(v); i++) {
+      csr_edge_t e = graph.in_edge(i);
+      if (graph.is_removed(e)) {
+        continue;
+      }
+      auto source = graph.source(e);
+      if (is_alive(source)) {
+        to_dead[source]++;
+      }
+    }
+  };
+
+  for (auto &v : tmp_dead) {
+    q.push(v);
+    update_dead_to(v);
+    update_to_dead(v);
+  }
+
+  while (!q.empty()) {
+    csr_vertex_t v = q.front();
+    q.pop();
+
+    for (csr_edge_t e = graph.out_begin(v); e != graph.out_end(v); e++) {
+      if (graph.is_removed(e)) {
+        continue;
+      }
+      auto target = graph.target(e);
+      if (is_alive(target)) {
+        auto ret = graph.in_degree(target);
+        auto it = dead_to.find(target);
+        if (ret && it != dead_to.end() && ret == it->second) {
+          q.push(target);
+          tmp_dead.insert(target);
+          update_dead_to(target);
+        }
+      }
+    }
+
+    for (uint32_t i = graph.in_begin(v); i != graph.in_end(v); i++) {
+      csr_edge_t e = graph.in_edge(i);
+      if (graph.is_removed(e)) {
+        continue;
+      }
+      auto source = graph.source(e);
+      if (is_alive(source)) {
+        auto ret = graph.out_degree(source);
+        auto it = to_dead.find(source);
+        if (ret && it != to_dead.end() && ret == it->second) {
+          q.push(source);
+          tmp_dead.insert(source);
+          update_to_dead(source);
+        }
+      }
+    }
+  }
+}
+
+bool graph_algo::decrease_graph_edges(
+    const csr_transaction_graph &graph,
+    std::unordered_set<transaction_graph::vertex_descriptor_t> &dead_v,
+    std::unordered_map<transaction_graph::vertex_descriptor_t, size_t> &dead_to,
+    std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+        &to_dead) {
+
+  std::unordered_set<transaction_graph::vertex_descriptor_t> tmp_dead;
+  for (csr_vertex_t v = 0; v < graph.vertex_num(); v++) {
+    if (dead_v.find(v) == dead_v.end()) {
+      if (!graph.in_degree(v) || !graph.out_degree(v)) {
+        tmp_dead.insert(v);
+      }
+    }
+  }
+  bfs_decrease_graph_edges(graph, dead_v, tmp_dead, dead_to, to_dead);
+  for (auto &tmp : tmp_dead) {
+    dead_v.insert(tmp);
+  }
+  return graph.vertex_num() != dead_v.size();
+}
+
+//! Port of non_recursive_remove_cycles_based_on_time_sequence_helper on
+//! csr_transaction_graph. Vertices, edge orders and the dead vertex
+//! bookkeeping are kept the same, so both remove exactly the same cycles.
+class csr_remove_cycles_based_on_time_sequence_helper {
+public:
+  csr_remove_cycles_based_on_time_sequence_helper(csr_transaction_graph &graph)
+      : m_graph(graph), m_visited(graph.vertex_num(), 0),
+        m_dead_edge(graph.edge_num(), 0) {}
+
+  void remove_cycles_based_on_time_sequence() {
+    auto start_nodes = possible_start_nodes_of_cycles();
+
+    std::vector<csr_edge_t> ret;
+    std::unordered_set<transaction_graph::vertex_descriptor_t> dead_v;
+    std::unordered_map<transaction_graph::vertex_descriptor_t, size_t> dead_to;
+    std::unordered_map<transaction_graph::vertex_descriptor_t, size_t> to_dead;
+
+    while (true) {
+      if (!graph_algo::decrease_graph_edges(m_graph, dead_v, dead_to,
+                                            to_dead)) {
+        break;
+      }
+      ret = find_a_cycle_based_on_time_sequence(start_nodes, dead_v, to_dead);
+      if (ret.empty()) {
+        break;
+      }
+      remove_a_cycle(ret);
+    }
+  }
+
+private:
+  struct frame_t {
+    csr_vertex_t m_vertex;
+    uint32_t m_next_index;
+    csr_edge_t m_cursor;
+  };
+
+  std::vector<csr_vertex_t> possible_start_nodes_of_cycles() {
+    std::vector<csr_vertex_t> nodes;
+    for (csr_vertex_t v = 0; v < m_graph.vertex_num(); v++) {
+      if (m_graph.in_degree(v) && m_graph.out_degree(v)) {
+        int64_t ts_in_max = std::numeric_limits<int64_t>::min();
+        int64_t ts_out_min = std::numeric_limits<int64_t>::max();
+
+        for (uint32_t i = m_graph.in_begin(v); i != m_graph.in_end(v); i++) {
+          csr_edge_t e = m_graph.in_edge(i);
+          if (!m_graph.is_removed(e)) {
+            ts_in_max = std::max(m_graph.timestamp(e), ts_in_max);
+          }
+        }
+        for (csr_edge_t e = m_graph.out_begin(v); e != m_graph.out_end(v);
+             e++) {
+          if (!m_graph.is_removed(e)) {
+            ts_out_min = std::min(m_graph.timestamp(e), ts_out_min);
+          }
+        }
+        if (ts_in_max >= ts_out_min) {
+          nodes.push_back(v);
+        }
+      }
+    }
+    return nodes;
+  }
+
+  std::vector<csr_edge_t> find_a_cycle_from_vertex_based_on_time_sequence(
+      csr_vertex_t v,
+      const std::unordered_set<transaction_graph::vertex_descriptor_t> &dead_v,
+      const std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+          &to_dead) {
+
+    std::vector<csr_edge_t> edges;
+    std::vector<frame_t> st;
+    std::vector<csr_vertex_t> touched_vertices;
+    std::vector<csr_edge_t> touched_edges;
+
+    st.push_back(frame_t{v, 0, m_graph.out_begin(v)});
+    m_visited[v] = 1;
+    touched_vertices.push_back(v);
+
+    auto backtrace_cond = [this, &to_dead](const frame_t &ele) {
+      size_t to_dead_cnt = 0;
+      auto it = to_dead.find(ele.m_vertex);
+      if (it != to_dead.end()) {
+        to_dead_cnt = it->second;
+      }
+      return ele.m_next_index + to_dead_cnt >=
+             m_graph.out_degree(ele.m_vertex);
+    };
+    auto in_time_order = [this, &edges](csr_edge_t e) {
+      if (!edges.empty()) {
+        if (m_graph.timestamp(edges.back()) > m_graph.timestamp(e)) {
+          return false;
+        }
+      }
+      return true;
+    };
+    auto erase_tail = [this, &edges](csr_vertex_t target) {
+      auto it = edges.begin();
+      for (; it != edges.end(); it++) {
+        if (m_graph.target(*it) == target) {
+          it++;
+          break;
+        }
+      }
+      edges.erase(edges.begin(), it);
+    };
+
+    while (!st.empty()) {
+      auto &ele = st.back();
+
+      if (backtrace_cond(ele)) {
+        m_visited[ele.m_vertex] = 0;
+        st.pop_back();
+        if (!edges.empty()) {
+          m_dead_edge[edges.back()] = 1;
+          touched_edges.push_back(edges.back());
+          edges.pop_back();
+        }
+      } else {
+        csr_edge_t nxt = ele.m_cursor;
+        while (m_graph.is_removed(nxt)) {
+          nxt++;
+        }
+        ele.m_cursor = nxt + 1;
+        ele.m_next_index++;
+
+        if (m_dead_edge[nxt]) {
+          continue;
+        }
+        if (!in_time_order(nxt)) {
+          continue;
+        }
+        auto target = m_graph.target(nxt);
+        if (dead_v.find(target) != dead_v.end()) {
+          continue;
+        }
+
+        if (!m_visited[target]) {
+          st.push_back(frame_t{target, 0, m_graph.out_begin(target)});
+          m_visited[target] = 1;
+          touched_vertices.push_back(target);
+          edges.push_back(nxt);
+        } else {
+          if (!edges.empty()) {
+            if (m_graph.source(edges.front()) != target) {
+              erase_tail(target);
+            }
+          }
+          edges.push_back(nxt);
+          break;
+        }
+      }
+    }
+
+    for (auto &t : touched_vertices) {
+      m_visited[t] = 0;
+    }
+    for (auto &t : touched_edges) {
+      m_dead_edge[t] = 0;
+    }
+    return edges;
+  }
+
+  std::vector<csr_edge_t> find_a_cycle_based_on_time_sequence(
+      const std::vector<csr_vertex_t> &start_nodes,
+      const std::unordered_set<transaction_graph::vertex_descriptor_t> &dead_v,
+      const std::unordered_map<transaction_graph::vertex_descriptor_t, size_t>
+          &to_dead) {
+
+    std::vector<csr_edge_t> ret;
+    for (auto &v : start_nodes) {
+      if (dead_v.find(v) == dead_v.end()) {
+        ret = find_a_cycle_from_vertex_based_on_time_sequence(v, dead_v,
+                                                              to_dead);
+        if (!ret.empty()) {
+          break;
+        }
+      }
+    }
+    return ret;
+  }
+
+  void remove_a_cycle(const std::vector<csr_edge_t> &edges) {
+    wei_t min_w = -1;
+    for (auto &e : edges) {
+      wei_t w = m_graph.weight(e);
+      min_w = (min_w == -1 ? w : math::min(min_w, w));
+    }
+
+    for (auto &e : edges) {
+      wei_t w = m_graph.weight(e);
+      m_graph.set_weight(e, w - min_w);
+      if (w == min_w) {
+        m_graph.remove_edge(e);
+      }
+    }
+  }
+
+private:
+  csr_transaction_graph &m_graph;
+  std::vector<char> m_visited;
+  std::vector<char> m_dead_edge;
+};
+
+void graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+    csr_transaction_graph &graph) {
+  csr_remove_cycles_based_on_time_sequence_helper nh(graph);
+  nh.remove_cycles_based_on_time_sequence();
+}
+
+void graph_algo::merge_edges_with_same_from_and_same_to(
+    csr_transaction_graph &graph) {
+
+  // the first edge of each (from, to) keeps the sum, the others are removed
+  const csr_edge_t invalid_edge = std::numeric_limits<csr_edge_t>::max();
+  std::vector<csr_edge_t> first_edge(graph.vertex_num(), invalid_edge);
+  std::vector<csr_vertex_t> touched;
+
+  for (csr_vertex_t v = 0; v < graph.vertex_num(); v++) {
+    for (csr_edge_t e = graph.out_begin(v); e != graph.out_end(v); e++) {
+      if (graph.is_removed(e)) {
+        continue;
+      }
+      auto target = graph.target(e);
+      csr_edge_t &f = first_edge[target];
+      if (f == invalid_edge) {
+        f = e;
+        graph.set_timestamp(e, 0);
+        touched.push_back(target);
+      } else {
+        graph.set_weight(f, graph.weight(f) + graph.weight(e));
+        graph.remove_edge(e);
+      }
+    }
+    for (auto &t : touched) {
+      first_edge[t] = invalid_edge;
+    }
+    touched.clear();
+  }
+}
+
+std::unique_ptr<std::unordered_map<address_t, in_out_val_t>>
+graph_algo::get_in_out_vals(const csr_transaction_graph &graph) {
+
+  auto ret = std::make_unique<std::unordered_map<address_t, in_out_val_t>>();
+  ret->reserve(graph.vertex_num());
+
+  std::vector<in_out_val_t> vals(graph.vertex_num(), in_out_val_t{0, 0});
+  for (csr_edge_t e = 0; e < graph.edge_num(); e++) {
+    if (graph.is_removed(e)) {
+      continue;
+    }
+    vals[graph.source(e)].m_out_val += graph.weight(e);
+    vals[graph.target(e)].m_in_val += graph.weight(e);
+  }
+
+  for (csr_vertex_t v = 0; v < graph.vertex_num(); v++) {
+    ret->insert(std::make_pair(graph.vertex_address(v), vals[v]));
+  }
+  return ret;
+}
+
+std::unique_ptr<std::unordered_map<address_t, wei_t>>
+graph_algo::get_stakes(const csr_transaction_graph &graph) {
+
+  auto ret = std::make_unique<std::unordered_map<address_t, wei_t>>();
+
+  auto it_in_out_vals = get_in_out_vals(graph);
+  for (auto &ele : *it_in_out_vals) {
+    ret->insert(
+        std::make_pair(ele.first, ele.second.m_in_val - ele.second.m_out_val));
+  }
+  return ret;
+}
+
+std::unique_ptr<std::unordered_map<address_t, in_out_degree_t>>
+graph_algo::get_in_out_degrees(const csr_transaction_graph &graph) {
+
+  auto ret = std::make_unique<std::unordered_map<address_t, in_out_degree_t>>();
+  ret->reserve(graph.vertex_num());
+
+  for (csr_vertex_t v = 0; v < graph.vertex_num(); v++) {
+    ret->insert(std::make_pair(
+        graph.vertex_address(v),
+        in_out_degree_t{graph.in_degree(v), graph.out_degree(v)}));
+  }
+  return ret;
+}
+
+std::unique_ptr<std::unordered_map<address_t, uint32_t>>
+graph_algo::get_degree_sum(const csr_transaction_graph &graph) {
+
+  auto ret = std::make_unique<std::unordered_map<address_t, uint32_t>>();
+  ret->reserve(graph.vertex_num());
+
+  for (csr_vertex_t v = 0; v < graph.vertex_num(); v++) {
+    ret->insert(std::make_pair(graph.vertex_address(v),
+                               graph.in_degree(v) + graph.out_degree(v)));
+  }
+  return ret;
+}
+
+} // namespace rt
+} // namespace neb
@@ -0,0 +1,183 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "runtime/nr/graph/csr_graph.h"
+
+namespace neb {
+namespace rt {
+
+csr_transaction_graph::vertex_id_t
+csr_transaction_graph::builder::add_vertex(const address_t &addr) {
+  auto it = m_addr_to_vertex.find(addr);
+  if (it != m_addr_to_vertex.end()) {
+    return it->second;
+  }
+  vertex_id_t v = static_cast<vertex_id_t>(m_addrs.size());
+  m_addrs.push_back(addr);
+  m_addr_to_vertex.insert(std::make_pair(addr, v));
+  return v;
+}
+
+void csr_transaction_graph::builder::add_edge(const address_t &from,
+                                              const address_t &to, wei_t val,
+                                              int64_t ts) {
+  vertex_id_t from_vertex = add_vertex(from);
+  vertex_id_t to_vertex = add_vertex(to);
+  m_from.push_back(from_vertex);
+  m_to.push_back(to_vertex);
+  m_weight.push_back(val);
+  m_timestamp.push_back(ts);
+}
+
+std::unique_ptr<csr_transaction_graph>
+csr_transaction_graph::builder::freeze() {
+  std::unique_ptr<csr_transaction_graph> ret(new csr_transaction_graph());
+  size_t vn = m_addrs.size();
+  size_t en = m_from.size();
+
+  ret->m_out_offsets.assign(vn + 1, 0);
+  ret->m_in_offsets.assign(vn + 1, 0);
+  for (size_t i = 0; i < en; i++) {
+    ret->m_out_offsets[m_from[i] + 1]++;
+    ret->m_in_offsets[m_to[i] + 1]++;
+  }
+  for (size_t v = 0; v < vn; v++) {
+    ret->m_out_offsets[v + 1] += ret->m_out_offsets[v];
+    ret->m_in_offsets[v + 1] += ret->m_in_offsets[v];
+  }
+
+  // counting sort by source and by target, both stable in insertion order
+  ret->m_source.resize(en);
+  ret->m_target.resize(en);
+  ret->m_weight.resize(en);
+  ret->m_timestamp.resize(en);
+  ret->m_in_edges.resize(en);
+  std::vector<edge_id_t> out_pos(ret->m_out_offsets.begin(),
+                                 ret->m_out_offsets.end() - 1);
+  std::vector<uint32_t> in_pos(ret->m_in_offsets.begin(),
+                               ret->m_in_offsets.end() - 1);
+  for (size_t i = 0; i < en; i++) {
+    edge_id_t e = out_pos[m_from[i]]++;
+    ret->m_source[e] = m_from[i];
+    ret->m_target[e] = m_to[i];
+    ret->m_weight[e] = m_weight[i];
+    ret->m_timestamp[e] = m_timestamp[i];
+    ret->m_in_edges[in_pos[m_to[i]]++] = e;
+  }
+
+  ret->m_removed.assign((en + 63) >> 6, 0);
+  ret->m_in_degree.resize(vn);
+  ret->m_out_degree.resize(vn);
+  for (size_t v = 0; v < vn; v++) {
+    ret->m_in_degree[v] = ret->m_in_offsets[v + 1] - ret->m_in_offsets[v];
+    ret->m_out_degree[v] = ret->m_out_offsets[v + 1] - ret->m_out_offsets[v];
+  }
+  ret->m_live_edge_num = en;
+
+  ret->m_addrs = std::move(m_addrs);
+  ret->m_addr_to_vertex = std::move(m_addr_to_vertex);
+  m_addrs.clear();
+  m_addr_to_vertex.clear();
+  m_from.clear();
+  m_to.clear();
+  m_weight.clear();
+  m_timestamp.clear();
+  return ret;
+}
+
+std::unique_ptr<csr_transaction_graph>
+csr_transaction_graph::build_from_transaction_graph(
+    const transaction_graph &tg) {
+  const transaction_graph::internal_graph_t &graph = tg.internal_graph();
+  builder b;
+
+  transaction_graph::viterator_t vi, vi_end;
+  for (boost::tie(vi, vi_end) = boost::vertices(graph); vi != vi_end; vi++) {
+    b.add_vertex(to_address(boost::get(boost::vertex_name_t(), graph, *vi)));
+  }
+
+  std::vector<transaction_graph::edge_descriptor_t> edges;
+  for (boost::tie(vi, vi_end) = boost::vertices(graph); vi != vi_end; vi++) {
+    transaction_graph::oeiterator_t oei, oei_end;
+    for (boost::tie(oei, oei_end) = boost::out_edges(*vi, graph);
+         oei != oei_end; oei++) {
+      edges.push_back(*oei);
+    }
+  }
+  std::stable_sort(edges.begin(), edges.end(),
+                   [&graph](const transaction_graph::edge_descriptor_t &e1,
+                            const transaction_graph::edge_descriptor_t &e2) {
+                     return boost::get(boost::edge_sort_id_t(), graph, e1) <
+                            boost::get(boost::edge_sort_id_t(), graph, e2);
+                   });
+
+  for (auto &e : edges) {
+    auto source = boost::source(e, graph);
+    auto target = boost::target(e, graph);
+    b.add_edge(to_address(boost::get(boost::vertex_name_t(), graph, source)),
+               to_address(boost::get(boost::vertex_name_t(), graph, target)),
+               boost::get(boost::edge_weight_t(), graph, e),
+               boost::get(boost::edge_timestamp_t(), graph, e));
+  }
+  return b.freeze();
+}
+
+bool csr_transaction_graph::find_vertex(const address_t &addr,
+                                        vertex_id_t &v) const {
+  auto it = m_addr_to_vertex.find(addr);
+  if (it == m_addr_to_vertex.end()) {
+    return false;
+  }
+  v = it->second;
+  return true;
+}
+
+void csr_transaction_graph::remove_edge(edge_id_t e) {
+  if (is_removed(e)) {
+    return;
+  }
+  m_removed[e >> 6] |= (1ULL << (e & 63));
+  m_out_degree[m_source[e]]--;
+  m_in_degree[m_target[e]]--;
+  m_live_edge_num--;
+}
+
+size_t csr_transaction_graph::memory_usage() const {
+  size_t ret = 0;
+  for (auto &addr : m_addrs) {
+    ret += addr.size();
+  }
+  ret += m_addrs.capacity() * sizeof(address_t);
+  ret += m_addr_to_vertex.size() *
+         (sizeof(address_t) + sizeof(vertex_id_t) + 2 * sizeof(void *));
+  ret += m_out_offsets.capacity() * sizeof(edge_id_t);
+  ret += m_in_offsets.capacity() * sizeof(uint32_t);
+  ret += m_in_edges.capacity() * sizeof(edge_id_t);
+  ret += m_source.capacity() * sizeof(vertex_id_t);
+  ret += m_target.capacity() * sizeof(vertex_id_t);
+  ret += m_weight.capacity() * sizeof(wei_t);
+  ret += m_timestamp.capacity() * sizeof(int64_t);
+  ret += m_removed.capacity() * sizeof(uint64_t);
+  ret += m_in_degree.capacity() * sizeof(uint32_t);
+  ret += m_out_degree.capacity() * sizeof(uint32_t);
+  return ret;
+}
+
+} // namespace rt
+} // namespace neb
@@ -0,0 +1,124 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#pragma once
+#include "common/address.h"
+#include "common/common.h"
+#include "runtime/nr/graph/graph.h"
+
+namespace neb {
+namespace rt {
+
+//! A frozen transaction graph in compressed sparse row layout.
+//! Vertices are numbered in the order addresses first appear, and edges of
+//! each vertex keep their insertion order, just like transaction_graph does
+//! with boost::adjacency_list<vecS, vecS>. Once frozen, edges can only be
+//! re-weighted or removed, removed edges are marked in a tombstone bitset.
+class csr_transaction_graph {
+public:
+  typedef uint32_t vertex_id_t;
+  typedef uint32_t edge_id_t;
+
+  class builder {
+  public:
+    builder() = default;
+
+    vertex_id_t add_vertex(const address_t &addr);
+    void add_edge(const address_t &from, const address_t &to, wei_t val,
+                  int64_t ts);
+
+    std::unique_ptr<csr_transaction_graph> freeze();
+
+  protected:
+    std::vector<address_t> m_addrs;
+    std::unordered_map<address_t, vertex_id_t> m_addr_to_vertex;
+
+    std::vector<vertex_id_t> m_from;
+    std::vector<vertex_id_t> m_to;
+    std::vector<wei_t> m_weight;
+    std::vector<int64_t> m_timestamp;
+  }; // end class builder
+
+  //! edges are ordered by insertion, i.e. edge_sort_id in transaction_graph
+  static std::unique_ptr<csr_transaction_graph>
+  build_from_transaction_graph(const transaction_graph &tg);
+
+  inline size_t vertex_num() const { return m_addrs.size(); }
+  inline size_t edge_num() const { return m_target.size(); }
+  inline size_t live_edge_num() const { return m_live_edge_num; }
+
+  inline const address_t &vertex_address(vertex_id_t v) const {
+    return m_addrs[v];
+  }
+  bool find_vertex(const address_t &addr, vertex_id_t &v) const;
+
+  //! out edges of v are edge ids in [out_begin(v), out_end(v))
+  inline edge_id_t out_begin(vertex_id_t v) const { return m_out_offsets[v]; }
+  inline edge_id_t out_end(vertex_id_t v) const {
+    return m_out_offsets[v + 1];
+  }
+  //! in edges of v are in_edge(i) for i in [in_begin(v), in_end(v))
+  inline uint32_t in_begin(vertex_id_t v) const { return m_in_offsets[v]; }
+  inline uint32_t in_end(vertex_id_t v) const { return m_in_offsets[v + 1]; }
+  inline edge_id_t in_edge(uint32_t i) const { return m_in_edges[i]; }
+
+  inline vertex_id_t source(edge_id_t e) const { return m_source[e]; }
+  inline vertex_id_t target(edge_id_t e) const { return m_target[e]; }
+  inline const wei_t &weight(edge_id_t e) const { return m_weight[e]; }
+  inline void set_weight(edge_id_t e, const wei_t &w) { m_weight[e] = w; }
+  inline int64_t timestamp(edge_id_t e) const { return m_timestamp[e]; }
+  inline void set_timestamp(edge_id_t e, int64_t ts) { m_timestamp[e] = ts; }
+
+  inline bool is_removed(edge_id_t e) const {
+    return (m_removed[e >> 6] >> (e & 63)) & 1;
+  }
+  void remove_edge(edge_id_t e);
+
+  //! degrees only count edges which are not removed
+  inline uint32_t in_degree(vertex_id_t v) const { return m_in_degree[v]; }
+  inline uint32_t out_degree(vertex_id_t v) const { return m_out_degree[v]; }
+
+  //! estimated heap bytes used by this graph
+  size_t memory_usage() const;
+
+protected:
+  csr_transaction_graph() = default;
+
+  std::vector<address_t> m_addrs;
+  std::unordered_map<address_t, vertex_id_t> m_addr_to_vertex;
+
+  std::vector<edge_id_t> m_out_offsets;
+  std::vector<uint32_t> m_in_offsets;
+  std::vector<edge_id_t> m_in_edges;
+
+  std::vector<vertex_id_t> m_source;
+  std::vector<vertex_id_t> m_target;
+  std::vector<wei_t> m_weight;
+  std::vector<int64_t> m_timestamp;
+  std::vector<uint64_t> m_removed;
+
+  std::vector<uint32_t> m_in_degree;
+  std::vector<uint32_t> m_out_degree;
+  size_t m_live_edge_num;
+}; // end class csr_transaction_graph
+
+using csr_transaction_graph_ptr_t = std::unique_ptr<csr_transaction_graph>;
+
+} // namespace rt
+} // namespace neb
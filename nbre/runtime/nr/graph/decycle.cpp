@@ -0,0 +1,454 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "common/math.h"
+#include "runtime/nr/graph/algo.h"
+
+namespace neb {
+namespace rt {
+
+//! Same cycles in the same order as
+//! non_recursive_remove_cycles_based_on_time_sequence_helper, thus the same
+//! graph after decycling.
+//!
+//! 1. Vertices that can not reach a non-trivial strongly connected component
+//!    never take part in a cycle, start nodes and DFS edges leading to them
+//!    are skipped. Removing edges only shrinks the components, so they are
+//!    computed once.
+//! 2. DFS state (on path, dead edges) are stamped arrays indexed by vertex
+//!    and edge, so a new search costs nothing to reset.
+//! 3. A DFS only depends on the out edges and the to-dead edge count of the
+//!    vertices it pushed. A start node whose DFS found no cycle is not
+//!    searched again until one of those vertices is touched by a removed
+//!    edge or a dead neighbour.
+//! 4. Dead vertices and their counters are maintained incrementally from the
+//!    endpoints of removed edges, instead of rescanning the graph.
+class fast_remove_cycles_based_on_time_sequence_helper {
+public:
+  typedef uint32_t vertex_id_t;
+  typedef uint32_t edge_id_t;
+
+  fast_remove_cycles_based_on_time_sequence_helper(
+      transaction_graph::internal_graph_t &graph)
+      : m_graph(graph), m_dead_num(0), m_search_id(0) {}
+
+  void remove_cycles_based_on_time_sequence() {
+    build();
+    compute_cycle_reachable();
+    compute_possible_start_nodes();
+
+    std::vector<vertex_id_t> seeds;
+    for (vertex_id_t v = 0; v < m_vertex_num; v++) {
+      if (!m_in_degree[v] || !m_out_degree[v]) {
+        seeds.push_back(v);
+      }
+    }
+    kill_vertices(seeds);
+
+    std::vector<edge_id_t> ret;
+    while (m_dead_num != m_vertex_num) {
+      if (!find_a_cycle_based_on_time_sequence(ret)) {
+        break;
+      }
+      remove_a_cycle(ret);
+    }
+  }
+
+private:
+  void build() {
+    m_vertex_num = boost::num_vertices(m_graph);
+    m_adj.resize(m_vertex_num);
+    m_in_adj.resize(m_vertex_num);
+
+    transaction_graph::viterator_t vi, vi_end;
+    for (boost::tie(vi, vi_end) = boost::vertices(m_graph); vi != vi_end;
+         vi++) {
+      transaction_graph::oeiterator_t oei, oei_end;
+      for (boost::tie(oei, oei_end) = boost::out_edges(*vi, m_graph);
+           oei != oei_end; oei++) {
+        edge_id_t e = m_edges.size();
+        vertex_id_t s = boost::source(*oei, m_graph);
+        vertex_id_t t = boost::target(*oei, m_graph);
+        m_edges.push_back(*oei);
+        m_source.push_back(s);
+        m_target.push_back(t);
+        m_timestamp.push_back(
+            boost::get(boost::edge_timestamp_t(), m_graph, *oei));
+        m_adj[s].push_back(e);
+        m_in_adj[t].push_back(e);
+      }
+    }
+    size_t edge_num = m_edges.size();
+
+    // dead edges are keyed by sort id as the original DFS does
+    std::vector<std::pair<int64_t, edge_id_t>> sort_ids;
+    for (edge_id_t e = 0; e < edge_num; e++) {
+      sort_ids.push_back(std::make_pair(
+          boost::get(boost::edge_sort_id_t(), m_graph, m_edges[e]), e));
+    }
+    std::sort(sort_ids.begin(), sort_ids.end());
+    m_sort_slot.resize(edge_num);
+    uint32_t slot = 0;
+    for (size_t i = 0; i < sort_ids.size(); i++) {
+      if (i && sort_ids[i].first != sort_ids[i - 1].first) {
+        slot++;
+      }
+      m_sort_slot[sort_ids[i].second] = slot;
+    }
+
+    m_removed.assign(edge_num, 0);
+    m_in_degree.resize(m_vertex_num);
+    m_out_degree.resize(m_vertex_num);
+    for (vertex_id_t v = 0; v < m_vertex_num; v++) {
+      m_in_degree[v] = m_in_adj[v].size();
+      m_out_degree[v] = m_adj[v].size();
+    }
+    m_dead.assign(m_vertex_num, 0);
+    m_dead_in.assign(m_vertex_num, 0);
+    m_dead_out.assign(m_vertex_num, 0);
+
+    m_on_path.assign(m_vertex_num, 0);
+    m_pushed.assign(m_vertex_num, 0);
+    m_dead_edge.assign(edge_num, 0);
+    m_no_cycle_from.assign(m_vertex_num, 0);
+    m_watchers.resize(m_vertex_num);
+  }
+
+  //! Iterative Tarjan, components come out in reverse topological order, so
+  //! successors of a component are settled before it.
+  void compute_cycle_reachable() {
+    const uint32_t unvisited = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> index(m_vertex_num, unvisited);
+    std::vector<uint32_t> low(m_vertex_num, 0);
+    std::vector<char> on_stack(m_vertex_num, 0);
+    std::vector<vertex_id_t> scc_stack;
+    std::vector<std::pair<vertex_id_t, uint32_t>> dfs_stack;
+    std::vector<uint32_t> comp(m_vertex_num, unvisited);
+    std::vector<char> comp_reach;
+    uint32_t next_index = 0;
+
+    m_cycle_reachable.assign(m_vertex_num, 0);
+    for (vertex_id_t root = 0; root < m_vertex_num; root++) {
+      if (index[root] != unvisited) {
+        continue;
+      }
+      dfs_stack.push_back(std::make_pair(root, 0));
+      index[root] = low[root] = next_index++;
+      scc_stack.push_back(root);
+      on_stack[root] = 1;
+
+      while (!dfs_stack.empty()) {
+        auto &ele = dfs_stack.back();
+        vertex_id_t v = ele.first;
+        if (ele.second < m_adj[v].size()) {
+          vertex_id_t t = m_target[m_adj[v][ele.second++]];
+          if (index[t] == unvisited) {
+            index[t] = low[t] = next_index++;
+            scc_stack.push_back(t);
+            on_stack[t] = 1;
+            dfs_stack.push_back(std::make_pair(t, 0));
+          } else if (on_stack[t]) {
+            low[v] = std::min(low[v], index[t]);
+          }
+          continue;
+        }
+
+        dfs_stack.pop_back();
+        if (!dfs_stack.empty()) {
+          vertex_id_t p = dfs_stack.back().first;
+          low[p] = std::min(low[p], low[v]);
+        }
+        if (low[v] != index[v]) {
+          continue;
+        }
+
+        uint32_t c = comp_reach.size();
+        size_t pos = scc_stack.size();
+        do {
+          pos--;
+          comp[scc_stack[pos]] = c;
+          on_stack[scc_stack[pos]] = 0;
+        } while (scc_stack[pos] != v);
+
+        bool reach = scc_stack.size() - pos > 1;
+        for (size_t i = pos; i < scc_stack.size(); i++) {
+          for (auto &e : m_adj[scc_stack[i]]) {
+            uint32_t tc = comp[m_target[e]];
+            if (tc == c) {
+              // self loop or inner edge
+              reach = true;
+            } else {
+              reach = reach || comp_reach[tc];
+            }
+          }
+        }
+        comp_reach.push_back(reach);
+        for (size_t i = pos; i < scc_stack.size(); i++) {
+          m_cycle_reachable[scc_stack[i]] = reach;
+        }
+        scc_stack.resize(pos);
+      }
+    }
+  }
+
+  void compute_possible_start_nodes() {
+    for (vertex_id_t v = 0; v < m_vertex_num; v++) {
+      if (!m_in_degree[v] || !m_out_degree[v]) {
+        continue;
+      }
+      int64_t ts_in_max = std::numeric_limits<int64_t>::min();
+      int64_t ts_out_min = std::numeric_limits<int64_t>::max();
+      for (auto &e : m_in_adj[v]) {
+        ts_in_max = std::max(m_timestamp[e], ts_in_max);
+      }
+      for (auto &e : m_adj[v]) {
+        ts_out_min = std::min(m_timestamp[e], ts_out_min);
+      }
+      if (ts_in_max >= ts_out_min) {
+        m_start_nodes.push_back(v);
+      }
+    }
+  }
+
+  //! A vertex is dead if it has no in edges or no out edges, or all its in
+  //! edges come from dead vertices, or all its out edges go to dead vertices.
+  //! Spread from the newly dead ones like bfs_decrease_graph_edges does.
+  void kill_vertices(const std::vector<vertex_id_t> &seeds) {
+    std::vector<vertex_id_t> q;
+    for (auto &v : seeds) {
+      if (!m_dead[v]) {
+        m_dead[v] = 1;
+        m_dead_num++;
+        q.push_back(v);
+      }
+    }
+
+    while (!q.empty()) {
+      vertex_id_t v = q.back();
+      q.pop_back();
+      touch(v);
+
+      for (auto &e : m_adj[v]) {
+        vertex_id_t t = m_target[e];
+        if (m_dead[t]) {
+          continue;
+        }
+        m_dead_in[t]++;
+        if (m_dead_in[t] == m_in_degree[t]) {
+          m_dead[t] = 1;
+          m_dead_num++;
+          q.push_back(t);
+        }
+      }
+      for (auto &e : m_in_adj[v]) {
+        if (m_removed[e]) {
+          continue;
+        }
+        vertex_id_t s = m_source[e];
+        if (m_dead[s]) {
+          continue;
+        }
+        m_dead_out[s]++;
+        touch(s);
+        if (m_dead_out[s] == m_out_degree[s]) {
+          m_dead[s] = 1;
+          m_dead_num++;
+          q.push_back(s);
+        }
+      }
+    }
+  }
+
+  //! The DFS from the start nodes which depend on v may behave differently.
+  inline void touch(vertex_id_t v) {
+    for (auto &s : m_watchers[v]) {
+      m_no_cycle_from[s] = 0;
+    }
+    m_watchers[v].clear();
+  }
+
+  inline void next_search() {
+    m_search_id++;
+    if (!m_search_id) {
+      std::fill(m_on_path.begin(), m_on_path.end(), 0);
+      std::fill(m_pushed.begin(), m_pushed.end(), 0);
+      std::fill(m_dead_edge.begin(), m_dead_edge.end(), 0);
+      m_search_id = 1;
+    }
+  }
+
+  bool find_a_cycle_from_vertex_based_on_time_sequence(
+      vertex_id_t v, std::vector<edge_id_t> &edges) {
+    next_search();
+    const uint32_t id = m_search_id;
+    edges.clear();
+    m_stack.clear();
+    m_path_vertices.clear();
+
+    m_stack.push_back(std::make_pair(v, 0));
+    m_on_path[v] = id;
+    m_pushed[v] = id;
+    m_path_vertices.push_back(v);
+
+    while (!m_stack.empty()) {
+      auto &ele = m_stack.back();
+      const auto &adj = m_adj[ele.first];
+
+      if (ele.second + m_dead_out[ele.first] == adj.size()) {
+        m_on_path[ele.first] = 0;
+        m_stack.pop_back();
+        if (!edges.empty()) {
+          m_dead_edge[m_sort_slot[edges.back()]] = id;
+          edges.pop_back();
+        }
+        continue;
+      }
+
+      edge_id_t nxt = adj[ele.second++];
+      if (m_dead_edge[m_sort_slot[nxt]] == id) {
+        continue;
+      }
+      if (!edges.empty() && m_timestamp[edges.back()] > m_timestamp[nxt]) {
+        continue;
+      }
+      vertex_id_t target = m_target[nxt];
+      if (m_dead[target] || !m_cycle_reachable[target]) {
+        continue;
+      }
+
+      if (m_on_path[target] != id) {
+        m_stack.push_back(std::make_pair(target, 0));
+        m_on_path[target] = id;
+        edges.push_back(nxt);
+        if (m_pushed[target] != id) {
+          m_pushed[target] = id;
+          m_path_vertices.push_back(target);
+        }
+      } else {
+        size_t head = 0;
+        if (!edges.empty() && m_source[edges.front()] != target) {
+          while (head < edges.size()) {
+            if (m_target[edges[head++]] == target) {
+              break;
+            }
+          }
+        }
+        edges.erase(edges.begin(), edges.begin() + head);
+        edges.push_back(nxt);
+        return true;
+      }
+    }
+
+    m_no_cycle_from[v] = 1;
+    for (auto &u : m_path_vertices) {
+      m_watchers[u].push_back(v);
+    }
+    return false;
+  }
+
+  bool find_a_cycle_based_on_time_sequence(std::vector<edge_id_t> &ret) {
+    for (auto &v : m_start_nodes) {
+      if (m_dead[v] || !m_cycle_reachable[v] || m_no_cycle_from[v]) {
+        continue;
+      }
+      if (find_a_cycle_from_vertex_based_on_time_sequence(v, ret)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void remove_a_cycle(const std::vector<edge_id_t> &edges) {
+    wei_t min_w = -1;
+    for (auto &e : edges) {
+      wei_t w = boost::get(boost::edge_weight_t(), m_graph, m_edges[e]);
+      min_w = (min_w == -1 ? w : math::min(min_w, w));
+    }
+
+    std::vector<vertex_id_t> seeds;
+    for (auto &e : edges) {
+      wei_t w = boost::get(boost::edge_weight_t(), m_graph, m_edges[e]);
+      boost::put(boost::edge_weight_t(), m_graph, m_edges[e], w - min_w);
+      if (w == min_w) {
+        boost::remove_edge(m_edges[e], m_graph);
+
+        vertex_id_t s = m_source[e];
+        vertex_id_t t = m_target[e];
+        auto &adj = m_adj[s];
+        adj.erase(std::remove(adj.begin(), adj.end(), e), adj.end());
+        m_removed[e] = 1;
+        m_out_degree[s]--;
+        m_in_degree[t]--;
+        touch(s);
+        if (!m_out_degree[s]) {
+          seeds.push_back(s);
+        }
+        if (!m_in_degree[t]) {
+          seeds.push_back(t);
+        }
+      }
+    }
+    kill_vertices(seeds);
+  }
+
+private:
+  transaction_graph::internal_graph_t &m_graph;
+  size_t m_vertex_num;
+
+  std::vector<transaction_graph::edge_descriptor_t> m_edges;
+  std::vector<vertex_id_t> m_source;
+  std::vector<vertex_id_t> m_target;
+  std::vector<int64_t> m_timestamp;
+  std::vector<uint32_t> m_sort_slot;
+  std::vector<char> m_removed;
+
+  //! live out edges in boost order, all in edges with m_removed
+  std::vector<std::vector<edge_id_t>> m_adj;
+  std::vector<std::vector<edge_id_t>> m_in_adj;
+  std::vector<uint32_t> m_in_degree;
+  std::vector<uint32_t> m_out_degree;
+
+  std::vector<char> m_dead;
+  size_t m_dead_num;
+  std::vector<uint32_t> m_dead_in;
+  std::vector<uint32_t> m_dead_out;
+
+  std::vector<char> m_cycle_reachable;
+  std::vector<vertex_id_t> m_start_nodes;
+
+  uint32_t m_search_id;
+  std::vector<uint32_t> m_on_path;
+  std::vector<uint32_t> m_pushed;
+  std::vector<uint32_t> m_dead_edge;
+  std::vector<std::pair<vertex_id_t, uint32_t>> m_stack;
+  std::vector<vertex_id_t> m_path_vertices;
+
+  std::vector<char> m_no_cycle_from;
+  std::vector<std::vector<vertex_id_t>> m_watchers;
+};
+
+void graph_algo::fast_remove_cycles_based_on_time_sequence(
+    transaction_graph::internal_graph_t &graph) {
+  fast_remove_cycles_based_on_time_sequence_helper fh(graph);
+  fh.remove_cycles_based_on_time_sequence();
+}
+
+} // namespace rt
+} // namespace neb
@@ -0,0 +1,224 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "runtime/nr/impl/incremental_nebulas_rank.h"
+#include "common/configuration.h"
+#include "common/log.h"
+#include <chrono>
+#include <ff/functionflow.h>
+
+namespace neb {
+namespace rt {
+namespace nr {
+
+incremental_nebulas_rank::incremental_nebulas_rank()
+    : m_use_test_blockchain(neb::use_test_blockchain), m_start_block(0),
+      m_end_block(0),
+      m_txs(std::make_shared<std::vector<neb::fs::transaction_info_t>>()),
+      m_graph_hits(0), m_graph_misses(0) {}
+
+void incremental_nebulas_rank::clear() {
+  std::unique_lock<std::mutex> _l(m_mutex);
+  clear_window_and_caches();
+}
+
+void incremental_nebulas_rank::clear_window_and_caches() {
+  m_start_block = 0;
+  m_end_block = 0;
+  m_txs = std::make_shared<std::vector<neb::fs::transaction_info_t>>();
+  m_graphs.clear();
+  std::unique_lock<std::mutex> _bl(m_balances_mutex);
+  m_balances.clear();
+}
+
+void incremental_nebulas_rank::advance_window(
+    const transaction_db_ptr_t &tdb_ptr, neb::block_height_t start_block,
+    neb::block_height_t end_block) {
+
+  auto height_less = [](const neb::fs::transaction_info_t &info,
+                        block_height_t h) { return info.m_height < h; };
+
+  bool overlapped = m_start_block < m_end_block &&
+                    start_block >= m_start_block && start_block <= m_end_block;
+  if (!overlapped) {
+    auto txs_ptr = tdb_ptr->read_transactions_from_db_with_duration(
+        start_block, end_block);
+    m_txs = std::move(txs_ptr);
+    m_start_block = start_block;
+    m_end_block = end_block;
+    return;
+  }
+
+  std::unique_ptr<std::vector<neb::fs::transaction_info_t>> new_txs_ptr;
+  if (end_block > m_end_block) {
+    new_txs_ptr = tdb_ptr->read_transactions_from_db_with_duration(
+        m_end_block, end_block);
+  }
+
+  auto begin = std::lower_bound(m_txs->begin(), m_txs->end(), start_block,
+                                height_less);
+  auto end = m_txs->end();
+  if (end_block < m_end_block) {
+    end = std::lower_bound(begin, m_txs->end(), end_block, height_less);
+  }
+  // a snapshot of the last window may still be read
+  auto txs = std::make_shared<std::vector<neb::fs::transaction_info_t>>(begin,
+                                                                        end);
+  if (new_txs_ptr) {
+    txs->insert(txs->end(), new_txs_ptr->begin(), new_txs_ptr->end());
+  }
+  m_txs = std::move(txs);
+  m_start_block = start_block;
+  m_end_block = end_block;
+}
+
+void incremental_nebulas_rank::expire_before(neb::block_height_t start_block) {
+  for (auto it = m_graphs.begin(); it != m_graphs.end();) {
+    if (it->first.first < start_block) {
+      it = m_graphs.erase(it);
+    } else {
+      break;
+    }
+  }
+  std::unique_lock<std::mutex> _l(m_balances_mutex);
+  m_balances.erase(m_balances.begin(), m_balances.lower_bound(start_block));
+}
+
+std::vector<std::shared_ptr<nr_info_t>> incremental_nebulas_rank::get_nr_score(
+    const transaction_db_ptr_t &tdb_ptr, const account_db_ptr_t &adb_ptr,
+    const rank_params_t &rp, neb::block_height_t start_block,
+    neb::block_height_t end_block, bool parallel) {
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  txs_ptr_t txs_ptr;
+  std::unique_ptr<std::vector<neb::fs::transaction_info_t>> inter_txs_ptr;
+  std::unique_ptr<std::vector<std::vector<neb::fs::transaction_info_t>>>
+      txs_v_ptr;
+  transaction_graph_ptr_t tg;
+  parallel = parallel && ff::is_initialized();
+  {
+    std::unique_lock<std::mutex> _l(m_mutex);
+    if (m_use_test_blockchain != neb::use_test_blockchain) {
+      LOG(INFO) << "chain switched, drop cached transactions and graphs";
+      clear_window_and_caches();
+      m_use_test_blockchain = neb::use_test_blockchain;
+    }
+    advance_window(tdb_ptr, start_block, end_block);
+    expire_before(start_block);
+    txs_ptr = m_txs;
+    LOG(INFO) << "raw tx size: " << txs_ptr->size();
+    inter_txs_ptr = fs::transaction_db::read_transactions_with_address_type(
+        *txs_ptr, NAS_ADDRESS_ACCOUNT_MAGIC_NUM, NAS_ADDRESS_ACCOUNT_MAGIC_NUM);
+    LOG(INFO) << "account to account: " << inter_txs_ptr->size();
+
+    const int32_t block_interval = 128;
+    txs_v_ptr = nebulas_rank::split_transactions_by_block_interval(
+        *inter_txs_ptr, block_interval);
+    nebulas_rank::filter_empty_transactions_this_interval(*txs_v_ptr);
+    if (txs_v_ptr->empty()) {
+      return std::vector<std::shared_ptr<nr_info_t>>();
+    }
+
+    // the same intervals as split_transactions_by_block_interval
+    block_height_t block_first = inter_txs_ptr->front().m_height;
+    std::vector<block_range_t> ranges;
+    std::vector<std::vector<neb::fs::transaction_info_t>> missing_txs;
+    std::vector<size_t> missing_index;
+    for (size_t i = 0; i < txs_v_ptr->size(); i++) {
+      block_height_t h = (*txs_v_ptr)[i].front().m_height;
+      block_height_t b =
+          block_first + (h - block_first) / block_interval * block_interval;
+      block_range_t range = std::make_pair(
+          b, std::min<block_height_t>(b + block_interval, end_block));
+      ranges.push_back(range);
+      if (m_graphs.find(range) == m_graphs.end()) {
+        missing_txs.push_back((*txs_v_ptr)[i]);
+        missing_index.push_back(i);
+      }
+    }
+    m_graph_hits += ranges.size() - missing_index.size();
+    m_graph_misses += missing_index.size();
+    LOG(INFO) << "we have " << ranges.size() << " subgraphs, "
+              << missing_index.size() << " to build.";
+
+    auto tgs_ptr =
+        nebulas_rank::build_decycled_transaction_graphs(missing_txs, parallel);
+    for (size_t i = 0; i < missing_index.size(); i++) {
+      m_graphs[ranges[missing_index[i]]] = std::move((*tgs_ptr)[i]);
+    }
+    LOG(INFO) << "done with remove cycle.";
+
+    std::map<block_range_t, transaction_graph_ptr_t> graphs;
+    std::vector<const transaction_graph *> graph_ptrs;
+    for (auto &range : ranges) {
+      auto &g = m_graphs[range];
+      graph_ptrs.push_back(g.get());
+      graphs.insert(std::make_pair(range, std::move(g)));
+    }
+    // only keep intervals of this window
+    m_graphs = std::move(graphs);
+
+    tg = graph_algo::merge_graphs(graph_ptrs);
+  }
+
+  auto infos = nebulas_rank::get_nr_score_from_merged_graph(
+      adb_ptr, rp, *txs_ptr, *inter_txs_ptr, *txs_v_ptr, tg.get(),
+      [this, &adb_ptr, start_block,
+       parallel](const std::vector<address_t> &accs) {
+        std::vector<wei_t> ret(accs.size());
+        std::vector<address_t> missing;
+        std::vector<size_t> missing_index;
+        {
+          std::unique_lock<std::mutex> _l(m_balances_mutex);
+          auto &balances = m_balances[start_block];
+          for (size_t i = 0; i < accs.size(); i++) {
+            auto it = balances.find(accs[i]);
+            if (it == balances.end()) {
+              missing.push_back(accs[i]);
+              missing_index.push_back(i);
+            } else {
+              ret[i] = it->second;
+            }
+          }
+        }
+        auto missing_balances =
+            adb_ptr->get_balances(missing, start_block, parallel);
+        std::unique_lock<std::mutex> _l(m_balances_mutex);
+        auto &balances = m_balances[start_block];
+        for (size_t i = 0; i < missing.size(); i++) {
+          ret[missing_index[i]] = missing_balances[i];
+          balances.insert(std::make_pair(missing[i], missing_balances[i]));
+        }
+        return ret;
+      });
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "time spend: "
+            << std::chrono::duration_cast<std::chrono::seconds>(end_time -
+                                                                start_time)
+                   .count()
+            << " seconds";
+  return infos;
+}
+
+} // namespace nr
+} // namespace rt
+} // namespace neb
@@ -0,0 +1,110 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "runtime/nr/impl/nebulas_rank.h"
+#include "util/singleton.h"
+#include <map>
+
+namespace neb {
+namespace rt {
+namespace nr {
+
+//! Sliding window version of nebulas_rank::get_nr_score with the same result.
+//!
+//! Transactions of the last window are kept, when the window advances only
+//! expired blocks are dropped and new blocks are read. Decycled and merged
+//! interval graphs are kept by their block range [begin, end), an interval
+//! is reused whenever the next window splits into the same range, i.e. the
+//! first account transaction height of both windows is congruent modulo the
+//! block interval. Account balances at window start are kept by height, so
+//! handles on the same window (e.g. NR for DIP) skip the state trie walks.
+//!
+//! m_mutex guards the window and its graphs only, it is released before the
+//! balances are read and the scores computed, which work on a snapshot of the
+//! window and a merged graph of their own.
+//!
+//! Everything cached comes from one chain, it is dropped as soon as a call
+//! sees neb::use_test_blockchain switched.
+class incremental_nebulas_rank
+    : public util::singleton<incremental_nebulas_rank> {
+public:
+  incremental_nebulas_rank();
+
+  std::vector<std::shared_ptr<nr_info_t>>
+  get_nr_score(const transaction_db_ptr_t &tdb_ptr,
+               const account_db_ptr_t &adb_ptr, const rank_params_t &rp,
+               neb::block_height_t start_block, neb::block_height_t end_block,
+               bool parallel = false);
+
+  void clear();
+
+  inline size_t cached_graph_num() const {
+    std::unique_lock<std::mutex> _l(m_mutex);
+    return m_graphs.size();
+  }
+  inline size_t cached_tx_num() const {
+    std::unique_lock<std::mutex> _l(m_mutex);
+    return m_txs->size();
+  }
+  inline uint64_t graph_hits() const { return m_graph_hits; }
+  inline uint64_t graph_misses() const { return m_graph_misses; }
+
+#ifdef NDEBUG
+private:
+#else
+public:
+#endif
+  void advance_window(const transaction_db_ptr_t &tdb_ptr,
+                      neb::block_height_t start_block,
+                      neb::block_height_t end_block);
+
+  void expire_before(neb::block_height_t start_block);
+
+  //! with m_mutex
+  void clear_window_and_caches();
+
+  typedef std::pair<block_height_t, block_height_t> block_range_t;
+
+  typedef std::shared_ptr<const std::vector<neb::fs::transaction_info_t>>
+      txs_ptr_t;
+
+  mutable std::mutex m_mutex;
+
+  //! the chain everything below comes from
+  bool m_use_test_blockchain;
+
+  //! transactions in [m_start_block, m_end_block) in height order, replaced
+  //! as a whole when the window advances, hence a snapshot stays valid
+  block_height_t m_start_block;
+  block_height_t m_end_block;
+  txs_ptr_t m_txs;
+
+  std::map<block_range_t, transaction_graph_ptr_t> m_graphs;
+
+  std::mutex m_balances_mutex;
+  std::map<block_height_t, std::unordered_map<address_t, wei_t>> m_balances;
+
+  std::atomic<uint64_t> m_graph_hits;
+  std::atomic<uint64_t> m_graph_misses;
+}; // class incremental_nebulas_rank
+} // namespace nr
+} // namespace rt
+} // namespace neb
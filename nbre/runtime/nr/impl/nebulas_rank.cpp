@@ -26,6 +26,7 @@
 #include <boost/foreach.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <chrono>
+#include <ff/functionflow.h>
 #include <thread>
 
 namespace neb {
@@ -110,6 +111,32 @@ nebulas_rank::build_transaction_graphs(
   return tgs;
 }
 
+std::unique_ptr<std::vector<transaction_graph_ptr_t>>
+nebulas_rank::build_decycled_transaction_graphs(
+    const std::vector<std::vector<neb::fs::transaction_info_t>> &txs,
+    bool parallel) {
+
+  auto tgs = std::make_unique<std::vector<transaction_graph_ptr_t>>(txs.size());
+
+  auto build_and_decycle = [&txs, &tgs](size_t i) {
+    auto p = build_graph_from_transactions(txs[i]);
+    graph_algo::fast_remove_cycles_based_on_time_sequence(p->internal_graph());
+    graph_algo::merge_edges_with_same_from_and_same_to(p->internal_graph());
+    (*tgs)[i] = std::move(p);
+  };
+
+  if (parallel) {
+    ff::paragroup pg;
+    pg.for_each(static_cast<size_t>(0), txs.size(), build_and_decycle);
+    ff::ff_wait(ff::all(pg));
+  } else {
+    for (size_t i = 0; i < txs.size(); i++) {
+      build_and_decycle(i);
+    }
+  }
+  return tgs;
+}
+
 block_height_t nebulas_rank::get_max_height_this_block_interval(
     const std::vector<neb::fs::transaction_info_t> &txs) {
   if (txs.empty()) {
@@ -172,14 +199,64 @@ nebulas_rank::get_account_balance_median(
   return ret;
 }
 
+// invariants of f_account_weight and f_account_rank, so that the batch
+// versions compute them once, while the scalar and the batch versions run the
+// same softfloat operations for each account
+struct account_weight_constants {
+  account_weight_constants()
+      : pi(math::constants<floatxx_t>::pi()), half_pi(pi / 2.0),
+        quarter_pi(pi / 4.0), minus_two(-2.0) {}
+
+  math::internal::series_constants<floatxx_t> sc;
+  floatxx_t pi, half_pi, quarter_pi, minus_two;
+};
+
+static floatxx_t account_weight(floatxx_t in_val, floatxx_t out_val,
+                                const account_weight_constants &c) {
+  floatxx_t atan_val = c.half_pi;
+  if (in_val > c.sc.zero) {
+    atan_val = math::internal::arctan(out_val / in_val, c.sc);
+  }
+  auto tmp = math::internal::sin(c.quarter_pi - atan_val, c.sc);
+  return (in_val + out_val) *
+         math::internal::exp(c.minus_two * tmp * tmp, c.sc);
+}
+
+struct account_rank_constants {
+  account_rank_constants(int64_t a, int64_t b, floatxx_t theta, floatxx_t mu,
+                         floatxx_t lambda)
+      : a(a), one_div_b(sc.one / b), theta(theta), mu(mu), lambda(lambda) {}
+
+  math::internal::series_constants<floatxx_t> sc;
+  floatxx_t a, one_div_b, theta, mu, lambda;
+};
+
+static floatxx_t account_rank(floatxx_t S, floatxx_t R,
+                              const account_rank_constants &c) {
+  auto gamma = math::internal::pow(c.theta * R / (R + c.mu), c.lambda, c.sc);
+  auto ret = c.sc.zero;
+  if (S > c.sc.zero) {
+    ret = (S / (c.sc.one + math::internal::pow(c.a / S, c.one_div_b, c.sc))) *
+          gamma;
+  }
+  return ret;
+}
+
 floatxx_t nebulas_rank::f_account_weight(floatxx_t in_val, floatxx_t out_val) {
-  floatxx_t pi = math::constants<floatxx_t>::pi();
-  floatxx_t atan_val = pi / 2.0;
-  if (in_val > 0) {
-    atan_val = math::arctan(out_val / in_val);
+  return account_weight(in_val, out_val, account_weight_constants());
+}
+
+void nebulas_rank::f_account_weights(const std::vector<floatxx_t> &in_vals,
+                                     const std::vector<floatxx_t> &out_vals,
+                                     std::vector<floatxx_t> &weights) {
+  if (in_vals.size() != out_vals.size()) {
+    throw std::invalid_argument("in_vals and out_vals with different sizes");
+  }
+  account_weight_constants c;
+  weights.resize(in_vals.size());
+  for (size_t i = 0; i < in_vals.size(); i++) {
+    weights[i] = account_weight(in_vals[i], out_vals[i], c);
   }
-  auto tmp = math::sin(pi / 4.0 - atan_val);
-  return (in_val + out_val) * math::exp((-2.0) * tmp * tmp);
 }
 
 std::unique_ptr<std::unordered_map<address_t, floatxx_t>>
@@ -187,7 +264,12 @@ nebulas_rank::get_account_weight(
     const std::unordered_map<address_t, neb::rt::in_out_val_t> &in_out_vals,
     const account_db_ptr_t &db_ptr) {
 
-  auto ret = std::make_unique<std::unordered_map<address_t, floatxx_t>>();
+  std::vector<address_t> addrs;
+  std::vector<floatxx_t> normalized_in_vals;
+  std::vector<floatxx_t> normalized_out_vals;
+  addrs.reserve(in_out_vals.size());
+  normalized_in_vals.reserve(in_out_vals.size());
+  normalized_out_vals.reserve(in_out_vals.size());
 
   for (auto it = in_out_vals.begin(); it != in_out_vals.end(); it++) {
     wei_t in_val = it->second.m_in_val;
@@ -196,11 +278,17 @@ nebulas_rank::get_account_weight(
     floatxx_t f_in_val = to_float<floatxx_t>(in_val);
     floatxx_t f_out_val = to_float<floatxx_t>(out_val);
 
-    floatxx_t normalized_in_val = db_ptr->get_normalized_value(f_in_val);
-    floatxx_t normalized_out_val = db_ptr->get_normalized_value(f_out_val);
+    addrs.push_back(it->first);
+    normalized_in_vals.push_back(db_ptr->get_normalized_value(f_in_val));
+    normalized_out_vals.push_back(db_ptr->get_normalized_value(f_out_val));
+  }
 
-    auto tmp = f_account_weight(normalized_in_val, normalized_out_val);
-    ret->insert(std::make_pair(it->first, tmp));
+  std::vector<floatxx_t> weights;
+  f_account_weights(normalized_in_vals, normalized_out_vals, weights);
+
+  auto ret = std::make_unique<std::unordered_map<address_t, floatxx_t>>();
+  for (size_t i = 0; i < addrs.size(); i++) {
+    ret->insert(std::make_pair(addrs[i], weights[i]));
   }
   return ret;
 }
@@ -209,14 +297,21 @@ floatxx_t nebulas_rank::f_account_rank(int64_t a, int64_t b, int64_t c,
                                        int64_t d, floatxx_t theta, floatxx_t mu,
                                        floatxx_t lambda, floatxx_t S,
                                        floatxx_t R) {
-  floatxx_t zero = softfloat_cast<uint32_t, typename floatxx_t::value_type>(0);
-  floatxx_t one = softfloat_cast<uint32_t, typename floatxx_t::value_type>(1);
-  auto gamma = math::pow(theta * R / (R + mu), lambda);
-  auto ret = zero;
-  if (S > 0) {
-    ret = (S / (one + math::pow(a / S, one / b))) * gamma;
+  return account_rank(S, R, account_rank_constants(a, b, theta, mu, lambda));
+}
+
+void nebulas_rank::f_account_ranks(const rank_params_t &rp,
+                                   const std::vector<floatxx_t> &S,
+                                   const std::vector<floatxx_t> &R,
+                                   std::vector<floatxx_t> &ranks) {
+  if (S.size() != R.size()) {
+    throw std::invalid_argument("S and R with different sizes");
+  }
+  account_rank_constants c(rp.m_a, rp.m_b, rp.m_theta, rp.m_mu, rp.m_lambda);
+  ranks.resize(S.size());
+  for (size_t i = 0; i < S.size(); i++) {
+    ranks[i] = account_rank(S[i], R[i], c);
   }
-  return ret;
 }
 
 std::unique_ptr<std::unordered_map<address_t, floatxx_t>>
@@ -225,55 +320,43 @@ nebulas_rank::get_account_rank(
     const std::unordered_map<address_t, floatxx_t> &account_weight,
     const rank_params_t &rp) {
 
-  auto ret = std::make_unique<std::unordered_map<address_t, floatxx_t>>();
+  std::vector<address_t> addrs;
+  std::vector<floatxx_t> medians;
+  std::vector<floatxx_t> weights;
+  addrs.reserve(account_median.size());
+  medians.reserve(account_median.size());
+  weights.reserve(account_median.size());
 
   for (auto it_m = account_median.begin(); it_m != account_median.end();
        it_m++) {
     auto it_w = account_weight.find(it_m->first);
     if (it_w != account_weight.end()) {
-      floatxx_t rank_val =
-          f_account_rank(rp.m_a, rp.m_b, rp.m_c, rp.m_d, rp.m_theta, rp.m_mu,
-                         rp.m_lambda, it_m->second, it_w->second);
-      ret->insert(std::make_pair(it_m->first, rank_val));
+      addrs.push_back(it_m->first);
+      medians.push_back(it_m->second);
+      weights.push_back(it_w->second);
     }
   }
 
+  std::vector<floatxx_t> ranks;
+  f_account_ranks(rp, medians, weights, ranks);
+
+  auto ret = std::make_unique<std::unordered_map<address_t, floatxx_t>>();
+  for (size_t i = 0; i < addrs.size(); i++) {
+    ret->insert(std::make_pair(addrs[i], ranks[i]));
+  }
   return ret;
 }
 
-std::vector<std::shared_ptr<nr_info_t>> nebulas_rank::get_nr_score(
-    const transaction_db_ptr_t &tdb_ptr, const account_db_ptr_t &adb_ptr,
-    const rank_params_t &rp, neb::block_height_t start_block,
-    neb::block_height_t end_block) {
-
-  auto start_time = std::chrono::high_resolution_clock::now();
-  // transactions in total and account inter transactions
-  auto txs_ptr =
-      tdb_ptr->read_transactions_from_db_with_duration(start_block, end_block);
-  LOG(INFO) << "raw tx size: " << txs_ptr->size();
-  auto inter_txs_ptr = fs::transaction_db::read_transactions_with_address_type(
-      *txs_ptr, NAS_ADDRESS_ACCOUNT_MAGIC_NUM, NAS_ADDRESS_ACCOUNT_MAGIC_NUM);
-  LOG(INFO) << "account to account: " << inter_txs_ptr->size();
-
-  // graph operation
-  auto txs_v_ptr = split_transactions_by_block_interval(*inter_txs_ptr);
-  LOG(INFO) << "split by block interval: " << txs_v_ptr->size();
-
-  filter_empty_transactions_this_interval(*txs_v_ptr);
-  auto tgs_ptr = build_transaction_graphs(*txs_v_ptr);
-  if (tgs_ptr->empty()) {
-    return std::vector<std::shared_ptr<nr_info_t>>();
-  }
-  LOG(INFO) << "we have " << tgs_ptr->size() << " subgraphs.";
-  for (auto it = tgs_ptr->begin(); it != tgs_ptr->end(); it++) {
-    transaction_graph *ptr = it->get();
-    graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
-        ptr->internal_graph());
-    graph_algo::merge_edges_with_same_from_and_same_to(ptr->internal_graph());
-  }
-  LOG(INFO) << "done with remove cycle.";
+std::vector<std::shared_ptr<nr_info_t>>
+nebulas_rank::get_nr_score_from_merged_graph(
+    const account_db_ptr_t &adb_ptr, const rank_params_t &rp,
+    const std::vector<neb::fs::transaction_info_t> &txs,
+    const std::vector<neb::fs::transaction_info_t> &inter_txs,
+    const std::vector<std::vector<neb::fs::transaction_info_t>> &txs_v,
+    transaction_graph *tg,
+    const std::function<std::vector<wei_t>(const std::vector<address_t> &)>
+        &get_start_balances) {
 
-  transaction_graph *tg = neb::rt::graph_algo::merge_graphs(*tgs_ptr);
   graph_algo::merge_topk_edges_with_same_from_and_same_to(tg->internal_graph());
   LOG(INFO) << "done with merge graphs.";
 
@@ -283,20 +366,21 @@ std::vector<std::shared_ptr<nr_info_t>> nebulas_rank::get_nr_score(
   LOG(INFO) << "done with get in_out_vals";
 
   // median, weight, rank
-  auto accounts_ptr = get_normal_accounts(*inter_txs_ptr);
+  auto accounts_ptr = get_normal_accounts(inter_txs);
   LOG(INFO) << "account size: " << accounts_ptr->size();
 
+  std::vector<address_t> accounts(accounts_ptr->begin(), accounts_ptr->end());
+  auto balances = get_start_balances(accounts);
   std::unordered_map<neb::address_t, neb::wei_t> addr_balance;
-  for (auto &acc : *accounts_ptr) {
-    auto balance = adb_ptr->get_balance(acc, start_block);
-    addr_balance.insert(std::make_pair(acc, balance));
+  for (size_t i = 0; i < accounts.size(); i++) {
+    addr_balance.insert(std::make_pair(accounts[i], balances[i]));
   }
   LOG(INFO) << "done with get balance";
-  adb_ptr->set_height_address_val_internal(*txs_ptr, addr_balance);
+  adb_ptr->set_height_address_val_internal(txs, addr_balance);
   LOG(INFO) << "done with set height address";
 
   auto account_median_ptr =
-      get_account_balance_median(*accounts_ptr, *txs_v_ptr, adb_ptr);
+      get_account_balance_median(*accounts_ptr, txs_v, adb_ptr);
   LOG(INFO) << "done with get account balance median";
   auto account_weight_ptr = get_account_weight(in_out_vals, adb_ptr);
   LOG(INFO) << "done with get account weight";
@@ -324,6 +408,48 @@ std::vector<std::shared_ptr<nr_info_t>> nebulas_rank::get_nr_score(
     }
   }
 
+  return infos;
+}
+
+std::vector<std::shared_ptr<nr_info_t>> nebulas_rank::get_nr_score(
+    const transaction_db_ptr_t &tdb_ptr, const account_db_ptr_t &adb_ptr,
+    const rank_params_t &rp, neb::block_height_t start_block,
+    neb::block_height_t end_block, bool parallel) {
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+  // transactions in total and account inter transactions
+  auto txs_ptr =
+      tdb_ptr->read_transactions_from_db_with_duration(start_block, end_block);
+  LOG(INFO) << "raw tx size: " << txs_ptr->size();
+  auto inter_txs_ptr = fs::transaction_db::read_transactions_with_address_type(
+      *txs_ptr, NAS_ADDRESS_ACCOUNT_MAGIC_NUM, NAS_ADDRESS_ACCOUNT_MAGIC_NUM);
+  LOG(INFO) << "account to account: " << inter_txs_ptr->size();
+
+  // graph operation
+  auto txs_v_ptr = split_transactions_by_block_interval(*inter_txs_ptr);
+  LOG(INFO) << "split by block interval: " << txs_v_ptr->size();
+
+  filter_empty_transactions_this_interval(*txs_v_ptr);
+  parallel = parallel && ff::is_initialized();
+  auto tgs_ptr = build_decycled_transaction_graphs(*txs_v_ptr, parallel);
+  if (tgs_ptr->empty()) {
+    return std::vector<std::shared_ptr<nr_info_t>>();
+  }
+  LOG(INFO) << "we have " << tgs_ptr->size() << " subgraphs.";
+  LOG(INFO) << "done with remove cycle.";
+
+  transaction_graph *tg = nullptr;
+  if (parallel) {
+    tg = neb::rt::graph_algo::merge_graphs_in_tree(*tgs_ptr, parallel);
+  } else {
+    tg = neb::rt::graph_algo::merge_graphs(*tgs_ptr);
+  }
+  auto infos = get_nr_score_from_merged_graph(
+      adb_ptr, rp, *txs_ptr, *inter_txs_ptr, *txs_v_ptr, tg,
+      [&adb_ptr, start_block, parallel](const std::vector<address_t> &accs) {
+        return adb_ptr->get_balances(accs, start_block, parallel);
+      });
+
   auto end_time = std::chrono::high_resolution_clock::now();
   LOG(INFO) << "time spend: "
             << std::chrono::duration_cast<std::chrono::seconds>(end_time -
@@ -336,13 +462,13 @@ std::vector<std::shared_ptr<nr_info_t>> nebulas_rank::get_nr_score(
 void nebulas_rank::convert_nr_info_to_ptree(const nr_info_t &info,
                                             boost::property_tree::ptree &p) {
 
-  neb::bytes addr_bytes = info.m_address;
+  const address_t &addr = info.m_address;
   floatxx_t f_in_outs = info.m_in_outs;
   floatxx_t f_median = info.m_median;
   floatxx_t f_weight = info.m_weight;
   floatxx_t f_nr_score = info.m_nr_score;
 
-  p.put(std::string("address"), addr_bytes.to_base58());
+  p.put(std::string("address"), addr.to_base58());
   p.put(std::string("in_outs"), neb::math::to_string(f_in_outs));
   p.put(std::string("median"), neb::math::to_string(f_median));
   p.put(std::string("weight"), neb::math::to_string(f_weight));
@@ -360,27 +486,28 @@ void nebulas_rank::full_fill_meta_info(
   }
 }
 
-str_uptr_t nebulas_rank::nr_info_to_json(const nr_ret_type &nr_ret) {
+str_uptr_t nebulas_rank::nr_infos_to_json(
+    const std::string &meta_info_json, size_t n,
+    const std::function<nr_info_t(size_t)> &get_info) {
 
   boost::property_tree::ptree root;
   boost::property_tree::ptree arr;
 
-  const auto &meta_info_json = std::get<1>(nr_ret);
-  const auto &meta_info = neb::rt::json_to_meta_info(meta_info_json);
-  if (!meta_info.empty()) {
-    full_fill_meta_info(meta_info, root);
+  if (!meta_info_json.empty()) {
+    const auto &meta_info = neb::rt::json_to_meta_info(meta_info_json);
+    if (!meta_info.empty()) {
+      full_fill_meta_info(meta_info, root);
+    }
   }
 
-  auto &nr_infos = std::get<2>(nr_ret);
-  if (nr_infos.empty()) {
+  if (!n) {
     boost::property_tree::ptree p;
     arr.push_back(std::make_pair(std::string(), p));
   }
 
-  for (auto &it : nr_infos) {
-    const neb::rt::nr::nr_info_t &info = *it;
+  for (size_t i = 0; i < n; i++) {
     boost::property_tree::ptree p;
-    convert_nr_info_to_ptree(info, p);
+    convert_nr_info_to_ptree(get_info(i), p);
     arr.push_back(std::make_pair(std::string(), p));
   }
   root.add_child("nrs", arr);
@@ -392,6 +519,12 @@ str_uptr_t nebulas_rank::nr_info_to_json(const nr_ret_type &nr_ret) {
   return tmp_ptr;
 }
 
+str_uptr_t nebulas_rank::nr_info_to_json(const nr_ret_type &nr_ret) {
+  auto &nr_infos = std::get<2>(nr_ret);
+  return nr_infos_to_json(std::get<1>(nr_ret), nr_infos.size(),
+                          [&nr_infos](size_t i) { return *nr_infos[i]; });
+}
+
 nr_ret_type nebulas_rank::json_to_nr_info(const std::string &nr_result) {
 
   nr_ret_type nr_ret;
@@ -436,6 +569,54 @@ nr_ret_type nebulas_rank::json_to_nr_info(const std::string &nr_result) {
   return nr_ret;
 }
 
+nr_result_view::nr_result_view(const byte_t *data, size_t size)
+    : binary_result_view(data, size, magic, record_size) {}
+
+nr_result_view::nr_result_view(const std::string &data)
+    : nr_result_view(reinterpret_cast<const byte_t *>(data.data()),
+                     data.size()) {}
+
+nr_info_t nr_result_view::info(size_t i) const {
+  return nr_info_t({address(i), in_outs(i), median(i), weight(i),
+                    nr_score(i)});
+}
+
+str_uptr_t nebulas_rank::nr_info_to_binary(const nr_ret_type &nr_ret) {
+  auto &nr_infos = std::get<2>(nr_ret);
+  binary_result_writer w(nr_result_view::magic, nr_result_view::record_size,
+                         nr_infos.size(), std::get<1>(nr_ret));
+  for (size_t i = 0; i < nr_infos.size(); i++) {
+    const nr_info_t &info = *nr_infos[i];
+    byte_t *p = w.record(i);
+    w.write_address(p + nr_result_view::address_offset, info.m_address);
+    w.write_float(p + nr_result_view::in_outs_offset, info.m_in_outs);
+    w.write_float(p + nr_result_view::median_offset, info.m_median);
+    w.write_float(p + nr_result_view::weight_offset, info.m_weight);
+    w.write_float(p + nr_result_view::nr_score_offset, info.m_nr_score);
+  }
+  return w.finish();
+}
+
+nr_ret_type nebulas_rank::binary_to_nr_info(const std::string &nr_result) {
+  nr_result_view view(nr_result);
+
+  nr_ret_type nr_ret;
+  std::get<1>(nr_ret) = view.meta_info_json();
+  auto &infos = std::get<2>(nr_ret);
+  infos.reserve(view.size());
+  for (size_t i = 0; i < view.size(); i++) {
+    infos.push_back(std::make_shared<nr_info_t>(view.info(i)));
+  }
+  std::get<0>(nr_ret) = 1;
+  return nr_ret;
+}
+
+str_uptr_t nebulas_rank::nr_binary_to_json(const std::string &nr_result) {
+  nr_result_view view(nr_result);
+  return nr_infos_to_json(view.meta_info_json(), view.size(),
+                          [&view](size_t i) { return view.info(i); });
+}
+
 str_uptr_t nebulas_rank::get_nr_sum_str(const nr_ret_type &nr_ret) {
 
   boost::property_tree::ptree root;
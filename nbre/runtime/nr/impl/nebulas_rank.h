@@ -22,6 +22,7 @@
 
 #include "fs/blockchain/account/account_db.h"
 #include "fs/blockchain/transaction/transaction_db.h"
+#include "runtime/binary_result.h"
 #include "runtime/nr/graph/algo.h"
 #include "runtime/util.h"
 #include <boost/property_tree/ptree.hpp>
@@ -49,24 +50,82 @@ struct rank_params_t {
   floatxx_t m_lambda;
 };
 
+//! In place reader of NR results encoded by nebulas_rank::nr_info_to_binary,
+//! a record is address(27) padding(1) in_outs(4) median(4) weight(4) score(4)
+class nr_result_view : public binary_result_view {
+public:
+  static constexpr uint32_t magic = 0x4e424e52; // "NBNR"
+  //! record layout, shared by the writer, floats take 4 bytes
+  static constexpr size_t address_offset = 0;
+  static constexpr size_t in_outs_offset = binary_result::address_size + 1;
+  static constexpr size_t median_offset = in_outs_offset + 4;
+  static constexpr size_t weight_offset = median_offset + 4;
+  static constexpr size_t nr_score_offset = weight_offset + 4;
+  static constexpr size_t record_size = nr_score_offset + 4;
+  static_assert(record_size == 44, "NR result format changed");
+
+  nr_result_view(const byte_t *data, size_t size);
+  nr_result_view(const std::string &data);
+
+  inline address_t address(size_t i) const {
+    return read_address(record(i) + address_offset);
+  }
+  inline floatxx_t in_outs(size_t i) const {
+    return read_float(record(i) + in_outs_offset);
+  }
+  inline floatxx_t median(size_t i) const {
+    return read_float(record(i) + median_offset);
+  }
+  inline floatxx_t weight(size_t i) const {
+    return read_float(record(i) + weight_offset);
+  }
+  inline floatxx_t nr_score(size_t i) const {
+    return read_float(record(i) + nr_score_offset);
+  }
+
+  nr_info_t info(size_t i) const;
+};
+
 using uintxx_t = uint64_t;
 using transaction_db_ptr_t = std::unique_ptr<neb::fs::transaction_db>;
 using account_db_ptr_t = std::unique_ptr<neb::fs::account_db>;
 using nr_ret_type =
     std::tuple<int32_t, std::string, std::vector<std::shared_ptr<nr_info_t>>>;
 
+class incremental_nebulas_rank;
+
 class nebulas_rank {
+  friend class incremental_nebulas_rank;
+
 public:
   static std::vector<std::shared_ptr<nr_info_t>>
   get_nr_score(const transaction_db_ptr_t &tdb_ptr,
                const account_db_ptr_t &adb_ptr, const rank_params_t &rp,
-               neb::block_height_t start_block, neb::block_height_t end_block);
+               neb::block_height_t start_block, neb::block_height_t end_block,
+               bool parallel = false);
+
+  //! Rank accounts with the decycled and merged graph of all intervals, the
+  //! start balances of accounts are queried at once by get_start_balances.
+  static std::vector<std::shared_ptr<nr_info_t>> get_nr_score_from_merged_graph(
+      const account_db_ptr_t &adb_ptr, const rank_params_t &rp,
+      const std::vector<neb::fs::transaction_info_t> &txs,
+      const std::vector<neb::fs::transaction_info_t> &inter_txs,
+      const std::vector<std::vector<neb::fs::transaction_info_t>> &txs_v,
+      transaction_graph *tg,
+      const std::function<std::vector<wei_t>(const std::vector<address_t> &)>
+          &get_start_balances);
 
   static str_uptr_t get_nr_sum_str(const nr_ret_type &nr_ret);
 
   static str_uptr_t nr_info_to_json(const nr_ret_type &nr_ret);
   static nr_ret_type json_to_nr_info(const std::string &nr_result);
 
+  //! NR results are stored and cached in binary, see nr_result_view, JSON is
+  //! made only when a caller asks for it.
+  static str_uptr_t nr_info_to_binary(const nr_ret_type &nr_ret);
+  static nr_ret_type binary_to_nr_info(const std::string &nr_result);
+  static str_uptr_t nr_binary_to_json(const std::string &nr_result);
+
 #ifdef NDEBUG
 private:
 #else
@@ -84,6 +143,12 @@ public:
       const std::vector<std::vector<neb::fs::transaction_info_t>> &txs)
       -> std::unique_ptr<std::vector<transaction_graph_ptr_t>>;
 
+  //! Build graph, remove cycles and merge edges for each block interval,
+  //! intervals are independent so they may be handled in parallel.
+  static auto build_decycled_transaction_graphs(
+      const std::vector<std::vector<neb::fs::transaction_info_t>> &txs,
+      bool parallel) -> std::unique_ptr<std::vector<transaction_graph_ptr_t>>;
+
   static auto
   get_normal_accounts(const std::vector<neb::fs::transaction_info_t> &txs)
       -> std::unique_ptr<std::unordered_set<address_t>>;
@@ -117,6 +182,17 @@ public:
                                   floatxx_t theta, floatxx_t mu,
                                   floatxx_t lambda, floatxx_t S, floatxx_t R);
 
+  //! Batch versions over struct of arrays, bit identical to calling
+  //! f_account_weight and f_account_rank for each element.
+  static void f_account_weights(const std::vector<floatxx_t> &in_vals,
+                                const std::vector<floatxx_t> &out_vals,
+                                std::vector<floatxx_t> &weights);
+
+  static void f_account_ranks(const rank_params_t &rp,
+                              const std::vector<floatxx_t> &S,
+                              const std::vector<floatxx_t> &R,
+                              std::vector<floatxx_t> &ranks);
+
   static void convert_nr_info_to_ptree(const nr_info_t &info,
                                        boost::property_tree::ptree &pt);
 
@@ -124,6 +200,10 @@ public:
       const std::vector<std::pair<std::string, std::string>> &meta,
       boost::property_tree::ptree &root);
 
+  static str_uptr_t
+  nr_infos_to_json(const std::string &meta_info_json, size_t n,
+                   const std::function<nr_info_t(size_t)> &get_info);
+
 }; // class nebulas_rank
 } // namespace nr
 } // namespace rt
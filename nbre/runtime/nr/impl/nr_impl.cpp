@@ -24,7 +24,8 @@
 #include "common/int128_conversion.h"
 #include "common/nebulas_currency.h"
 #include "fs/blockchain/blockchain_api_test.h"
-#include "runtime/nr/impl/nebulas_rank.h"
+#include "fs/storage_holder.h"
+#include "runtime/nr/impl/incremental_nebulas_rank.h"
 
 namespace neb {
 namespace rt {
@@ -38,15 +39,17 @@ nr_ret_type entry_point_nr_impl(compatible_uint64_t start_block,
                                 nr_float_t mu, nr_float_t lambda) {
 
   std::unique_ptr<neb::fs::blockchain_api_base> pba;
+  neb::fs::rocksdb_storage *index_storage = nullptr;
   if (neb::use_test_blockchain) {
     pba = std::unique_ptr<neb::fs::blockchain_api_base>(
         new neb::fs::blockchain_api_test());
   } else {
     pba = std::unique_ptr<neb::fs::blockchain_api_base>(
         new neb::fs::blockchain_api());
+    index_storage = neb::fs::storage_holder::instance().nbre_db_ptr();
   }
   transaction_db_ptr_t tdb_ptr =
-      std::make_unique<neb::fs::transaction_db>(pba.get());
+      std::make_unique<neb::fs::transaction_db>(pba.get(), index_storage);
   account_db_ptr_t adb_ptr = std::make_unique<neb::fs::account_db>(pba.get());
 
   LOG(INFO) << "start block: " << start_block << " , end block: " << end_block;
@@ -61,8 +64,9 @@ nr_ret_type entry_point_nr_impl(compatible_uint64_t start_block,
   nr_ret_type ret;
   std::get<0>(ret) = 1;
   std::get<1>(ret) = meta_info_to_json(meta_info);
-  std::get<2>(ret) =
-      nebulas_rank::get_nr_score(tdb_ptr, adb_ptr, rp, start_block, end_block);
+  std::get<2>(ret) = incremental_nebulas_rank::instance().get_nr_score(
+      tdb_ptr, adb_ptr, rp, start_block, end_block,
+      neb::configuration::instance().nr_parallel_graph());
   return ret;
 }
 
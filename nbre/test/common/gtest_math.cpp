@@ -707,3 +707,157 @@ TEST(test_common_math, sqrt) {
                 precesion(expect_sqrt, 1e-1 * PRECESION));
   }
 }
+
+TEST(test_common_math, kernel_exp) {
+  EXPECT_EQ(neb::math::kernel::exp(neb::floatxx_t(0)), 1);
+
+  float delta(0.01);
+  for (float x = -50.0; x <= 50.0; x += delta) {
+    auto actual_x = neb::math::kernel::exp(neb::floatxx_t(x));
+    auto expect_x = std::exp(double(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, neb::floatxx_t(expect_x)) <
+                precesion(expect_x, 1e-1 * PRECESION));
+    auto series_x = neb::math::exp(neb::floatxx_t(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, series_x) <
+                precesion(float(series_x), 2 * PRECESION));
+  }
+}
+
+TEST(test_common_math, kernel_arctan) {
+  EXPECT_EQ(neb::math::kernel::arctan(neb::floatxx_t(0)), 0);
+
+  float delta(0.01);
+  for (float x = -100.0; x <= 100.0; x += delta) {
+    auto actual_x = neb::math::kernel::arctan(neb::floatxx_t(x));
+    auto expect_x = std::atan(double(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, neb::floatxx_t(expect_x)) <
+                precesion(expect_x, 1e-1 * PRECESION));
+    auto series_x = neb::math::arctan(neb::floatxx_t(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, series_x) <
+                precesion(1.0f, 1e1 * PRECESION));
+  }
+}
+
+TEST(test_common_math, kernel_sin) {
+  EXPECT_EQ(neb::math::kernel::sin(neb::floatxx_t(0)), 0);
+
+  float delta(0.01);
+  for (float x = -100.0; x <= 100.0; x += delta) {
+    auto actual_x = neb::math::kernel::sin(neb::floatxx_t(x));
+    auto expect_x = std::sin(double(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, neb::floatxx_t(expect_x)) <
+                precesion(1.0f, 1e-1 * PRECESION));
+    auto series_x = neb::math::sin(neb::floatxx_t(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, series_x) <
+                precesion(1.0f, 1e2 * PRECESION));
+  }
+}
+
+TEST(test_common_math, kernel_ln) {
+  EXPECT_EQ(neb::math::kernel::ln(neb::floatxx_t(1)), 0);
+
+  float delta(0.01);
+  for (float x = delta; x < 100.0; x += delta) {
+    auto actual_x = neb::math::kernel::ln(neb::floatxx_t(x));
+    auto expect_x = std::log(double(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, neb::floatxx_t(expect_x)) <
+                precesion(1.0f, 1e-1 * PRECESION));
+  }
+
+  for (float x = 3.7f; x < 1e30f; x *= 3.7f) {
+    auto actual_x = neb::math::kernel::ln(neb::floatxx_t(x));
+    auto expect_x = std::log(double(x));
+    EXPECT_TRUE(neb::math::abs(actual_x, neb::floatxx_t(expect_x)) <
+                precesion(expect_x, 1e-1 * PRECESION));
+  }
+  float tiny = std::numeric_limits<float>::denorm_min();
+  EXPECT_TRUE(neb::math::abs(neb::math::kernel::ln(neb::floatxx_t(tiny)),
+                             neb::floatxx_t(std::log(double(tiny)))) <
+              precesion(std::log(double(tiny)), 1e-1 * PRECESION));
+}
+
+TEST(test_common_math, kernel_pow) {
+  std::mt19937 mt(1024);
+  std::uniform_real_distribution<float> dis_x(0.01, 100);
+  std::uniform_real_distribution<float> dis_y(-3, 3);
+  for (auto i = 0; i < 1000; i++) {
+    float x = dis_x(mt);
+    float y = dis_y(mt);
+    auto actual_pow =
+        neb::math::kernel::pow(neb::floatxx_t(x), neb::floatxx_t(y));
+    auto expect_pow = std::pow(double(x), double(y));
+    EXPECT_TRUE(neb::math::abs(actual_pow, neb::floatxx_t(expect_pow)) <
+                precesion(expect_pow, PRECESION));
+  }
+  EXPECT_EQ(neb::math::kernel::pow(neb::floatxx_t(0), neb::floatxx_t(2)), 0);
+}
+
+TEST(test_common_math, exit_cond) {
+  auto str_exit_cond = [](const neb::floatxx_t &x, const neb::floatxx_t &y) {
+    if (x - y < MATH_MIN && y - x < MATH_MIN) {
+      return true;
+    }
+    auto sx = neb::math::to_string(x);
+    auto sy = neb::math::to_string(y);
+    return (sx == "inf" && sy == "inf") || (sx == "-nan" && sy == "-nan");
+  };
+
+  float inf = std::numeric_limits<float>::infinity();
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> vals({0.0f, -0.0f, 1.0f, -1.0f, 1e-6f, 1e30f, inf, -inf,
+                           nan, -nan});
+  for (auto x : vals) {
+    for (auto y : vals) {
+      EXPECT_EQ(neb::math::exit_cond(neb::floatxx_t(x), neb::floatxx_t(y)),
+                str_exit_cond(neb::floatxx_t(x), neb::floatxx_t(y)));
+    }
+  }
+}
+
+TEST(test_common_math, batch) {
+  auto bits = [](const neb::floatxx_t &x) {
+    return static_cast<float32_t>(x).v;
+  };
+
+  std::mt19937 mt(1024);
+  std::uniform_real_distribution<float> dis(-50, 50);
+  std::uniform_real_distribution<float> dis_positive(0.01, 100);
+  std::vector<neb::floatxx_t> x;
+  std::vector<neb::floatxx_t> y;
+  for (auto i = 0; i < 200; i++) {
+    x.push_back(neb::floatxx_t(dis(mt)));
+    y.push_back(neb::floatxx_t(dis_positive(mt)));
+  }
+
+  std::vector<neb::floatxx_t> ret;
+  neb::math::batch::exp(x, ret);
+  ASSERT_EQ(ret.size(), x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_EQ(bits(ret[i]), bits(neb::math::exp(x[i])));
+  }
+  neb::math::batch::arctan(x, ret);
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_EQ(bits(ret[i]), bits(neb::math::arctan(x[i])));
+  }
+  neb::math::batch::sin(x, ret);
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_EQ(bits(ret[i]), bits(neb::math::sin(x[i])));
+  }
+  neb::math::batch::fast_ln(y, ret);
+  for (size_t i = 0; i < y.size(); i++) {
+    EXPECT_EQ(bits(ret[i]), bits(neb::math::fast_ln(y[i])));
+  }
+  neb::math::batch::pow(y, neb::floatxx_t(0.5), ret);
+  for (size_t i = 0; i < y.size(); i++) {
+    EXPECT_EQ(bits(ret[i]),
+              bits(neb::math::pow(y[i], neb::floatxx_t(0.5))));
+  }
+
+  std::vector<neb::floatxx_t> z(x.size(), neb::floatxx_t(0.1));
+  neb::math::batch::pow(y, z, ret);
+  for (size_t i = 0; i < y.size(); i++) {
+    EXPECT_EQ(bits(ret[i]), bits(neb::math::pow(y[i], z[i])));
+  }
+  z.pop_back();
+  EXPECT_THROW(neb::math::batch::pow(y, z, ret), std::invalid_argument);
+}
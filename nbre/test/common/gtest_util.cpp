@@ -268,3 +268,31 @@ TEST(test_common, address) {
   std::string t = std::to_string(ret_bytes);
   EXPECT_EQ(s, t);
 }
+
+TEST(test_common, inline_address) {
+  std::string base58_str("n1EjkdHBDpdjFfVaeJqMQW11RhYqrrjCZR7");
+  auto b = neb::bytes::from_base58(base58_str);
+  neb::address_t addr = neb::base58_to_address(base58_str);
+  EXPECT_EQ(addr.size(), NAS_ADDRESS_LEN);
+  EXPECT_TRUE(neb::is_normal_address(addr));
+  EXPECT_EQ(addr.to_base58(), base58_str);
+  EXPECT_TRUE(addr.to_bytes() == b);
+  EXPECT_EQ(std::hash<neb::address_t>()(addr), std::hash<neb::bytes>()(b));
+  EXPECT_EQ(std::hash<neb::address_t>()(addr),
+            std::hash<std::string>()(neb::address_to_string(addr)));
+
+  neb::address_t a = neb::to_address("a");
+  neb::address_t ab = neb::to_address("ab");
+  neb::address_t b1 = neb::to_address("b");
+  EXPECT_EQ(a.size(), 1);
+  EXPECT_TRUE(a < ab);
+  EXPECT_TRUE(ab < b1);
+  EXPECT_FALSE(ab < a);
+  EXPECT_TRUE(a != ab);
+  EXPECT_TRUE(a == neb::to_address("a"));
+  EXPECT_EQ(a < ab, neb::string_to_byte("a") < neb::string_to_byte("ab"));
+
+  EXPECT_TRUE(neb::address_t().empty());
+  EXPECT_THROW(neb::to_address(std::string(NAS_ADDRESS_LEN + 1, 'a')),
+               std::invalid_argument);
+}
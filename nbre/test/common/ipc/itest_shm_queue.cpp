@@ -0,0 +1,207 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "common/ipc/shm_queue.h"
+#include "fs/util.h"
+#include "test/common/ipc/ipc_test.h"
+#include <chrono>
+#include <iostream>
+
+//! Compares shm_queue with locked_queue, the mutex guarded vector that
+//! shm_queue was before. The server produces and the client consumes, over a
+//! forward queue and a backward one for echo and acknowledgement.
+namespace {
+typedef boost::interprocess::managed_shared_memory managed_shm_t;
+
+class locked_queue {
+public:
+  locked_queue(const std::string &name,
+               neb::ipc::internal::shm_session_base *session,
+               managed_shm_t *shmem, size_t capacity)
+      : m_name(name), m_bookkeeper(session->bookkeeper()), m_shmem(shmem),
+        m_capacity(capacity),
+        m_allocator(shmem->get_segment_manager()) {
+    m_mutex = m_bookkeeper->acquire_named_mutex(m_name + ".mutex");
+    m_empty_cond = m_bookkeeper->acquire_named_condition(m_name + ".empty");
+    m_full_cond = m_bookkeeper->acquire_named_condition(m_name + ".full");
+    m_buffer =
+        m_shmem->find_or_construct<shm_vector_t>(m_name.c_str())(m_allocator);
+  }
+  ~locked_queue() {
+    m_shmem->destroy<shm_vector_t>(m_name.c_str());
+    m_bookkeeper->release_named_mutex(m_name + ".mutex");
+    m_bookkeeper->release_named_condition(m_name + ".empty");
+    m_bookkeeper->release_named_condition(m_name + ".full");
+  }
+
+  void push_back(neb::ipc::shm_type_id_t type_id, void *ptr) {
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
+        *m_mutex);
+    while (m_buffer->size() == m_capacity) {
+      m_full_cond->wait(_l);
+    }
+    m_buffer->push_back(
+        std::make_pair(m_shmem->get_handle_from_address(ptr), type_id));
+    if (m_buffer->size() == 1) {
+      m_empty_cond->notify_all();
+    }
+  }
+
+  std::tuple<void *, neb::ipc::shm_type_id_t> pop_front() {
+    boost::interprocess::scoped_lock<boost::interprocess::named_mutex> _l(
+        *m_mutex);
+    while (m_buffer->empty()) {
+      m_empty_cond->wait(_l);
+    }
+    auto e = m_buffer->front();
+    m_buffer->erase(m_buffer->begin());
+    if (m_buffer->size() == m_capacity - 1) {
+      m_full_cond->notify_all();
+    }
+    return std::make_tuple(m_shmem->get_address_from_handle(e.first),
+                           e.second);
+  }
+
+private:
+  typedef std::pair<managed_shm_t::handle_t, neb::ipc::shm_type_id_t> elem_t;
+  typedef boost::interprocess::allocator<elem_t,
+                                         managed_shm_t::segment_manager>
+      allocator_t;
+  typedef boost::interprocess::vector<elem_t, allocator_t> shm_vector_t;
+
+  std::string m_name;
+  neb::ipc::internal::shm_bookkeeper *m_bookkeeper;
+  managed_shm_t *m_shmem;
+  size_t m_capacity;
+  allocator_t m_allocator;
+  shm_vector_t *m_buffer;
+  std::unique_ptr<boost::interprocess::named_mutex> m_mutex;
+  std::unique_ptr<boost::interprocess::named_condition> m_empty_cond;
+  std::unique_ptr<boost::interprocess::named_condition> m_full_cond;
+};
+
+const size_t queue_capacity = 128;
+const size_t value_num = 2 * queue_capacity;
+const size_t throughput_num = 1000000;
+const size_t latency_num = 100000;
+const neb::ipc::shm_type_id_t value_type_id = 1;
+
+std::string base_name = neb::fs::get_user_name() + "test_shm_queue";
+
+std::string shm_name() { return base_name + ".mem"; }
+
+//! the other side may still be starting, wait till the first element
+template <typename Q> void *pop_value(Q &q) {
+  while (true) {
+    void *p = std::get<0>(q.pop_front());
+    if (p) {
+      return p;
+    }
+  }
+}
+
+template <typename Q>
+void produce(const std::string &label, managed_shm_t *shmem,
+             neb::ipc::internal::shm_session_base *session) {
+  std::string name = base_name + "." + label;
+  uint64_t *values =
+      shmem->find_or_construct<uint64_t>((name + ".values").c_str())[value_num](
+          0);
+  Q forward(name + ".forward", session, shmem, queue_capacity);
+  Q backward(name + ".backward", session, shmem, queue_capacity);
+  auto done = session->bookkeeper()->acquire_named_semaphore(name + ".done");
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < throughput_num; i++) {
+    values[i % value_num] = i;
+    forward.push_back(value_type_id, &values[i % value_num]);
+  }
+  pop_value(backward);
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  std::cout << label << " throughput: " << throughput_num * 1000000 / us
+            << " ops/s" << std::endl;
+
+  size_t mismatch_num = 0;
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < latency_num; i++) {
+    values[0] = i;
+    forward.push_back(value_type_id, &values[0]);
+    uint64_t *p = reinterpret_cast<uint64_t *>(pop_value(backward));
+    mismatch_num += (*p != i);
+  }
+  us = std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - start)
+           .count();
+  std::cout << label << " round trip latency: " << us * 1000 / latency_num
+            << " ns" << std::endl;
+  IPC_EXPECT(mismatch_num == 0);
+  done->post();
+  session->bookkeeper()->release_named_semaphore(name + ".done");
+}
+
+template <typename Q>
+void consume(const std::string &label, managed_shm_t *shmem,
+             neb::ipc::internal::shm_session_base *session) {
+  std::string name = base_name + "." + label;
+  Q forward(name + ".forward", session, shmem, queue_capacity);
+  Q backward(name + ".backward", session, shmem, queue_capacity);
+  auto done = session->bookkeeper()->acquire_named_semaphore(name + ".done");
+
+  uint64_t *p = nullptr;
+  size_t mismatch_num = 0;
+  for (uint64_t i = 0; i < throughput_num; i++) {
+    p = reinterpret_cast<uint64_t *>(pop_value(forward));
+    mismatch_num += (*p != i);
+  }
+  IPC_EXPECT(mismatch_num == 0);
+  backward.push_back(value_type_id, p);
+
+  for (uint64_t i = 0; i < latency_num; i++) {
+    p = reinterpret_cast<uint64_t *>(pop_value(forward));
+    backward.push_back(value_type_id, p);
+  }
+  //! keep the queues till the producer is done with them
+  done->wait();
+  session->bookkeeper()->release_named_semaphore(name + ".done");
+}
+} // namespace
+
+IPC_PRELUDE(test_shm_queue_compare) {
+  neb::ipc::internal::shm_session_util s(base_name + ".session");
+  s.reset();
+  boost::interprocess::shared_memory_object::remove(shm_name().c_str());
+}
+
+IPC_SERVER(test_shm_queue_compare) {
+  neb::ipc::internal::shm_session_util s(base_name + ".session");
+  managed_shm_t shmem(boost::interprocess::open_or_create, shm_name().c_str(),
+                      1024 * 1024);
+  produce<locked_queue>("locked_queue", &shmem, &s);
+  produce<neb::ipc::internal::shm_queue>("shm_queue", &shmem, &s);
+}
+
+IPC_CLIENT(test_shm_queue_compare) {
+  neb::ipc::internal::shm_session_util s(base_name + ".session");
+  managed_shm_t shmem(boost::interprocess::open_or_create, shm_name().c_str(),
+                      1024 * 1024);
+  consume<locked_queue>("locked_queue", &shmem, &s);
+  consume<neb::ipc::internal::shm_queue>("shm_queue", &shmem, &s);
+}
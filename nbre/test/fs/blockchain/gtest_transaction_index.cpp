@@ -0,0 +1,75 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "common/common.h"
+#include "fs/blockchain/transaction/transaction_index.h"
+#include <gtest/gtest.h>
+
+TEST(test_transaction_index, encode_decode) {
+  std::vector<neb::fs::transaction_info_t> txs;
+  for (int32_t i = 0; i < 8; i++) {
+    neb::fs::transaction_info_t info;
+    info.m_height = 1024;
+    info.m_status = 1;
+    info.m_from = neb::to_address("from" + std::to_string(i));
+    info.m_to = neb::to_address("to" + std::to_string(i));
+    info.m_tx_type = i % 2 ? "binary" : "call";
+    info.m_tx_value = 1000000000000000000ULL;
+    info.m_tx_value = info.m_tx_value * 1000000000000000000ULL + i;
+    info.m_timestamp = 1536740000 + i;
+    info.m_gas_used = 20000 + i;
+    info.m_gas_price = 1000000;
+    txs.push_back(info);
+  }
+
+  auto record = neb::fs::transaction_index::encode_transactions(txs);
+  std::vector<neb::fs::transaction_info_t> ret;
+  neb::fs::transaction_index::decode_transactions(record, 1024, ret);
+  EXPECT_EQ(ret.size(), txs.size());
+  for (size_t i = 0; i < txs.size() && i < ret.size(); i++) {
+    EXPECT_EQ(ret[i].m_height, txs[i].m_height);
+    EXPECT_EQ(ret[i].m_status, txs[i].m_status);
+    EXPECT_EQ(ret[i].m_from, txs[i].m_from);
+    EXPECT_EQ(ret[i].m_to, txs[i].m_to);
+    EXPECT_EQ(ret[i].m_tx_type, txs[i].m_tx_type);
+    EXPECT_TRUE(ret[i].m_tx_value == txs[i].m_tx_value);
+    EXPECT_EQ(ret[i].m_timestamp, txs[i].m_timestamp);
+    EXPECT_TRUE(ret[i].m_gas_used == txs[i].m_gas_used);
+    EXPECT_TRUE(ret[i].m_gas_price == txs[i].m_gas_price);
+  }
+
+  ret.clear();
+  record = neb::fs::transaction_index::encode_transactions(ret);
+  neb::fs::transaction_index::decode_transactions(record, 1, ret);
+  EXPECT_TRUE(ret.empty());
+
+  neb::bytes broken(record.value(), record.size() - 1);
+  EXPECT_THROW(
+      neb::fs::transaction_index::decode_transactions(broken, 1, ret),
+      std::invalid_argument);
+}
+
+TEST(test_transaction_index, key_order) {
+  auto k1 = neb::fs::transaction_index::height_to_key(255);
+  auto k2 = neb::fs::transaction_index::height_to_key(256);
+  auto k3 = neb::fs::transaction_index::height_to_key(65536);
+  EXPECT_TRUE(neb::byte_to_string(k1) < neb::byte_to_string(k2));
+  EXPECT_TRUE(neb::byte_to_string(k2) < neb::byte_to_string(k3));
+}
@@ -19,8 +19,10 @@
 //
 
 #include "common/configuration.h"
+#include "fs/bc_storage_session.h"
 #include "fs/blockchain.h"
 #include "fs/blockchain/trie/trie.h"
+#include "test/fs/gtest_common.h"
 #include <gtest/gtest.h>
 
 TEST(test_fs, key_to_route) {
@@ -49,3 +51,63 @@ TEST(test_fs, route_to_key) {
 }
 
 TEST(test_fs, get_trie_node) {}
+
+TEST(test_fs, get_trie_nodes) {
+  neb::fs::bc_storage_session::instance().close();
+  neb::fs::bc_storage_session::instance().init(
+      get_db_path_for_write(), neb::fs::storage_open_for_readwrite);
+
+  neb::fs::trie t;
+  auto node_type = [](neb::fs::trie_node_type type) {
+    return neb::bytes({static_cast<neb::byte_t>(type)});
+  };
+  auto hash_bytes = [](const neb::fs::trie_node_ptr &node) {
+    return neb::from_fix_bytes(node->hash());
+  };
+
+  // root(branch) -1-> leaf 234
+  //              -5-> ext 6 -> branch -7-> leaf 8
+  //                                   -9-> leaf 0
+  //              -a-> leaf bcd
+  auto leaf_a = t.create_node({node_type(neb::fs::trie_node_leaf),
+                               neb::bytes({2, 3, 4}), neb::bytes({'a'})});
+  auto leaf_b = t.create_node({node_type(neb::fs::trie_node_leaf),
+                               neb::bytes({8}), neb::bytes({'b'})});
+  auto leaf_c = t.create_node({node_type(neb::fs::trie_node_leaf),
+                               neb::bytes({0}), neb::bytes({'c'})});
+  auto leaf_d = t.create_node({node_type(neb::fs::trie_node_leaf),
+                               neb::bytes({0xb, 0xc, 0xd}), neb::bytes({'d'})});
+  std::vector<neb::bytes> br_val(16);
+  br_val[7] = hash_bytes(leaf_b);
+  br_val[9] = hash_bytes(leaf_c);
+  auto br = t.create_node(br_val);
+  auto ext = t.create_node({node_type(neb::fs::trie_node_extension),
+                            neb::bytes({6}), hash_bytes(br)});
+  std::vector<neb::bytes> root_val(16);
+  root_val[1] = hash_bytes(leaf_a);
+  root_val[5] = hash_bytes(ext);
+  root_val[0xa] = hash_bytes(leaf_d);
+  auto root = t.create_node(root_val);
+
+  std::vector<neb::bytes> keys({
+      {0x12, 0x34}, {0x56, 0x78}, {0x56, 0x90}, {0xab, 0xcd}, {0x12, 0x35},
+      {0x56, 0x71}, {0x57, 0x78}, {0xff, 0xff}, {0x12}, {0x12, 0x34, 0x00},
+      {0x56, 0x78},
+  });
+  std::vector<neb::bytes> vals;
+  auto found = t.get_trie_nodes(hash_bytes(root), keys, vals);
+  ASSERT_EQ(found.size(), keys.size());
+  ASSERT_EQ(vals.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    neb::bytes val;
+    bool expect_found = t.get_trie_node(hash_bytes(root), keys[i], val);
+    EXPECT_EQ(found[i], expect_found);
+    if (expect_found) {
+      EXPECT_EQ(vals[i], val);
+    }
+  }
+  EXPECT_TRUE(found[0] && found[1] && found[2] && found[3] && found[10]);
+  EXPECT_EQ(vals[2], neb::bytes({'c'}));
+  EXPECT_GT(neb::fs::trie_node_cache::instance().hits(), 0);
+  neb::fs::bc_storage_session::instance().close();
+}
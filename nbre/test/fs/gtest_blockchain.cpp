@@ -156,3 +156,107 @@ TEST(test_fs, load_LIB_block) {
   EXPECT_EQ(header.timestamp(), 1531895265);
   EXPECT_EQ(header.chain_id(), 1003);
 }
+
+TEST(test_fs, block_cache) {
+  // a session opened read-only by other tests rejects writes
+  neb::fs::bc_storage_session::instance().close();
+  neb::fs::bc_storage_session::instance().init(
+      get_db_path_for_write(), neb::fs::storage_open_for_readwrite);
+
+  corepb::Block block;
+  block.set_height(1024);
+  auto header = block.mutable_header();
+  header->set_hash(std::string(32, 'h'));
+  header->set_timestamp(1531895265);
+  header->set_chain_id(1003);
+  header->set_state_root(std::string(32, 's'));
+  header->set_txs_root(std::string(32, 't'));
+  header->set_events_root(std::string(32, 'e'));
+  for (int32_t i = 0; i < 16; i++) {
+    auto tx = block.add_transactions();
+    tx->set_hash(std::to_string(i));
+    tx->set_nonce(i);
+  }
+  neb::fs::blockchain::write_LIB_block(&block);
+
+  auto &cache = neb::fs::block_cache::instance();
+  cache.clear();
+  auto header_ptr = neb::fs::blockchain::load_block_header_with_height(1024);
+  EXPECT_EQ(header_ptr->m_height, 1024);
+  EXPECT_EQ(header_ptr->m_timestamp, 1531895265);
+  EXPECT_EQ(header_ptr->m_hash, std::string(32, 'h'));
+  EXPECT_EQ(header_ptr->m_state_root, std::string(32, 's'));
+  EXPECT_EQ(header_ptr->m_txs_root, std::string(32, 't'));
+  EXPECT_EQ(header_ptr->m_events_root, std::string(32, 'e'));
+  EXPECT_EQ(cache.header_misses(), 1);
+  EXPECT_EQ(cache.block_misses(), 0);
+
+  neb::fs::blockchain::load_block_header_with_height(1024);
+  EXPECT_EQ(cache.header_hits(), 1);
+
+  auto block_ptr = neb::fs::blockchain::load_shared_block_with_height(1024);
+  EXPECT_EQ(block_ptr->transactions_size(), 16);
+  EXPECT_EQ(cache.block_misses(), 1);
+  auto copy = neb::fs::blockchain::load_block_with_height(1024);
+  EXPECT_EQ(copy->SerializeAsString(), block.SerializeAsString());
+  EXPECT_EQ(cache.block_hits(), 1);
+  neb::fs::bc_storage_session::instance().close();
+}
+
+TEST(test_fs, load_txs_of_type_with_heights) {
+  auto &session = neb::fs::bc_storage_session::instance();
+  session.close();
+  session.init(get_db_path_for_write(), neb::fs::storage_open_for_readwrite);
+
+  // block 2048 + i has i protocol transactions among binary ones
+  for (int32_t i = 0; i < 4; i++) {
+    corepb::Block block;
+    block.set_height(2048 + i);
+    block.mutable_header()->set_hash(std::string(32, 'a' + i));
+    for (int32_t j = 0; j < 8; j++) {
+      auto tx = block.add_transactions();
+      tx->set_nonce(j);
+      tx->mutable_data()->set_type(j < i ? "protocol" : "binary");
+      tx->mutable_data()->set_payload("protocol");
+    }
+    neb::fs::blockchain::write_LIB_block(&block);
+  }
+
+  // read as nbre does, from a read-only open
+  session.close();
+  session.init(get_db_path_for_write(), neb::fs::storage_open_for_readonly);
+  auto blocks_bytes =
+      neb::fs::blockchain::load_block_bytes_with_heights(2048, 2052);
+  EXPECT_EQ(blocks_bytes.size(), 4);
+  for (int32_t i = 0; i < 4; i++) {
+    corepb::Block block;
+    EXPECT_TRUE(
+        block.ParseFromArray(blocks_bytes[i].value(), blocks_bytes[i].size()));
+    EXPECT_EQ(block.height(), 2048 + i);
+  }
+
+  auto txs_of_blocks = neb::fs::blockchain::load_txs_of_type_with_heights(
+      2048, 2052, "protocol");
+  EXPECT_EQ(txs_of_blocks.size(), 4);
+  for (int32_t i = 0; i < 4; i++) {
+    EXPECT_EQ(txs_of_blocks[i].size(), i);
+    for (int32_t j = 0; j < i; j++) {
+      EXPECT_EQ(txs_of_blocks[i][j].nonce(), j);
+      EXPECT_EQ(txs_of_blocks[i][j].data().type(), "protocol");
+      EXPECT_EQ(txs_of_blocks[i][j].data().payload(), "protocol");
+    }
+  }
+
+  corepb::Block block;
+  block.add_transactions()->mutable_data()->set_type("binary");
+  auto block_bytes = neb::string_to_byte(block.SerializeAsString());
+  EXPECT_TRUE(
+      neb::fs::block_cache::parse_txs_of_type(block_bytes, "protocol").empty());
+  EXPECT_EQ(
+      neb::fs::block_cache::parse_txs_of_type(block_bytes, "binary").size(), 1);
+
+  block_bytes = neb::string_to_byte("protocol\xff");
+  EXPECT_THROW(neb::fs::block_cache::parse_txs_of_type(block_bytes, "protocol"),
+               std::runtime_error);
+  session.close();
+}
@@ -22,10 +22,14 @@
 #include "core/command.h"
 #include "fs/blockchain.h"
 #include "fs/proto/block.pb.h"
+#include "fs/rocksdb_profile.h"
 #include "fs/rocksdb_storage.h"
 #include "fs/util.h"
 #include "gtest_common.h"
+#include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
+#include <thread>
+#include <unistd.h>
 
 std::string get_db_path_for_read() {
   std::string cur_path = neb::configuration::instance().nbre_root_dir();
@@ -97,3 +101,199 @@ TEST(test_fs, storage_batch_op) {
   EXPECT_EQ(value, 234);
 }
 
+
+TEST(test_fs, storage_multi_get_and_scan) {
+  std::string db_path = get_db_path_for_write();
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(db_path, neb::fs::storage_open_for_readwrite);
+
+  std::vector<std::string> keys({"mg_a", "mg_b", "mg_c", "mh_a"});
+  for (size_t i = 0; i < keys.size(); i++) {
+    rs.put(keys[i], neb::number_to_byte<neb::bytes>(static_cast<int64_t>(i)));
+  }
+
+  auto values = rs.multi_get(keys);
+  EXPECT_EQ(values.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(neb::byte_to_number<int64_t>(values[i]), static_cast<int64_t>(i));
+    rs.read_bytes(neb::string_to_byte(keys[i]),
+                  [i](const neb::byte_t *v, size_t size) {
+                    EXPECT_EQ(neb::byte_to_number<int64_t>(
+                                  const_cast<neb::byte_t *>(v), size),
+                              static_cast<int64_t>(i));
+                  });
+  }
+  EXPECT_THROW(rs.multi_get({"mg_a", "mg_no_such_key"}),
+               neb::fs::storage_general_failure);
+
+  std::vector<std::string> scanned;
+  rs.scan_prefix(neb::string_to_byte("mg_"),
+                 [&scanned](const neb::bytes &k, const neb::bytes &) {
+                   scanned.push_back(neb::byte_to_string(k));
+                 });
+  EXPECT_EQ(scanned, std::vector<std::string>({"mg_a", "mg_b", "mg_c"}));
+
+  scanned.clear();
+  rs.scan(neb::string_to_byte("mg_b"), neb::string_to_byte("mh_b"),
+          [&scanned](const neb::bytes &k, const neb::bytes &) {
+            scanned.push_back(neb::byte_to_string(k));
+          });
+  EXPECT_EQ(scanned, std::vector<std::string>({"mg_b", "mg_c", "mh_a"}));
+
+  EXPECT_EQ(neb::fs::storage::prefix_end(neb::bytes({0x01, 0xff})),
+            neb::bytes({0x02}));
+  EXPECT_TRUE(neb::fs::storage::prefix_end(neb::bytes({0xff, 0xff})).empty());
+
+  for (auto &k : keys) {
+    rs.del(k);
+  }
+}
+
+TEST(test_fs, storage_batch_auto_flush) {
+  std::string db_path = get_db_path_for_write();
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(db_path, neb::fs::storage_open_for_readwrite);
+
+  neb::fs::rocksdb_batch_options options;
+  options.max_batch_count = 2;
+  rs.set_batch_options(options);
+
+  rs.batch_write([&]() {
+    EXPECT_TRUE(rs.is_batch_enabled());
+    rs.put("ba_a", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(1)));
+    // visible to the batch, not flushed yet
+    EXPECT_EQ(neb::byte_to_number<int64_t>(rs.get("ba_a")), 1);
+
+    rs.put("ba_b", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(2)));
+    rs.put("ba_c", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(3)));
+  });
+  EXPECT_FALSE(rs.is_batch_enabled());
+
+  auto values = rs.multi_get({"ba_a", "ba_b", "ba_c"});
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(neb::byte_to_number<int64_t>(values[i]),
+              static_cast<int64_t>(i + 1));
+  }
+
+  // a flushed batch isn't written again
+  rs.batch_write([&]() { rs.del("ba_a"); });
+  rs.put("ba_a", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(4)));
+  rs.enable_batch();
+  rs.flush();
+  rs.disable_batch();
+  EXPECT_EQ(neb::byte_to_number<int64_t>(rs.get("ba_a")), 4);
+
+  rs.batch_write([&]() {
+    rs.del("ba_a");
+    rs.del("ba_b");
+    rs.del("ba_c");
+  });
+  EXPECT_THROW(rs.get("ba_a"), neb::fs::storage_general_failure);
+}
+
+TEST(test_fs, storage_batch_options_from_configuration) {
+  auto &conf = neb::configuration::instance();
+  size_t max_batch_count = conf.rocksdb_batch_max_count();
+  conf.rocksdb_batch_max_count() = 1;
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(get_db_path_for_write(),
+                   neb::fs::storage_open_for_readwrite);
+  conf.rocksdb_batch_max_count() = max_batch_count;
+
+  rs.batch_write([&]() {
+    rs.put("bc_a", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(1)));
+    // flushed already, so other threads, which read the db, see it
+    std::thread t([&rs]() {
+      EXPECT_EQ(neb::byte_to_number<int64_t>(rs.get("bc_a")), 1);
+    });
+    t.join();
+  });
+  rs.del("bc_a");
+  rs.close_database();
+}
+
+TEST(test_fs, storage_read_only_rejects_writes) {
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(get_db_path_for_read(), neb::fs::storage_open_for_readonly);
+  EXPECT_FALSE(rs.is_batch_enabled());
+  EXPECT_THROW(rs.put("ro_a", neb::string_to_byte("xxx")),
+               neb::fs::storage_general_failure);
+  EXPECT_THROW(rs.del("ro_a"), neb::fs::storage_general_failure);
+  EXPECT_THROW(rs.batch_write([]() {}), neb::fs::storage_general_failure);
+  EXPECT_FALSE(rs.is_batch_enabled());
+  rs.close_database();
+}
+
+TEST(test_fs, storage_secondary_removes_its_dir) {
+  std::string prefix = "nbre_secondary_" + std::to_string(getpid()) + "_";
+  auto secondary_dirs = [&prefix]() {
+    size_t n = 0;
+    boost::filesystem::directory_iterator end;
+    for (boost::filesystem::directory_iterator it(neb::fs::tmp_dir());
+         it != end; ++it) {
+      n += it->path().filename().string().compare(0, prefix.size(), prefix) ==
+           0;
+    }
+    return n;
+  };
+
+  size_t before = secondary_dirs();
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(get_db_path_for_read(), neb::fs::storage_open_as_secondary);
+  EXPECT_EQ(secondary_dirs(), before + 1);
+  EXPECT_THROW(rs.put("sec_a", neb::string_to_byte("xxx")),
+               neb::fs::storage_general_failure);
+  rs.close_database();
+  EXPECT_EQ(secondary_dirs(), before);
+}
+
+TEST(test_fs, storage_batch_per_thread) {
+  neb::fs::rocksdb_storage rs;
+  rs.open_database(get_db_path_for_write(),
+                   neb::fs::storage_open_for_readwrite);
+
+  rs.batch_write([&]() {
+    rs.put("bt_a", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(1)));
+    std::thread t([&]() {
+      // neither in batch mode nor seeing the batch of the other thread
+      EXPECT_FALSE(rs.is_batch_enabled());
+      EXPECT_THROW(rs.get("bt_a"), neb::fs::storage_general_failure);
+      rs.put("bt_b", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(2)));
+    });
+    t.join();
+    EXPECT_TRUE(rs.is_batch_enabled());
+    EXPECT_EQ(neb::byte_to_number<int64_t>(rs.get("bt_a")), 1);
+    EXPECT_EQ(neb::byte_to_number<int64_t>(rs.get("bt_b")), 2);
+  });
+
+  auto values = rs.multi_get({"bt_a", "bt_b"});
+  EXPECT_EQ(neb::byte_to_number<int64_t>(values[0]), 1);
+  EXPECT_EQ(neb::byte_to_number<int64_t>(values[1]), 2);
+  rs.del("bt_a");
+  rs.del("bt_b");
+}
+
+TEST(test_fs, storage_open_with_profile) {
+  std::string db_path = get_db_path_for_write();
+  for (auto profile : {"trie-random-read", "ir-store", "bulk-write"}) {
+    neb::fs::rocksdb_storage rs;
+    rs.open_database(db_path, neb::fs::storage_open_for_readwrite, profile);
+    rs.put("pf_a", neb::number_to_byte<neb::bytes>(static_cast<int64_t>(1)));
+    EXPECT_EQ(neb::byte_to_number<int64_t>(rs.get("pf_a")), 1);
+    rs.del("pf_a");
+    EXPECT_TRUE(rs.statistics().empty());
+    rs.close_database();
+  }
+
+  neb::fs::rocksdb_storage rs;
+  EXPECT_THROW(rs.open_database(db_path, neb::fs::storage_open_for_readwrite,
+                                "no-such-profile"),
+               std::invalid_argument);
+
+  auto p = neb::fs::rocksdb_profiles::instance().get("ir-store");
+  p.statistics = true;
+  neb::fs::rocksdb_profiles::instance().set("ir-store-stats", p);
+  rs.open_database(db_path, neb::fs::storage_open_for_readwrite,
+                   "ir-store-stats");
+  EXPECT_FALSE(rs.statistics().empty());
+}
@@ -124,4 +124,33 @@ TEST(test_fs, read_nbre_by_name_version) {
   EXPECT_EQ(nbreir_ptr->depends_size(), 1);
 }
 
+TEST(test_fs, read_nbre_depends_diamond) {
+  neb::version v(0, 0, 1);
+  neb::block_height_t height = 789;
+  auto rs = neb::fs::storage_holder::instance().nbre_db_ptr();
+  gen_ir("diamond_a", v, height,
+         {std::make_pair("diamond_b", v), std::make_pair("diamond_c", v)}, rs);
+  gen_ir("diamond_b", v, height, {std::make_pair("diamond_d", v)}, rs);
+  gen_ir("diamond_c", v, height, {std::make_pair("diamond_d", v)}, rs);
+
+  // diamond_d isn't deployed yet
+  auto ret = *nbre_ptr->read_irs("diamond_a", height, true);
+  EXPECT_EQ(ret.size(), 3);
+
+  gen_ir("diamond_d", v, height, {}, rs);
+  for (int i = 0; i < 2; i++) {
+    ret = *nbre_ptr->read_irs("diamond_a", height, true);
+    ASSERT_EQ(ret.size(), 4);
+    EXPECT_EQ(ret[0].name(), "diamond_a");
+    EXPECT_EQ(ret[1].name(), "diamond_b");
+    EXPECT_EQ(ret[2].name(), "diamond_c");
+    EXPECT_EQ(ret[3].name(), "diamond_d");
+  }
+
+  ret = *nbre_ptr->read_irs("diamond_a", height, false);
+  EXPECT_EQ(ret.size(), 1);
+  ret = *nbre_ptr->read_irs("diamond_a", height - 1, true);
+  EXPECT_EQ(ret.size(), 0);
+}
+
 TEST(test_fs, get_auth_table) {}
@@ -19,6 +19,109 @@
 //
 
 #include "jit/cpp_ir.h"
+#include "fs/util.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+#include <fstream>
 #include <gtest/gtest.h>
+#include <map>
 
 TEST(test_cpp_ir, simple) {}
+
+TEST(test_cpp_ir, in_process) {
+  std::string cpp_content = "#include <string>\n"
+                            "int entry_point_test(int a) {\n"
+                            "  return std::to_string(a).size();\n"
+                            "}\n";
+  neb::cpp::cpp_ir ci(std::make_pair("test_in_process", cpp_content), true);
+  neb::bytes ir = ci.llvm_ir_content();
+  ASSERT_FALSE(ir.empty());
+
+  llvm::LLVMContext context;
+  auto buf = llvm::MemoryBuffer::getMemBuffer(
+      llvm::StringRef(reinterpret_cast<const char *>(ir.value()), ir.size()),
+      "", false);
+  auto m = llvm::parseBitcodeFile(buf->getMemBufferRef(), context);
+  ASSERT_TRUE(static_cast<bool>(m));
+  bool found = false;
+  for (auto &f : (*m)->functions()) {
+    found |= f.getName().find("entry_point_test") != llvm::StringRef::npos;
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(test_cpp_ir, in_process_error) {
+  neb::cpp::cpp_ir ci(
+      std::make_pair("test_in_process_error", "int entry_point_test( {"),
+      true);
+  EXPECT_TRUE(ci.llvm_ir_content().empty());
+}
+
+static std::unique_ptr<llvm::Module> parse_ir(llvm::LLVMContext &context,
+                                              const neb::bytes &ir) {
+  auto buf = llvm::MemoryBuffer::getMemBuffer(
+      llvm::StringRef(reinterpret_cast<const char *>(ir.value()), ir.size()),
+      "", false);
+  auto m = llvm::parseBitcodeFile(buf->getMemBufferRef(), context);
+  if (!m) {
+    llvm::consumeError(m.takeError());
+    return nullptr;
+  }
+  return std::move(*m);
+}
+
+static std::map<std::string, std::string>
+defined_functions(const llvm::Module &m) {
+  std::map<std::string, std::string> ret;
+  for (auto &f : m.functions()) {
+    if (f.isDeclaration()) {
+      continue;
+    }
+    std::string body;
+    llvm::raw_string_ostream os(body);
+    f.print(os);
+    ret[f.getName().str()] = os.str();
+  }
+  return ret;
+}
+
+TEST(test_cpp_ir, in_process_same_as_clang) {
+  std::vector<std::string> payloads({"ir/nr/nr_release_v1.cpp",
+                                     "ir/dip/dip_release_v1.cpp",
+                                     "ir/auth_table/auth.cpp"});
+  for (auto &payload : payloads) {
+    std::ifstream ifs(neb::fs::join_path(
+        neb::configuration::instance().nbre_root_dir(), payload));
+    ASSERT_TRUE(ifs.is_open()) << payload;
+    std::string cpp_content((std::istreambuf_iterator<char>(ifs)),
+                            std::istreambuf_iterator<char>());
+
+    neb::cpp::cpp_ir clang_ci(std::make_pair("test_clang", cpp_content),
+                              false);
+    neb::cpp::cpp_ir in_process_ci(
+        std::make_pair("test_in_process", cpp_content), true);
+    neb::bytes clang_ir = clang_ci.llvm_ir_content();
+    neb::bytes in_process_ir = in_process_ci.llvm_ir_content();
+    ASSERT_FALSE(clang_ir.empty()) << payload;
+    ASSERT_FALSE(in_process_ir.empty()) << payload;
+
+    llvm::LLVMContext context;
+    auto clang_m = parse_ir(context, clang_ir);
+    auto in_process_m = parse_ir(context, in_process_ir);
+    ASSERT_TRUE(clang_m && in_process_m) << payload;
+
+    EXPECT_EQ(clang_m->getTargetTriple(), in_process_m->getTargetTriple());
+    EXPECT_EQ(clang_m->getDataLayoutStr(), in_process_m->getDataLayoutStr());
+    EXPECT_EQ(clang_m->global_size(), in_process_m->global_size());
+    auto clang_fs = defined_functions(*clang_m);
+    auto in_process_fs = defined_functions(*in_process_m);
+    EXPECT_EQ(clang_fs.size(), in_process_fs.size()) << payload;
+    for (auto &f : clang_fs) {
+      auto it = in_process_fs.find(f.first);
+      ASSERT_TRUE(it != in_process_fs.end()) << payload << " " << f.first;
+      EXPECT_EQ(f.second, it->second) << payload << " " << f.first;
+    }
+  }
+}
@@ -18,8 +18,85 @@
 // <http://www.gnu.org/licenses/>.
 //
 
+#include "common/configuration.h"
 #include "jit/jit_driver.h"
 #include <gtest/gtest.h>
+#include <thread>
 
 TEST(test_jit_driver, simple) { neb::jit_driver jd; }
 
+
+static std::vector<nbre::NBREIR> make_irs(const std::string &name,
+                                          int32_t ret) {
+  nbre::NBREIR ir;
+  ir.set_name(name);
+  ir.set_version(1);
+  ir.set_ir("define i32 @entry_point_test() {\n  ret i32 " +
+            std::to_string(ret) + "\n}\n");
+  std::vector<nbre::NBREIR> irs;
+  irs.push_back(ir);
+  return irs;
+}
+
+TEST(test_jit_driver, evict_least_recently_used) {
+  auto &conf = neb::configuration::instance();
+  uint64_t budget = conf.jit_cache_size();
+  neb::jit_driver jd;
+
+  auto a = make_irs("a", 1);
+  auto b = make_irs("b", 2);
+  auto c = make_irs("c", 3);
+  EXPECT_EQ(jd.run<int32_t>("a", a, "entry_point_test"), 1);
+  auto s = jd.stats();
+  EXPECT_EQ(s.m_misses, 1u);
+  EXPECT_EQ(s.m_compiles, 1u);
+  EXPECT_GT(s.m_code_size, 0u);
+  uint64_t code_size = s.m_code_size;
+
+  // room for two contexts
+  conf.jit_cache_size() = code_size * 2;
+  EXPECT_EQ(jd.run<int32_t>("b", b, "entry_point_test"), 2);
+  EXPECT_EQ(jd.run<int32_t>("a", a, "entry_point_test"), 1);
+  EXPECT_EQ(jd.run<int32_t>("c", c, "entry_point_test"), 3);
+  s = jd.stats();
+  EXPECT_EQ(s.m_hits, 1u);
+  EXPECT_EQ(s.m_misses, 3u);
+  EXPECT_EQ(s.m_evictions, 1u);
+  EXPECT_EQ(s.m_instances, 2u);
+  EXPECT_LE(s.m_code_size, conf.jit_cache_size());
+
+  // b is the one evicted, a is hit
+  EXPECT_EQ(jd.run<int32_t>("a", a, "entry_point_test"), 1);
+  EXPECT_EQ(jd.stats().m_misses, 3u);
+  EXPECT_EQ(jd.run<int32_t>("b", b, "entry_point_test"), 2);
+  EXPECT_EQ(jd.stats().m_misses, 4u);
+
+  // the newest context stays even if it's beyond the budget alone
+  conf.jit_cache_size() = 1;
+  EXPECT_EQ(jd.run<int32_t>("c", c, "entry_point_test"), 3);
+  s = jd.stats();
+  EXPECT_EQ(s.m_instances, 1u);
+  EXPECT_EQ(s.m_code_size, code_size);
+  conf.jit_cache_size() = budget;
+}
+
+TEST(test_jit_driver, concurrent_misses_compile_once) {
+  neb::jit_driver jd;
+  auto d = make_irs("d", 4);
+
+  std::vector<std::thread> threads;
+  std::atomic<int32_t> sum(0);
+  for (int32_t i = 0; i < 8; i++) {
+    threads.push_back(std::thread([&jd, &d, &sum]() {
+      sum += jd.run<int32_t>("d", d, "entry_point_test");
+    }));
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(sum, 8 * 4);
+  auto s = jd.stats();
+  EXPECT_EQ(s.m_compiles, 1u);
+  EXPECT_EQ(s.m_hits + s.m_misses, 8u);
+  EXPECT_EQ(s.m_instances, 1u);
+}
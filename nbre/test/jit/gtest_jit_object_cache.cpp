@@ -0,0 +1,71 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the // GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "fs/rocksdb_storage.h"
+#include "fs/util.h"
+#include "jit/jit_object_cache.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+static std::unique_ptr<llvm::Module> make_module(llvm::LLVMContext &context,
+                                                 int32_t ret) {
+  auto m = std::make_unique<llvm::Module>("sample", context);
+  auto *ft = llvm::FunctionType::get(llvm::Type::getInt32Ty(context), false);
+  auto *f = llvm::Function::Create(ft, llvm::Function::ExternalLinkage, "func",
+                                   m.get());
+  llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", f));
+  builder.CreateRet(builder.getInt32(ret));
+  return m;
+}
+
+TEST(test_jit_object_cache, store_and_load) {
+  llvm::LLVMContext context;
+  auto m1 = make_module(context, 1);
+  auto m2 = make_module(context, 1);
+  auto m3 = make_module(context, 2);
+  EXPECT_EQ(neb::jit::jit_object_cache::module_key(m1.get()),
+            neb::jit::jit_object_cache::module_key(m2.get()));
+  EXPECT_NE(neb::jit::jit_object_cache::module_key(m1.get()),
+            neb::jit::jit_object_cache::module_key(m3.get()));
+
+  std::string obj("object code");
+  neb::jit::jit_object_cache cache;
+  cache.notifyObjectCompiled(m1.get(), llvm::MemoryBufferRef(obj, "sample"));
+  EXPECT_EQ(cache.getObject(m1.get()), nullptr);
+
+  std::string db_path =
+      neb::fs::join_path(neb::fs::tmp_dir(), "test_jit_object_cache.db");
+  {
+    neb::fs::rocksdb_storage rs;
+    rs.open_database(db_path, neb::fs::storage_open_for_readwrite);
+    cache.set_storage(&rs);
+    EXPECT_EQ(cache.getObject(m1.get()), nullptr);
+    cache.notifyObjectCompiled(m1.get(), llvm::MemoryBufferRef(obj, "sample"));
+
+    auto loaded = cache.getObject(m2.get());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getBuffer().str(), obj);
+    EXPECT_EQ(cache.getObject(m3.get()), nullptr);
+    cache.set_storage(nullptr);
+    rs.close_database();
+  }
+  boost::filesystem::remove_all(db_path);
+}
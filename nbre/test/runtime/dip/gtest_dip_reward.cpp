@@ -71,6 +71,35 @@ TEST(test_runtime_dip_reward, json_seri_deseri) {
   }
 }
 
+TEST(test_runtime_dip_reward, binary_seri_deseri) {
+  neb::rt::dip::dip_ret_type dip_ret;
+  std::get<0>(dip_ret) = 1;
+  std::vector<std::pair<std::string, std::string>> meta;
+  auto &ret = std::get<2>(dip_ret);
+  ret = gen_dip_infos(meta);
+  std::get<1>(dip_ret) = neb::rt::meta_info_to_json(meta);
+  auto bin_ptr = neb::rt::dip::dip_reward::dip_info_to_binary(dip_ret);
+
+  neb::rt::dip::dip_result_view view(*bin_ptr);
+  EXPECT_EQ(view.size(), ret.size());
+  for (size_t i = 0; i < ret.size(); i++) {
+    EXPECT_EQ(view.deployer(i), ret[i]->m_deployer);
+    EXPECT_EQ(view.contract(i), ret[i]->m_contract);
+    EXPECT_EQ(view.reward(i), ret[i]->m_reward);
+  }
+
+  auto dip_ret_v = neb::rt::dip::dip_reward::binary_to_dip_info(*bin_ptr);
+  EXPECT_EQ(std::get<1>(dip_ret_v), std::get<1>(dip_ret));
+  EXPECT_EQ(std::get<2>(dip_ret_v).size(), ret.size());
+
+  EXPECT_EQ(*neb::rt::dip::dip_reward::dip_binary_to_json(*bin_ptr),
+            *neb::rt::dip::dip_reward::dip_info_to_json(dip_ret));
+
+  bin_ptr->push_back(0);
+  EXPECT_THROW(neb::rt::dip::dip_result_view view(*bin_ptr),
+               std::invalid_argument);
+}
+
 TEST(test_runtime_dip_reward, back_to_coinbase) {
   std::vector<std::shared_ptr<neb::rt::dip::dip_info_t>> infos;
   neb::floatxx_t reward_left(0);
@@ -103,7 +132,7 @@ TEST(test_runtime_dip_reward, back_to_coinbase) {
   infos = ret;
   size_t infos_size = infos.size();
   reward_left = dis(mt);
-  coinbase_addr = std::pow(dis(mt), 0.3);
+  coinbase_addr = neb::address_t(size_t(std::pow(dis(mt), 0.3)));
   neb::rt::dip::dip_reward::back_to_coinbase(infos, reward_left, coinbase_addr);
   EXPECT_TRUE(!infos.empty());
   EXPECT_EQ(infos_size + 1, infos.size());
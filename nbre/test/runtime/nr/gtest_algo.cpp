@@ -343,6 +343,41 @@ TEST(test_algo, merge_graphs) {
   }
 }
 
+TEST(test_algo, merge_graphs_in_tree) {
+  auto gen_graphs = []() {
+    std::vector<neb::rt::transaction_graph_ptr_t> v;
+    for (int32_t i = 0; i < 7; i++) {
+      auto ptr = std::make_unique<neb::rt::transaction_graph>();
+      for (int32_t j = 0; j < 5; j++) {
+        auto from = neb::to_address(std::to_string((i + j) % 6));
+        auto to = neb::to_address(std::to_string((i * j + 1) % 6));
+        ptr->add_edge(from, to, i * 10 + j, j);
+      }
+      v.push_back(std::move(ptr));
+    }
+    return v;
+  };
+
+  auto v1 = gen_graphs();
+  auto v2 = gen_graphs();
+  auto ptr1 = neb::rt::graph_algo::merge_graphs(v1);
+  auto ptr2 = neb::rt::graph_algo::merge_graphs_in_tree(v2, false);
+  EXPECT_EQ(ptr1->edge_num(), ptr2->edge_num());
+  EXPECT_EQ(ptr1->vertex_num(), ptr2->vertex_num());
+
+  auto in_out_vals1 =
+      neb::rt::graph_algo::get_in_out_vals(ptr1->internal_graph());
+  auto in_out_vals2 =
+      neb::rt::graph_algo::get_in_out_vals(ptr2->internal_graph());
+  EXPECT_EQ(in_out_vals1->size(), in_out_vals2->size());
+  for (auto &ele : *in_out_vals1) {
+    auto it = in_out_vals2->find(ele.first);
+    EXPECT_TRUE(it != in_out_vals2->end());
+    EXPECT_TRUE(it->second.m_in_val == ele.second.m_in_val);
+    EXPECT_TRUE(it->second.m_out_val == ele.second.m_out_val);
+  }
+}
+
 TEST(test_algo, find_a_cycle_based_on_time_sequence) {
   neb::rt::transaction_graph tg;
   tg.add_edge(neb::to_address("a"), neb::to_address("b"), 1, 5);
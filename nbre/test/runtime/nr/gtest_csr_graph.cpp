@@ -0,0 +1,177 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "common/common.h"
+#include "runtime/nr/graph/algo.h"
+#include "runtime/nr/graph/csr_graph.h"
+#include <gtest/gtest.h>
+#include <random>
+
+typedef std::tuple<std::string, std::string, neb::wei_t, int64_t> edge_tuple_t;
+
+std::vector<edge_tuple_t>
+edges_of(const neb::rt::transaction_graph::internal_graph_t &graph) {
+  std::vector<edge_tuple_t> ret;
+  neb::rt::transaction_graph::viterator_t vi, vi_end;
+  for (boost::tie(vi, vi_end) = boost::vertices(graph); vi != vi_end; vi++) {
+    neb::rt::transaction_graph::oeiterator_t oei, oei_end;
+    for (boost::tie(oei, oei_end) = boost::out_edges(*vi, graph);
+         oei != oei_end; oei++) {
+      auto source = boost::source(*oei, graph);
+      auto target = boost::target(*oei, graph);
+      ret.push_back(std::make_tuple(
+          boost::get(boost::vertex_name_t(), graph, source),
+          boost::get(boost::vertex_name_t(), graph, target),
+          boost::get(boost::edge_weight_t(), graph, *oei),
+          boost::get(boost::edge_timestamp_t(), graph, *oei)));
+    }
+  }
+  return ret;
+}
+
+std::vector<edge_tuple_t> edges_of(const neb::rt::csr_transaction_graph &g) {
+  std::vector<edge_tuple_t> ret;
+  for (size_t v = 0; v < g.vertex_num(); v++) {
+    for (auto e = g.out_begin(v); e != g.out_end(v); e++) {
+      if (g.is_removed(e)) {
+        continue;
+      }
+      ret.push_back(
+          std::make_tuple(std::to_string(g.vertex_address(g.source(e))),
+                          std::to_string(g.vertex_address(g.target(e))),
+                          g.weight(e), g.timestamp(e)));
+    }
+  }
+  return ret;
+}
+
+TEST(test_csr_graph, build) {
+  neb::rt::csr_transaction_graph::builder b;
+  b.add_edge(neb::to_address("a"), neb::to_address("b"), 1, 1);
+  b.add_edge(neb::to_address("b"), neb::to_address("c"), 2, 2);
+  b.add_edge(neb::to_address("a"), neb::to_address("c"), 3, 3);
+  b.add_edge(neb::to_address("c"), neb::to_address("a"), 4, 4);
+  auto g = b.freeze();
+
+  EXPECT_EQ(g->vertex_num(), 3);
+  EXPECT_EQ(g->edge_num(), 4);
+  EXPECT_EQ(g->live_edge_num(), 4);
+
+  neb::rt::csr_transaction_graph::vertex_id_t a, c;
+  EXPECT_TRUE(g->find_vertex(neb::to_address("a"), a));
+  EXPECT_TRUE(g->find_vertex(neb::to_address("c"), c));
+  EXPECT_FALSE(g->find_vertex(neb::to_address("d"), c));
+  EXPECT_EQ(a, 0);
+  EXPECT_EQ(g->out_degree(a), 2);
+  EXPECT_EQ(g->in_degree(a), 1);
+
+  auto e = g->out_begin(a);
+  EXPECT_TRUE(g->weight(e) == 1);
+  EXPECT_TRUE(g->weight(e + 1) == 3);
+  EXPECT_EQ(g->timestamp(e + 1), 3);
+
+  g->remove_edge(e);
+  g->remove_edge(e);
+  EXPECT_TRUE(g->is_removed(e));
+  EXPECT_FALSE(g->is_removed(e + 1));
+  EXPECT_EQ(g->out_degree(a), 1);
+  EXPECT_EQ(g->live_edge_num(), 3);
+}
+
+TEST(test_csr_graph, in_out_vals_and_degrees) {
+  neb::rt::transaction_graph tg;
+  tg.add_edge(neb::to_address("a"), neb::to_address("b"), 1, 1);
+  tg.add_edge(neb::to_address("b"), neb::to_address("c"), 2, 2);
+  tg.add_edge(neb::to_address("b"), neb::to_address("d"), 3, 3);
+  tg.add_edge(neb::to_address("c"), neb::to_address("d"), 4, 4);
+  auto g = neb::rt::csr_transaction_graph::build_from_transaction_graph(tg);
+
+  auto vals = *neb::rt::graph_algo::get_in_out_vals(*g);
+  auto expect_vals = *neb::rt::graph_algo::get_in_out_vals(tg.internal_graph());
+  EXPECT_EQ(vals.size(), expect_vals.size());
+  for (auto &ele : expect_vals) {
+    EXPECT_TRUE(vals[ele.first].m_in_val == ele.second.m_in_val);
+    EXPECT_TRUE(vals[ele.first].m_out_val == ele.second.m_out_val);
+  }
+
+  auto stakes = *neb::rt::graph_algo::get_stakes(*g);
+  EXPECT_TRUE(stakes[neb::to_address("b")] == -4);
+  EXPECT_TRUE(stakes[neb::to_address("d")] == 7);
+
+  auto degrees = *neb::rt::graph_algo::get_in_out_degrees(*g);
+  EXPECT_EQ(degrees[neb::to_address("b")].m_in_degree, 1);
+  EXPECT_EQ(degrees[neb::to_address("b")].m_out_degree, 2);
+  auto degree_sum = *neb::rt::graph_algo::get_degree_sum(*g);
+  EXPECT_EQ(degree_sum[neb::to_address("d")], 2);
+}
+
+TEST(test_csr_graph, merge_edges_with_same_from_and_same_to) {
+  neb::rt::csr_transaction_graph::builder b;
+  b.add_edge(neb::to_address("a"), neb::to_address("b"), 1, 1);
+  b.add_edge(neb::to_address("a"), neb::to_address("c"), 2, 2);
+  b.add_edge(neb::to_address("a"), neb::to_address("b"), 3, 3);
+  b.add_edge(neb::to_address("b"), neb::to_address("a"), 4, 4);
+  b.add_edge(neb::to_address("a"), neb::to_address("b"), 5, 5);
+  auto g = b.freeze();
+
+  neb::rt::graph_algo::merge_edges_with_same_from_and_same_to(*g);
+  EXPECT_EQ(g->live_edge_num(), 3);
+  auto edges = edges_of(*g);
+  for (auto &e : edges) {
+    if (std::get<0>(e) == "a" && std::get<1>(e) == "b") {
+      EXPECT_TRUE(std::get<2>(e) == 9);
+    } else if (std::get<0>(e) == "a" && std::get<1>(e) == "c") {
+      EXPECT_TRUE(std::get<2>(e) == 2);
+    } else {
+      EXPECT_TRUE(std::get<2>(e) == 4);
+    }
+  }
+}
+
+TEST(test_csr_graph, non_recursive_remove_cycles_same_as_boost_graph) {
+  std::mt19937 mt(1024);
+  for (int32_t round = 0; round < 64; round++) {
+    std::uniform_int_distribution<> vdis(0, 2 + round % 10);
+    std::uniform_int_distribution<> wdis(1, 20);
+    std::uniform_int_distribution<> tdis(0, 30);
+
+    neb::rt::transaction_graph tg;
+    int32_t edge_num = 5 + round;
+    for (int32_t i = 0; i < edge_num; i++) {
+      tg.add_edge(neb::to_address(std::to_string(vdis(mt))),
+                  neb::to_address(std::to_string(vdis(mt))), wdis(mt),
+                  tdis(mt));
+    }
+    auto g = neb::rt::csr_transaction_graph::build_from_transaction_graph(tg);
+
+    auto graph = tg.internal_graph();
+    neb::rt::graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+        graph);
+    neb::rt::graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+        *g);
+
+    auto expect_edges = edges_of(graph);
+    auto actual_edges = edges_of(*g);
+    EXPECT_EQ(expect_edges.size(), actual_edges.size());
+    std::sort(expect_edges.begin(), expect_edges.end());
+    std::sort(actual_edges.begin(), actual_edges.end());
+    EXPECT_TRUE(expect_edges == actual_edges) << "round " << round;
+  }
+}
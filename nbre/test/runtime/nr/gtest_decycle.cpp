@@ -21,6 +21,7 @@
 #include "common/common.h"
 #include "runtime/nr/graph/algo.h"
 #include <gtest/gtest.h>
+#include <random>
 
 TEST(test_decycle, non_recursive_remove_cycles_based_on_time_sequence_case1) {
   neb::rt::transaction_graph tg;
@@ -388,3 +389,45 @@ TEST(test_decycle, non_recursive_remove_cycles_based_on_time_sequence_case12) {
       graph);
 }
 
+TEST(test_decycle, fast_remove_cycles_same_as_non_recursive) {
+  auto edges_of = [](const neb::rt::transaction_graph::internal_graph_t &g) {
+    std::vector<std::tuple<std::string, std::string, neb::wei_t, int64_t>> ret;
+    neb::rt::transaction_graph::viterator_t vi, vi_end;
+    for (boost::tie(vi, vi_end) = boost::vertices(g); vi != vi_end; vi++) {
+      neb::rt::transaction_graph::oeiterator_t oei, oei_end;
+      for (boost::tie(oei, oei_end) = boost::out_edges(*vi, g); oei != oei_end;
+           oei++) {
+        ret.push_back(std::make_tuple(
+            boost::get(boost::vertex_name_t(), g, boost::source(*oei, g)),
+            boost::get(boost::vertex_name_t(), g, boost::target(*oei, g)),
+            boost::get(boost::edge_weight_t(), g, *oei),
+            boost::get(boost::edge_timestamp_t(), g, *oei)));
+      }
+    }
+    return ret;
+  };
+
+  std::mt19937 mt(2048);
+  for (int32_t round = 0; round < 128; round++) {
+    std::uniform_int_distribution<> vdis(0, 2 + round % 20);
+    std::uniform_int_distribution<> wdis(1, 20);
+    std::uniform_int_distribution<> tdis(0, 5 + round % 50);
+
+    neb::rt::transaction_graph tg;
+    int32_t edge_num = 5 + round * 2;
+    for (int32_t i = 0; i < edge_num; i++) {
+      tg.add_edge(neb::to_address(std::to_string(vdis(mt))),
+                  neb::to_address(std::to_string(vdis(mt))), wdis(mt),
+                  tdis(mt));
+    }
+
+    auto expect_graph = tg.internal_graph();
+    auto actual_graph = tg.internal_graph();
+    neb::rt::graph_algo::non_recursive_remove_cycles_based_on_time_sequence(
+        expect_graph);
+    neb::rt::graph_algo::fast_remove_cycles_based_on_time_sequence(
+        actual_graph);
+    EXPECT_TRUE(edges_of(expect_graph) == edges_of(actual_graph))
+        << "round " << round;
+  }
+}
@@ -0,0 +1,222 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "common/common.h"
+#include "common/configuration.h"
+#include "common/nebulas_currency.h"
+#include "runtime/nr/impl/incremental_nebulas_rank.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+class fake_blockchain_api : public neb::fs::blockchain_api_base {
+public:
+  fake_blockchain_api() : m_read_blocks(0) {}
+
+  virtual std::unique_ptr<std::vector<neb::fs::transaction_info_t>>
+  get_block_transactions_api(neb::block_height_t height) {
+    m_read_blocks++;
+    auto ret = std::make_unique<std::vector<neb::fs::transaction_info_t>>();
+    std::mt19937 mt(height);
+    std::uniform_int_distribution<> adis(0, 15);
+    std::uniform_int_distribution<> vdis(1, 1000);
+    int32_t tx_num = height % 3 ? height % 4 + 1 : 0;
+    for (int32_t i = 0; i < tx_num; i++) {
+      neb::fs::transaction_info_t info;
+      info.m_height = height;
+      info.m_status = 1;
+      info.m_from = account(adis(mt));
+      info.m_to = account(adis(mt));
+      info.m_tx_type = "binary";
+      info.m_tx_value = vdis(mt);
+      info.m_timestamp = height * 15 + i;
+      info.m_gas_used = 0;
+      info.m_gas_price = 0;
+      ret->push_back(info);
+    }
+    // a cycle of equal weights, which decycling removes all edges of
+    if (m_cycle_heights.find(height) != m_cycle_heights.end()) {
+      for (int32_t i = 0; i < 2; i++) {
+        neb::fs::transaction_info_t info;
+        info.m_height = height;
+        info.m_status = 1;
+        info.m_from = account(20 + i);
+        info.m_to = account(21 - i);
+        info.m_tx_type = "binary";
+        info.m_tx_value = 500;
+        info.m_timestamp = height * 15 + 10 + i;
+        info.m_gas_used = 0;
+        info.m_gas_price = 0;
+        ret->push_back(info);
+      }
+    }
+    return ret;
+  }
+
+  virtual std::unique_ptr<corepb::Account>
+  get_account_api(const neb::address_t &addr, neb::block_height_t height) {
+    auto ret = std::make_unique<corepb::Account>();
+    neb::wei_t balance = 1000000000000000000ULL;
+    balance = balance * (addr[NAS_ADDRESS_LEN - 1] + 1) + height;
+    ret->set_address(neb::address_to_string(addr));
+    ret->set_balance(neb::byte_to_string(neb::wei_to_storage(balance)));
+    return ret;
+  }
+
+  virtual std::unique_ptr<corepb::Transaction>
+  get_transaction_api(const std::string &tx_hash, neb::block_height_t height) {
+    return std::make_unique<corepb::Transaction>();
+  }
+
+  static neb::address_t account(int32_t i) {
+    neb::byte_t buf[NAS_ADDRESS_LEN] = {0};
+    buf[0] = NAS_ADDRESS_MAGIC_NUM;
+    buf[1] = NAS_ADDRESS_ACCOUNT_MAGIC_NUM;
+    buf[NAS_ADDRESS_LEN - 1] = i;
+    return neb::address_t(buf, NAS_ADDRESS_LEN);
+  }
+
+  size_t m_read_blocks;
+  std::set<neb::block_height_t> m_cycle_heights;
+};
+
+std::vector<std::shared_ptr<neb::rt::nr::nr_info_t>>
+nr_from_scratch(fake_blockchain_api *api, const neb::rt::nr::rank_params_t &rp,
+                neb::block_height_t start_block,
+                neb::block_height_t end_block) {
+  neb::rt::nr::transaction_db_ptr_t tdb_ptr =
+      std::make_unique<neb::fs::transaction_db>(api);
+  neb::rt::nr::account_db_ptr_t adb_ptr =
+      std::make_unique<neb::fs::account_db>(api);
+  return neb::rt::nr::nebulas_rank::get_nr_score(tdb_ptr, adb_ptr, rp,
+                                                 start_block, end_block);
+}
+
+std::vector<std::shared_ptr<neb::rt::nr::nr_info_t>>
+nr_incremental(neb::rt::nr::incremental_nebulas_rank &inr,
+               fake_blockchain_api *api, const neb::rt::nr::rank_params_t &rp,
+               neb::block_height_t start_block, neb::block_height_t end_block) {
+  neb::rt::nr::transaction_db_ptr_t tdb_ptr =
+      std::make_unique<neb::fs::transaction_db>(api);
+  neb::rt::nr::account_db_ptr_t adb_ptr =
+      std::make_unique<neb::fs::account_db>(api);
+  return inr.get_nr_score(tdb_ptr, adb_ptr, rp, start_block, end_block);
+}
+
+void expect_same_nr(
+    const std::vector<std::shared_ptr<neb::rt::nr::nr_info_t>> &expect,
+    const std::vector<std::shared_ptr<neb::rt::nr::nr_info_t>> &actual) {
+  EXPECT_EQ(expect.size(), actual.size());
+  for (size_t i = 0; i < expect.size() && i < actual.size(); i++) {
+    EXPECT_EQ(expect[i]->m_address, actual[i]->m_address);
+    EXPECT_TRUE(expect[i]->m_in_outs == actual[i]->m_in_outs);
+    EXPECT_TRUE(expect[i]->m_median == actual[i]->m_median);
+    EXPECT_TRUE(expect[i]->m_weight == actual[i]->m_weight);
+    EXPECT_TRUE(expect[i]->m_nr_score == actual[i]->m_nr_score);
+  }
+}
+
+TEST(test_incremental_nebulas_rank, advance_window) {
+  fake_blockchain_api api;
+  neb::rt::nr::transaction_db_ptr_t tdb_ptr =
+      std::make_unique<neb::fs::transaction_db>(&api);
+  neb::rt::nr::incremental_nebulas_rank inr;
+
+  inr.advance_window(tdb_ptr, 10, 300);
+  EXPECT_EQ(api.m_read_blocks, 290);
+  inr.advance_window(tdb_ptr, 20, 310);
+  EXPECT_EQ(api.m_read_blocks, 300);
+  auto expect_txs = tdb_ptr->read_transactions_from_db_with_duration(20, 310);
+  EXPECT_EQ(inr.m_txs->size(), expect_txs->size());
+
+  api.m_read_blocks = 0;
+  inr.advance_window(tdb_ptr, 30, 200);
+  EXPECT_EQ(api.m_read_blocks, 0);
+  expect_txs = tdb_ptr->read_transactions_from_db_with_duration(30, 200);
+  EXPECT_EQ(inr.m_txs->size(), expect_txs->size());
+  EXPECT_EQ(inr.m_txs->front().m_height, expect_txs->front().m_height);
+  EXPECT_EQ(inr.m_txs->back().m_height, expect_txs->back().m_height);
+
+  api.m_read_blocks = 0;
+  inr.advance_window(tdb_ptr, 500, 600);
+  EXPECT_EQ(api.m_read_blocks, 100);
+}
+
+TEST(test_incremental_nebulas_rank, same_as_get_nr_score) {
+  fake_blockchain_api api;
+  neb::rt::nr::rank_params_t rp{
+      100, 2, 6, -9, neb::floatxx_t(1), neb::floatxx_t(1), neb::floatxx_t(2)};
+  neb::rt::nr::incremental_nebulas_rank inr;
+
+  // every window starts with an account transaction, graphs can be reused
+  neb::block_height_t window = 128 * 6;
+  for (neb::block_height_t s = 1; s < 1 + 128 * 9; s += 128 * 3) {
+    auto expect = nr_from_scratch(&api, rp, s, s + window);
+    auto actual = nr_incremental(inr, &api, rp, s, s + window);
+    expect_same_nr(expect, actual);
+  }
+  EXPECT_EQ(inr.graph_misses(), 6 + 3 + 3);
+  EXPECT_EQ(inr.graph_hits(), 3 + 3);
+  EXPECT_EQ(inr.cached_graph_num(), 6);
+
+  // not aligned to the interval
+  auto expect = nr_from_scratch(&api, rp, 600, 1000);
+  auto actual = nr_incremental(inr, &api, rp, 600, 1000);
+  expect_same_nr(expect, actual);
+
+  // accounts of the first interval are kept even if all their edges are gone
+  inr.clear();
+  api.m_cycle_heights = {2, 2 + 128 * 3, 2 + 128 * 6};
+  for (neb::block_height_t s = 1; s < 1 + 128 * 9; s += 128 * 3) {
+    auto expect = nr_from_scratch(&api, rp, s, s + window);
+    auto actual = nr_incremental(inr, &api, rp, s, s + window);
+    expect_same_nr(expect, actual);
+    auto cycle_account = fake_blockchain_api::account(20);
+    EXPECT_TRUE(std::any_of(
+        actual.begin(), actual.end(),
+        [&cycle_account](const std::shared_ptr<neb::rt::nr::nr_info_t> &info) {
+          return info->m_address == cycle_account;
+        }));
+  }
+
+  inr.clear();
+  EXPECT_EQ(inr.cached_graph_num(), 0);
+  EXPECT_EQ(inr.cached_tx_num(), 0);
+}
+
+TEST(test_incremental_nebulas_rank, drop_caches_on_chain_switch) {
+  fake_blockchain_api api;
+  neb::rt::nr::rank_params_t rp{
+      100, 2, 6, -9, neb::floatxx_t(1), neb::floatxx_t(1), neb::floatxx_t(2)};
+  neb::rt::nr::incremental_nebulas_rank inr;
+
+  neb::block_height_t window = 128 * 6;
+  nr_incremental(inr, &api, rp, 1, 1 + window);
+  EXPECT_EQ(inr.graph_misses(), 6);
+
+  bool use_test_blockchain = neb::use_test_blockchain;
+  neb::use_test_blockchain = !use_test_blockchain;
+  auto expect = nr_from_scratch(&api, rp, 1, 1 + window);
+  auto actual = nr_incremental(inr, &api, rp, 1, 1 + window);
+  expect_same_nr(expect, actual);
+  EXPECT_EQ(inr.graph_misses(), 6 + 6);
+  EXPECT_EQ(inr.graph_hits(), 0);
+  neb::use_test_blockchain = use_test_blockchain;
+}
@@ -20,7 +20,9 @@
 
 #include "common/common.h"
 #include "runtime/nr/impl/nebulas_rank.h"
+#include "runtime/nr/graph/algo.h"
 #include "runtime/util.h"
+#include <ff/functionflow.h>
 #include <gtest/gtest.h>
 #include <random>
 #define PRECESION 1e-5
@@ -269,6 +271,51 @@ TEST(test_runtime_nebulas_rank, build_transaction_graphs) {
   }
 }
 
+TEST(test_runtime_nebulas_rank, build_decycled_transaction_graphs_parallel) {
+  if (!ff::is_initialized()) {
+    ff::initialize(4);
+  }
+
+  std::vector<std::vector<neb::fs::transaction_info_t>> txs_v;
+  for (int32_t i = 0; i < 37; i++) {
+    std::vector<int32_t> addr_set;
+    auto txs_ptr = gen_transactions(addr_set);
+    txs_v.push_back(*txs_ptr);
+  }
+
+  auto serial =
+      neb::rt::nr::nebulas_rank::build_decycled_transaction_graphs(txs_v,
+                                                                   false);
+  auto parallel =
+      neb::rt::nr::nebulas_rank::build_decycled_transaction_graphs(txs_v, true);
+  ASSERT_EQ(serial->size(), txs_v.size());
+  ASSERT_EQ(parallel->size(), txs_v.size());
+
+  auto expect_same_graph = [](neb::rt::transaction_graph *g1,
+                              neb::rt::transaction_graph *g2) {
+    EXPECT_EQ(g1->edge_num(), g2->edge_num());
+    EXPECT_EQ(g1->vertex_num(), g2->vertex_num());
+    auto vals1 = neb::rt::graph_algo::get_in_out_vals(g1->internal_graph());
+    auto vals2 = neb::rt::graph_algo::get_in_out_vals(g2->internal_graph());
+    EXPECT_EQ(vals1->size(), vals2->size());
+    for (auto &ele : *vals1) {
+      auto it = vals2->find(ele.first);
+      ASSERT_TRUE(it != vals2->end());
+      EXPECT_TRUE(it->second.m_in_val == ele.second.m_in_val);
+      EXPECT_TRUE(it->second.m_out_val == ele.second.m_out_val);
+    }
+  };
+  for (size_t i = 0; i < txs_v.size(); i++) {
+    expect_same_graph((*serial)[i].get(), (*parallel)[i].get());
+  }
+
+  auto merged_serial =
+      neb::rt::graph_algo::merge_graphs_in_tree(*serial, false);
+  auto merged_parallel =
+      neb::rt::graph_algo::merge_graphs_in_tree(*parallel, true);
+  expect_same_graph(merged_serial, merged_parallel);
+}
+
 TEST(test_runtime_nebulas_rank, get_max_height_this_block_interval) {
   std::vector<neb::fs::transaction_info_t> txs;
   auto ret = neb::rt::nr::nebulas_rank::get_max_height_this_block_interval(txs);
@@ -359,6 +406,57 @@ TEST(test_runtime_nebulas_rank, f_accout_rank) {
   }
 }
 
+TEST(test_runtime_nebulas_rank, f_account_weights) {
+  std::mt19937 mt(1024);
+  std::uniform_int_distribution<> dis(0, std::numeric_limits<int16_t>::max());
+
+  std::vector<neb::floatxx_t> in_vals;
+  std::vector<neb::floatxx_t> out_vals;
+  for (int32_t i = 0; i < 1000; i++) {
+    in_vals.push_back(dis(mt));
+    out_vals.push_back(dis(mt));
+  }
+  in_vals.push_back(0);
+  out_vals.push_back(dis(mt));
+
+  std::vector<neb::floatxx_t> weights;
+  neb::rt::nr::nebulas_rank::f_account_weights(in_vals, out_vals, weights);
+  ASSERT_EQ(weights.size(), in_vals.size());
+  for (size_t i = 0; i < in_vals.size(); i++) {
+    auto w =
+        neb::rt::nr::nebulas_rank::f_account_weight(in_vals[i], out_vals[i]);
+    EXPECT_EQ(static_cast<float32_t>(weights[i]).v,
+              static_cast<float32_t>(w).v);
+  }
+}
+
+TEST(test_runtime_nebulas_rank, f_account_ranks) {
+  neb::rt::nr::rank_params_t rp{
+      100, 2, 6, -9, neb::floatxx_t(1), neb::floatxx_t(1), neb::floatxx_t(2)};
+
+  std::mt19937 mt(1024);
+  std::uniform_int_distribution<> dis(0, std::numeric_limits<int32_t>::max());
+
+  std::vector<neb::floatxx_t> S;
+  std::vector<neb::floatxx_t> R;
+  for (int32_t i = 0; i < 20; i++) {
+    S.push_back(dis(mt));
+    R.push_back(dis(mt));
+  }
+  S.push_back(0);
+  R.push_back(dis(mt));
+
+  std::vector<neb::floatxx_t> ranks;
+  neb::rt::nr::nebulas_rank::f_account_ranks(rp, S, R, ranks);
+  ASSERT_EQ(ranks.size(), S.size());
+  for (size_t i = 0; i < S.size(); i++) {
+    auto r = neb::rt::nr::nebulas_rank::f_account_rank(
+        rp.m_a, rp.m_b, rp.m_c, rp.m_d, rp.m_theta, rp.m_mu, rp.m_lambda, S[i],
+        R[i]);
+    EXPECT_EQ(static_cast<float32_t>(ranks[i]).v, static_cast<float32_t>(r).v);
+  }
+}
+
 TEST(test_runtime_nebulas_rank, get_account_balance_median) {
   std::unordered_set<neb::address_t> accounts;
   std::vector<std::vector<neb::fs::transaction_info_t>> txs;
@@ -437,7 +535,8 @@ TEST(test_runtime_nebulas_rank, json_seri_deseri) {
   for (int32_t i = 0; i < infos_size; i++) {
     auto info_ptr =
         std::shared_ptr<neb::rt::nr::nr_info_t>(new neb::rt::nr::nr_info_t{
-            uint32_t(std::sqrt(dis(mt))), dis(mt), neb::floatxx_t(dis(mt)),
+            neb::address_t(size_t(std::sqrt(dis(mt))) % NAS_ADDRESS_LEN),
+            dis(mt), neb::floatxx_t(dis(mt)),
             neb::floatxx_t(dis(mt)), neb::floatxx_t(dis(mt))});
     infos.push_back(info_ptr);
   }
@@ -459,3 +558,61 @@ TEST(test_runtime_nebulas_rank, json_seri_deseri) {
   }
 }
 
+TEST(test_runtime_nebulas_rank, binary_seri_deseri) {
+  std::mt19937 mt(1024);
+  std::uniform_int_distribution<> dis(0, std::numeric_limits<int16_t>::max());
+
+  std::vector<std::shared_ptr<neb::rt::nr::nr_info_t>> infos;
+  std::vector<std::pair<std::string, std::string>> meta(
+      {{"start_height", std::to_string(dis(mt))},
+       {"end_height", std::to_string(dis(mt))},
+       {"version", std::to_string(dis(mt))}});
+  for (int32_t i = 0; i < 100; i++) {
+    auto info_ptr =
+        std::shared_ptr<neb::rt::nr::nr_info_t>(new neb::rt::nr::nr_info_t{
+            neb::to_address(std::to_string(dis(mt))), dis(mt),
+            neb::floatxx_t(dis(mt)), neb::floatxx_t(dis(mt) * 0.01),
+            neb::floatxx_t(dis(mt) * 0.001)});
+    infos.push_back(info_ptr);
+  }
+
+  neb::rt::nr::nr_ret_type nr_ret;
+  std::get<0>(nr_ret) = 1;
+  std::get<1>(nr_ret) = neb::rt::meta_info_to_json(meta);
+  std::get<2>(nr_ret) = infos;
+  auto bin_ptr = neb::rt::nr::nebulas_rank::nr_info_to_binary(nr_ret);
+
+  neb::rt::nr::nr_result_view view(*bin_ptr);
+  EXPECT_EQ(view.size(), infos.size());
+  EXPECT_EQ(view.start_height(), std::stoull(meta[0].second));
+  EXPECT_EQ(view.end_height(), std::stoull(meta[1].second));
+  EXPECT_EQ(view.version(), std::stoull(meta[2].second));
+  for (size_t i = 0; i < infos.size(); i++) {
+    EXPECT_EQ(view.address(i), infos[i]->m_address);
+    EXPECT_EQ(view.in_outs(i), infos[i]->m_in_outs);
+    EXPECT_EQ(view.median(i), infos[i]->m_median);
+    EXPECT_EQ(view.weight(i), infos[i]->m_weight);
+    EXPECT_EQ(view.nr_score(i), infos[i]->m_nr_score);
+  }
+  EXPECT_THROW(view.address(infos.size()), std::out_of_range);
+
+  auto ret = neb::rt::nr::nebulas_rank::binary_to_nr_info(*bin_ptr);
+  EXPECT_EQ(std::get<1>(ret), std::get<1>(nr_ret));
+  EXPECT_EQ(std::get<2>(ret).size(), infos.size());
+
+  // same JSON as before, made at the IPC edge
+  EXPECT_EQ(*neb::rt::nr::nebulas_rank::nr_binary_to_json(*bin_ptr),
+            *neb::rt::nr::nebulas_rank::nr_info_to_json(nr_ret));
+
+  std::get<2>(nr_ret).clear();
+  bin_ptr = neb::rt::nr::nebulas_rank::nr_info_to_binary(nr_ret);
+  EXPECT_EQ(*neb::rt::nr::nebulas_rank::nr_binary_to_json(*bin_ptr),
+            *neb::rt::nr::nebulas_rank::nr_info_to_json(nr_ret));
+
+  bin_ptr->pop_back();
+  EXPECT_THROW(neb::rt::nr::nr_result_view view(*bin_ptr),
+               std::invalid_argument);
+  EXPECT_THROW(neb::rt::nr::nr_result_view view(std::string("{}")),
+               std::invalid_argument);
+}
+
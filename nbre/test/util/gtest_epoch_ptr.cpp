@@ -0,0 +1,85 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "util/epoch_ptr.h"
+#include <gtest/gtest.h>
+
+namespace {
+struct versioned {
+  versioned(int32_t v) : m_version(v), m_alive(true) {}
+  ~versioned() { m_alive = false; }
+  int32_t m_version;
+  std::atomic<bool> m_alive;
+};
+} // namespace
+
+TEST(test_epoch_ptr, read_exchange) {
+  neb::util::epoch_ptr<versioned> p(std::make_unique<versioned>(1));
+  EXPECT_EQ(p.read([](versioned *v) { return v->m_version; }), 1);
+
+  auto old = p.exchange(std::make_unique<versioned>(2));
+  EXPECT_EQ(old->m_version, 1);
+  EXPECT_EQ(p.read([](versioned *v) { return v->m_version; }), 2);
+
+  // a nested read doesn't block
+  p.read([&p](versioned *outer) {
+    EXPECT_EQ(p.read([](versioned *v) { return v->m_version; }),
+              outer->m_version);
+  });
+
+  EXPECT_THROW(p.read([](versioned *) -> int32_t {
+    throw std::invalid_argument("read failed");
+  }),
+               std::invalid_argument);
+  // the failed read left, so exchange doesn't wait for it
+  p.exchange(std::make_unique<versioned>(3));
+}
+
+TEST(test_epoch_ptr, concurrent_readers) {
+  neb::util::epoch_ptr<versioned> p(std::make_unique<versioned>(0));
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> bad(0);
+
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < 4; i++) {
+    readers.emplace_back([&]() {
+      int32_t last = 0;
+      while (!stop) {
+        p.read([&](versioned *v) {
+          std::this_thread::yield();
+          if (!v->m_alive || v->m_version < last) {
+            bad++;
+          }
+          last = v->m_version;
+        });
+      }
+    });
+  }
+
+  for (int32_t i = 1; i <= 1000; i++) {
+    auto old = p.exchange(std::make_unique<versioned>(i));
+    EXPECT_EQ(old->m_version, i - 1);
+  }
+  stop = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+  EXPECT_EQ(bad, 0);
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+#include "common/nebulas_currency.h"
+
+#include "util/sharded_lru_cache.h"
+#include <gtest/gtest.h>
+
+TEST(test_sharded_lru_cache, evict_least_recently_used) {
+  neb::util::sharded_lru_cache<int32_t, int32_t, 1> cache(3);
+  cache.set(1, 1);
+  cache.set(2, 2);
+  cache.set(3, 3);
+  int32_t v;
+  EXPECT_TRUE(cache.get(1, v));
+  EXPECT_EQ(v, 1);
+  cache.set(4, 4);
+  EXPECT_FALSE(cache.exists(2));
+  EXPECT_TRUE(cache.exists(1));
+  EXPECT_TRUE(cache.exists(3));
+  EXPECT_TRUE(cache.exists(4));
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_FALSE(cache.get(2, v));
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+
+  cache.set(3, 30);
+  EXPECT_TRUE(cache.get(3, v));
+  EXPECT_EQ(v, 30);
+  cache.set_capacity(1);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.exists(3));
+}
+
+TEST(test_sharded_lru_cache, bounded) {
+  neb::util::sharded_lru_cache<int32_t, int32_t> cache(64);
+  for (int32_t i = 0; i < 1024; i++) {
+    cache.set(i, i);
+  }
+  EXPECT_LE(cache.size(), cache.capacity());
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+}
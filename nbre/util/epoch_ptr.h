@@ -0,0 +1,103 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include "common/common.h"
+#include <atomic>
+#include <functional>
+
+namespace neb {
+namespace util {
+
+//! An owning pointer that readers use without lock, RCU style. A reader
+//! counts itself in a slot picked by its thread, under the parity of the
+//! current epoch, so readers of different threads seldom touch the same cache
+//! line. exchange() publishes a new object, flips the epoch, then waits until
+//! no reader is left under the old parity before it hands back the old
+//! object, so an object is never released while read.
+template <typename T, size_t SlotNum = 64> class epoch_ptr {
+public:
+  epoch_ptr() : m_ptr(nullptr), m_epoch(0) {}
+  explicit epoch_ptr(std::unique_ptr<T> p) : m_ptr(p.release()), m_epoch(0) {}
+  epoch_ptr(const epoch_ptr &) = delete;
+  epoch_ptr &operator=(const epoch_ptr &) = delete;
+  ~epoch_ptr() { delete m_ptr.load(); }
+
+  //! call f with the current object, which lives until f returns
+  template <typename Func> auto read(Func &&f) -> decltype(f(nullptr)) {
+    reader_guard _g(enter());
+    return f(m_ptr.load());
+  }
+
+  //! publish p and return the previous object once no reader holds it
+  std::unique_ptr<T> exchange(std::unique_ptr<T> p) {
+    std::unique_lock<std::mutex> _l(m_writer_mutex);
+    T *old = m_ptr.exchange(p.release());
+    size_t parity = m_epoch.fetch_add(1) & 0x1;
+    for (auto &slot : m_slots) {
+      while (slot.m_readers[parity].load() != 0) {
+        std::this_thread::yield();
+      }
+    }
+    return std::unique_ptr<T>(old);
+  }
+
+private:
+  struct reader_guard {
+    reader_guard(std::atomic<uint64_t> &readers) : m_readers(readers) {}
+    ~reader_guard() { m_readers.fetch_sub(1); }
+    std::atomic<uint64_t> &m_readers;
+  };
+
+  //! count the reader under the current parity, retry if the epoch flipped
+  //! meanwhile, as the writer may have scanned that parity already
+  std::atomic<uint64_t> &enter() {
+    auto &slot = m_slots[slot_index()];
+    while (true) {
+      uint64_t epoch = m_epoch.load();
+      auto &readers = slot.m_readers[epoch & 0x1];
+      readers.fetch_add(1);
+      if (m_epoch.load() == epoch) {
+        return readers;
+      }
+      readers.fetch_sub(1);
+    }
+  }
+
+  static size_t slot_index() {
+    return std::hash<std::thread::id>()(std::this_thread::get_id()) % SlotNum;
+  }
+
+  struct alignas(64) slot_t {
+    slot_t() {
+      m_readers[0] = 0;
+      m_readers[1] = 0;
+    }
+    std::atomic<uint64_t> m_readers[2];
+  };
+
+  std::atomic<T *> m_ptr;
+  std::atomic<uint64_t> m_epoch;
+  std::array<slot_t, SlotNum> m_slots;
+  std::mutex m_writer_mutex;
+};
+} // namespace util
+} // namespace neb
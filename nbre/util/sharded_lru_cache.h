@@ -0,0 +1,147 @@
+// Copyright (C) 2018 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include "common/common.h"
+#include <atomic>
+#include <list>
+#include <mutex>
+
+namespace neb {
+namespace util {
+
+//! A bounded LRU cache, split into shards by key hash so that concurrent
+//! readers seldom wait for the same lock. Each shard holds at most
+//! capacity / ShardNum items, and evicts its least recently used item.
+template <class Key, class Value, size_t ShardNum = 16,
+          class Hash = std::hash<Key>>
+class sharded_lru_cache {
+public:
+  typedef std::mutex lock_t;
+  using guard_t = std::lock_guard<lock_t>;
+
+  sharded_lru_cache(size_t capacity)
+      : m_shard_capacity(0), m_hits(0), m_misses(0) {
+    set_capacity(capacity);
+  }
+
+  void set_capacity(size_t capacity) {
+    size_t shard_capacity = std::max<size_t>(1, capacity / ShardNum);
+    m_shard_capacity = shard_capacity;
+    for (auto &s : m_shards) {
+      guard_t __l(s.m_lock);
+      s.shrink(shard_capacity);
+    }
+  }
+
+  size_t capacity() const { return m_shard_capacity * ShardNum; }
+
+  size_t size() const {
+    size_t ret = 0;
+    for (auto &s : m_shards) {
+      guard_t __l(s.m_lock);
+      ret += s.m_map.size();
+    }
+    return ret;
+  }
+
+  void clear() {
+    for (auto &s : m_shards) {
+      guard_t __l(s.m_lock);
+      s.m_map.clear();
+      s.m_list.clear();
+    }
+  }
+
+  void set(const Key &k, const Value &v) {
+    auto &s = shard(k);
+    guard_t __l(s.m_lock);
+    auto iter = s.m_map.find(k);
+    if (iter != s.m_map.end()) {
+      iter->second->second = v;
+      s.m_list.splice(s.m_list.begin(), s.m_list, iter->second);
+      return;
+    }
+    s.m_list.emplace_front(k, v);
+    s.m_map.insert(std::make_pair(k, s.m_list.begin()));
+    s.shrink(m_shard_capacity);
+  }
+
+  bool get(const Key &k, Value &v) {
+    auto &s = shard(k);
+    guard_t __l(s.m_lock);
+    auto iter = s.m_map.find(k);
+    if (iter == s.m_map.end()) {
+      m_misses++;
+      return false;
+    }
+    s.m_list.splice(s.m_list.begin(), s.m_list, iter->second);
+    v = iter->second->second;
+    m_hits++;
+    return true;
+  }
+
+  bool exists(const Key &k) const {
+    auto &s = shard(k);
+    guard_t __l(s.m_lock);
+    return s.m_map.find(k) != s.m_map.end();
+  }
+
+  void erase(const Key &k) {
+    auto &s = shard(k);
+    guard_t __l(s.m_lock);
+    auto iter = s.m_map.find(k);
+    if (iter == s.m_map.end()) {
+      return;
+    }
+    s.m_list.erase(iter->second);
+    s.m_map.erase(iter);
+  }
+
+  inline uint64_t hits() const { return m_hits; }
+  inline uint64_t misses() const { return m_misses; }
+
+private:
+  typedef std::list<std::pair<Key, Value>> list_t;
+  struct shard_t {
+    void shrink(size_t shard_capacity) {
+      while (m_map.size() > shard_capacity) {
+        m_map.erase(m_list.back().first);
+        m_list.pop_back();
+      }
+    }
+    mutable lock_t m_lock;
+    list_t m_list;
+    std::unordered_map<Key, typename list_t::iterator, Hash> m_map;
+  };
+
+  shard_t &shard(const Key &k) { return m_shards[Hash()(k) % ShardNum]; }
+  const shard_t &shard(const Key &k) const {
+    return m_shards[Hash()(k) % ShardNum];
+  }
+
+  std::array<shard_t, ShardNum> m_shards;
+  std::atomic<size_t> m_shard_capacity;
+  std::atomic<uint64_t> m_hits;
+  std::atomic<uint64_t> m_misses;
+};
+} // namespace util
+} // namespace neb
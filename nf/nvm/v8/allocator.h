@@ -51,6 +51,10 @@ public:
 
   size_t peak_allocated_size();
 
+  // restart peak tracking from the current allocation, used when an engine
+  // is reused for another call.
+  void reset_peak_allocated_size();
+
 private:
   size_t total_allocated_size_;
   size_t peak_allocated_size_;
@@ -20,6 +20,7 @@
 #include "engine.h"
 #include "allocator.h"
 #include "engine_int.h"
+#include "lib/code_cache.h"
 #include "lib/execution_env.h"
 #include "lib/global.h"
 #include "lib/instruction_counter.h"
@@ -32,8 +33,11 @@
 
 
 #include <assert.h>
+#include <condition_variable>
+#include <mutex>
 #include <string.h>
 #include <thread>
+#include <vector>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -110,6 +114,8 @@ void EnableInnerContract(V8Engine *e) {
   e->ver = BUILD_INNER_VER;
 }
 
+void EnableLibCodeCache(int enable) { EnableLibCodeCacheInternal(enable != 0); }
+
 void DeleteEngine(V8Engine *e) {
   Isolate *isolate = static_cast<Isolate *>(e->isolate);
   isolate->Dispose();
@@ -119,6 +125,124 @@ void DeleteEngine(V8Engine *e) {
   free(e);
 }
 
+// engine pool, isolates are kept and reused across calls.
+static std::mutex sEnginePoolMutex;
+static std::condition_variable sEnginePoolCond;
+static std::vector<V8Engine *> sIdleEngines;
+static size_t sEnginePoolCapacity = 0;
+static size_t sEnginePoolCreated = 0;
+
+static void ResetEngine(V8Engine *e) {
+  Isolate *isolate = static_cast<Isolate *>(e->isolate);
+  {
+    Locker locker(isolate);
+    Isolate::Scope isolate_scope(isolate);
+    isolate->CancelTerminateExecution();
+    // release the garbage of last call, so that the heap stats of next call
+    // start from a clean heap.
+    isolate->LowMemoryNotification();
+  }
+  static_cast<ArrayBufferAllocator *>(e->allocator)
+      ->reset_peak_allocated_size();
+
+  e->limits_of_executed_instructions = 0;
+  e->limits_of_total_memory_size = 0;
+  e->is_requested_terminate_execution = false;
+  e->is_unexpected_error_happen = false;
+  e->is_inner_nvm_error_happen = false;
+  e->testing = 0;
+  e->timeout = ExecuteTimeOut;
+  e->ver = BUILD_DEFAULT_VER;
+  memset(&e->stats, 0x00, sizeof(e->stats));
+}
+
+void InitializeEnginePool(int capacity, int prewarm) {
+  std::vector<V8Engine *> engines;
+  {
+    std::unique_lock<std::mutex> l(sEnginePoolMutex);
+    sEnginePoolCapacity = capacity > 0 ? capacity : 1;
+    while (sEnginePoolCreated < sEnginePoolCapacity &&
+           (int)(sEnginePoolCreated + engines.size()) < prewarm) {
+      engines.push_back(NULL);
+    }
+    sEnginePoolCreated += engines.size();
+  }
+  for (auto &e : engines) {
+    e = CreateEngine();
+  }
+  std::unique_lock<std::mutex> l(sEnginePoolMutex);
+  sIdleEngines.insert(sIdleEngines.end(), engines.begin(), engines.end());
+  sEnginePoolCond.notify_all();
+}
+
+V8Engine *AcquireEngine() {
+  {
+    std::unique_lock<std::mutex> l(sEnginePoolMutex);
+    if (sEnginePoolCapacity == 0) {
+      LogErrorf("AcquireEngine: engine pool is not initialized");
+      return NULL;
+    }
+    sEnginePoolCond.wait(l, [] {
+      return sEnginePoolCapacity == 0 || !sIdleEngines.empty() ||
+             sEnginePoolCreated < sEnginePoolCapacity;
+    });
+    if (sEnginePoolCapacity == 0) {
+      // disposed while waiting.
+      return NULL;
+    }
+    if (!sIdleEngines.empty()) {
+      V8Engine *e = sIdleEngines.back();
+      sIdleEngines.pop_back();
+      return e;
+    }
+    sEnginePoolCreated++;
+  }
+  return CreateEngine();
+}
+
+// the caller must hold sEnginePoolMutex.
+static bool IsEnginePoolFull() {
+  // a disposed pool has capacity 0 and is always full.
+  return sIdleEngines.size() >= sEnginePoolCapacity;
+}
+
+void ReleaseEngine(V8Engine *e) {
+  if (e == NULL) {
+    return;
+  }
+  std::unique_lock<std::mutex> l(sEnginePoolMutex);
+  if (!IsEnginePoolFull()) {
+    l.unlock();
+    ResetEngine(e);
+    l.lock();
+    // the pool may have been shrunk or disposed while resetting.
+    if (!IsEnginePoolFull()) {
+      sIdleEngines.push_back(e);
+      sEnginePoolCond.notify_one();
+      return;
+    }
+  }
+  // pool was shrunk or disposed while the engine was in use.
+  sEnginePoolCreated--;
+  sEnginePoolCond.notify_one();
+  l.unlock();
+  DeleteEngine(e);
+}
+
+void DisposeEnginePool() {
+  std::vector<V8Engine *> engines;
+  {
+    std::unique_lock<std::mutex> l(sEnginePoolMutex);
+    engines.swap(sIdleEngines);
+    sEnginePoolCreated -= engines.size();
+    sEnginePoolCapacity = 0;
+    sEnginePoolCond.notify_all();
+  }
+  for (auto e : engines) {
+    DeleteEngine(e);
+  }
+}
+
 int ExecuteSourceDataDelegate(char **result, Isolate *isolate,
                               const char *source, int source_line_offset,
                               Local<Context> context, TryCatch &trycatch,
@@ -218,6 +218,15 @@ EXPORT void TerminateExecution(V8Engine *e);
 
 EXPORT void DeleteEngine(V8Engine *e);
 
+// engine pool, at most capacity engines are alive and prewarm of them are
+// created immediately. AcquireEngine blocks until an engine is available,
+// ReleaseEngine resets the per-call state (limits, stats, terminate flags and
+// garbage of the heap) and returns the engine to the pool.
+EXPORT void InitializeEnginePool(int capacity, int prewarm);
+EXPORT V8Engine *AcquireEngine();
+EXPORT void ReleaseEngine(V8Engine *e);
+EXPORT void DisposeEnginePool();
+
 EXPORT void ExecuteLoop(const char *file);
 
 EXPORT char *InjectTracingInstructionsThread(V8Engine *e, const char *source,
@@ -230,6 +239,12 @@ EXPORT int RunScriptSourceThread(char **result, V8Engine *e, const char *source,
                     uintptr_t gcs_handler);
 EXPORT void EnableInnerContract(V8Engine *e);
 
+// reuse V8 code cache of execution_env.js and lib modules, disabled by
+// default. The heap stats of a call then depend on the cache state, hence
+// the memory limits of a call may give another verdict than a node without
+// the cache.
+EXPORT void EnableLibCodeCache(int enable);
+
 void SetInnerContractErrFlag(V8Engine *e);
 
 bool CreateScriptThread(v8ThreadContext *pc);
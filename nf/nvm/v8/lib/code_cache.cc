@@ -0,0 +1,101 @@
+// Copyright (C) 2017 go-nebulas authors
+//
+// This file is part of the go-nebulas library.
+//
+// the go-nebulas library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// the go-nebulas library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with the go-nebulas library.  If not, see
+// <http://www.gnu.org/licenses/>.
+//
+
+#include "code_cache.h"
+#include "logger.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+typedef struct {
+  std::string source;
+  std::string data;
+} CodeCacheEntry;
+
+// off unless a caller opts in, compiling with or without cache leaves
+// different heap stats, which the memory limits of a call are checked on.
+static bool sEnableCodeCache = false;
+static std::mutex sCodeCacheMutex;
+static std::map<std::string, std::shared_ptr<CodeCacheEntry>> sCodeCache;
+
+void EnableLibCodeCacheInternal(bool enable) {
+  std::lock_guard<std::mutex> lock(sCodeCacheMutex);
+  sEnableCodeCache = enable;
+  if (!enable) {
+    sCodeCache.clear();
+  }
+}
+
+MaybeLocal<Script> CompileLibScript(Isolate *isolate, Local<Context> context,
+                                    const char *key, Local<String> source,
+                                    ScriptOrigin *origin) {
+  std::shared_ptr<CodeCacheEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(sCodeCacheMutex);
+    if (!sEnableCodeCache) {
+      return Script::Compile(context, source, origin);
+    }
+    auto it = sCodeCache.find(key);
+    if (it != sCodeCache.end()) {
+      entry = it->second;
+    }
+  }
+
+  String::Utf8Value src_str(source);
+  std::string src(*src_str, src_str.length());
+
+  if (entry != nullptr && entry->source == src) {
+    // entry is kept alive by this shared_ptr while V8 reads the data.
+    ScriptCompiler::CachedData *cached_data = new ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t *>(entry->data.data()),
+        static_cast<int>(entry->data.size()));
+    ScriptCompiler::Source cached_source(source, *origin, cached_data);
+    MaybeLocal<UnboundScript> unbound = ScriptCompiler::CompileUnboundScript(
+        isolate, &cached_source, ScriptCompiler::kConsumeCodeCache);
+    if (unbound.IsEmpty()) {
+      return MaybeLocal<Script>();
+    }
+    if (!cached_source.GetCachedData()->rejected) {
+      return unbound.ToLocalChecked()->BindToCurrentContext();
+    }
+    LogWarnf("code cache of %s is rejected, recompile.", key);
+  }
+
+  ScriptCompiler::Source produce_source(source, *origin);
+  MaybeLocal<UnboundScript> unbound = ScriptCompiler::CompileUnboundScript(
+      isolate, &produce_source, ScriptCompiler::kProduceCodeCache);
+  if (unbound.IsEmpty()) {
+    return MaybeLocal<Script>();
+  }
+
+  const ScriptCompiler::CachedData *produced = produce_source.GetCachedData();
+  if (produced != NULL && produced->length > 0) {
+    std::shared_ptr<CodeCacheEntry> new_entry(new CodeCacheEntry());
+    new_entry->source = src;
+    new_entry->data.assign(reinterpret_cast<const char *>(produced->data),
+                           produced->length);
+    std::lock_guard<std::mutex> lock(sCodeCacheMutex);
+    if (sEnableCodeCache) {
+      sCodeCache[key] = new_entry;
+    }
+  }
+  return unbound.ToLocalChecked()->BindToCurrentContext();
+}
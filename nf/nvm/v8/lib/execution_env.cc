@@ -19,6 +19,7 @@
 
 #include "execution_env.h"
 #include "../engine.h"
+#include "code_cache.h"
 #include "file.h"
 #include "logger.h"
 #include "global.h"
@@ -56,7 +57,7 @@ int SetupExecutionEnv(Isolate *isolate, Local<Context> &context) {
   ScriptOrigin sourceSrcOrigin(
       String::NewFromUtf8(isolate, "execution_env.js"));
   MaybeLocal<Script> script =
-      Script::Compile(context, source, &sourceSrcOrigin);
+      CompileLibScript(isolate, context, path, source, &sourceSrcOrigin);
 
   if (script.IsEmpty()) {
     return 1;
@@ -18,6 +18,7 @@
 //
 #include "require_callback.h"
 #include "../engine.h"
+#include "code_cache.h"
 #include "file.h"
 #include "global.h"
 #include "logger.h"
@@ -163,11 +164,19 @@ void RequireCallback(const v8::FunctionCallbackInfo<v8::Value> &info) {
     free(abPath);
     return;
   }
-  free(abPath);
 
   ScriptOrigin sourceSrcOrigin(path, Integer::New(isolate, lineOffset));
-  MaybeLocal<Script> script = Script::Compile(
-      context, String::NewFromUtf8(isolate, data), &sourceSrcOrigin);
+  MaybeLocal<Script> script;
+  if (abPath != NULL) {
+    // versioned lib module, the same for every contract.
+    script = CompileLibScript(isolate, context, abPath,
+                              String::NewFromUtf8(isolate, data),
+                              &sourceSrcOrigin);
+  } else {
+    script = Script::Compile(context, String::NewFromUtf8(isolate, data),
+                             &sourceSrcOrigin);
+  }
+  free(abPath);
   if (!script.IsEmpty()) {
     MaybeLocal<Value> ret = script.ToLocalChecked()->Run(context);
     if (!ret.IsEmpty()) {
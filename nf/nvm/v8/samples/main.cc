@@ -26,6 +26,7 @@
 #include "memory_modules.h"
 #include "memory_storage.h"
 
+#include <chrono>
 #include <thread>
 #include <vector>
 
@@ -40,6 +41,8 @@ static int strict_disallow_usage = 0;
 static size_t limits_of_executed_instructions = 0;
 static size_t limits_of_total_memory_size = 0;
 static int print_injection_result = 0;
+static int loops = 1;
+static int pool_size = 0;
 
 void logFunc(int level, const char *msg) {
   std::thread::id tid = std::this_thread::get_id();
@@ -70,6 +73,11 @@ void help(const char *name) {
          "(unlimited).\n");
   printf("\t -im <number> \tlimits of total heap size, default is 0 "
          "(unlimited).\n");
+  printf("\t -n <number> \trun the script n times in each thread and print "
+         "the latency per call.\n");
+  printf("\t -cc \tenable code cache of execution env and lib modules.\n");
+  printf("\t -p <number> \tacquire engines from a pool of the size instead "
+         "of creating one per call.\n");
   printf("\n");
 
   printf("%s -ip <Javascript File>\n", name);
@@ -161,11 +169,26 @@ void InjectTracingInstructionsAndPrintDelegate(V8Engine *e, const char *data,
   free(source);
 }
 
+V8Engine *NewEngine() {
+  if (pool_size > 0) {
+    return AcquireEngine();
+  }
+  return CreateEngine();
+}
+
+void FreeEngine(V8Engine *e) {
+  if (pool_size > 0) {
+    ReleaseEngine(e);
+  } else {
+    DeleteEngine(e);
+  }
+}
+
 void ExecuteScript(const char *filename, V8ExecutionDelegate delegate) {
   void *lcsHandler = CreateStorageHandler();
   void *gcsHandler = CreateStorageHandler();
 
-  V8Engine *e = CreateEngine();
+  V8Engine *e = NewEngine();
 
   size_t size = 0;
   int lineOffset = 0;
@@ -197,6 +220,7 @@ void ExecuteScript(const char *filename, V8ExecutionDelegate delegate) {
     if (traceableSource == NULL) {
       fprintf(stderr, "Inject tracing instructions failed.\n");
       free(source);
+      FreeEngine(e);
       return;
     }
     free(source);
@@ -206,15 +230,30 @@ void ExecuteScript(const char *filename, V8ExecutionDelegate delegate) {
   char id[128];
   sprintf(id, "./%s", filename);
 
-  AddModule(e, id, source, lineOffset);
-
   char data[128];
   sprintf(data, "require(\"%s\");", id);
 
-  delegate(e, data, (uintptr_t)lcsHandler, (uintptr_t)gcsHandler);
+  // one engine per call, as the contract calls of go side.
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loops; i++) {
+    if (e == NULL) {
+      e = NewEngine();
+    }
+    AddModule(e, id, source, lineOffset);
+    delegate(e, data, (uintptr_t)lcsHandler, (uintptr_t)gcsHandler);
+    FreeEngine(e);
+    e = NULL;
+  }
+  auto end = std::chrono::steady_clock::now();
+  if (loops > 1) {
+    double us =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count();
+    fprintf(stdout, "[V8] %d calls, %.3f ms per call\n", loops,
+            us / loops / 1000);
+  }
 
   free(source);
-  DeleteEngine(e);
 
   DeleteStorageHandler(lcsHandler);
   DeleteStorageHandler(gcsHandler);
@@ -254,6 +293,23 @@ int main(int argc, const char *argv[]) {
         fprintf(stderr, "concurrency can't less than 0, set to 1.\n");
         concurrency = 1;
       }
+    } else if (strcmp(arg, "-n") == 0) {
+      argcIdx++;
+      loops = atoi(argv[argcIdx]);
+      argcIdx++;
+      if (loops <= 0) {
+        loops = 1;
+      }
+    } else if (strcmp(arg, "-p") == 0) {
+      argcIdx++;
+      pool_size = atoi(argv[argcIdx]);
+      argcIdx++;
+      if (pool_size < 0) {
+        pool_size = 0;
+      }
+    } else if (strcmp(arg, "-cc") == 0) {
+      argcIdx++;
+      EnableLibCodeCache(1);
     } else if (strcmp(arg, "-i") == 0) {
       argcIdx++;
       enable_tracer_injection = 1;
@@ -304,10 +360,15 @@ int main(int argc, const char *argv[]) {
     }
   }
 
+  if (pool_size > 0) {
+    InitializeEnginePool(pool_size, pool_size);
+  }
+
   if (print_injection_result) {
     // inject and print.
     ExecuteScript(filename, InjectTracingInstructionsAndPrintDelegate);
   } else {
+    auto start = std::chrono::steady_clock::now();
     pthread_attr_t attribute;
     std::vector<pthread_t > threads;
     for (int i = 0; i < concurrency; i++) {
@@ -321,9 +382,22 @@ int main(int argc, const char *argv[]) {
     for (int i = 0; i < concurrency; i++) {
       pthread_join(threads[i], 0);
     }
+    auto end = std::chrono::steady_clock::now();
+    if (concurrency > 1 || loops > 1) {
+      double us =
+          std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+              .count();
+      fprintf(stdout, "[V8] %d threads, %d calls, %.1f calls per second\n",
+              concurrency, concurrency * loops,
+              concurrency * loops * 1000000.0 / us);
+    }
     printf("success\n");
   }
 
+  if (pool_size > 0) {
+    DisposeEnginePool();
+  }
+
   Dispose();
   return 0;
 }